@@ -1,6 +1,8 @@
 #include "CPPCodeProvider.h"
 #include "collections.h"
 #include "declarations.h"
+#include "output.h"
+#include "visitor.h"
 
 namespace CPlusPlusCodeProvider
 {
@@ -9,22 +11,301 @@ namespace CPlusPlusCodeProvider
 	using std::wstring;
 	using std::wostream;
 
+	const TypedCollection< wstring > TypedCollection< wstring >::empty;
+
+	std::atomic< unsigned long long > CollectionRevision::stamps( 0 );
+
+	unsigned long long CollectionRevision::Stamp( )
+	{
+		return ++stamps << 32;
+	}
+
+	namespace
+	{
+		/// <summary>
+		/// Structure being rendered by a thread, along with where the objects written out as part of it and the nodes it refers to by name are recorded.
+		/// </summary>
+		struct Structure
+		{
+			const CodeObject* object;
+			std::vector< const CodeObject* >* nested;
+			std::vector< const CodeObject* >* referred;
+		};
+
+		/// <summary>
+		/// Structure being rendered by this thread, objects written out as part of it contribute their hash instead of their text.
+		/// </summary>
+		__declspec( thread ) Structure* hashing = 0;
+
+		/// <summary>
+		/// Makes an object the one whose structure is being rendered for the lifetime of this object.
+		/// </summary>
+		class HashingScope
+		{
+			Structure current;
+			Structure* previous;
+
+			HashingScope( const HashingScope& );
+			HashingScope& operator = ( const HashingScope& );
+		public:
+			HashingScope( const CodeObject& object , std::vector< const CodeObject* >* nested , std::vector< const CodeObject* >* referred )
+				: previous( hashing )
+			{
+				current.object = &object;
+				current.nested = nested;
+				current.referred = referred;
+				hashing = &current;
+			}
+
+			~HashingScope( )
+			{
+				hashing = previous;
+			}
+		};
+
+		/// <summary>
+		/// 64-bit FNV-1a hash of a kind followed by some text.
+		/// </summary>
+		unsigned long long fingerprint( NodeKind::Kind kind , const wstring& text )
+		{
+			const unsigned long long prime = 1099511628211ULL;
+			unsigned long long value = ( 14695981039346656037ULL ^ kind ) * prime;
+			for( wstring::const_iterator iter = text.begin( ) ; iter != text.end( ) ; ++iter )
+				value = ( value ^ static_cast< unsigned long long >( *iter ) ) * prime;
+			return value;
+		}
+	}
+
 	CodeObject::CodeObject( )
+		: kind( NodeKind::Count ) , interned( false )
+	{
+	}
+
+	CodeObject::CodeObject( const CodeObject& other )
+		: cache( other.cache ) , kind( other.kind ) , interned( false )
 	{
 	}
 
+	CodeObject& CodeObject::operator = ( const CodeObject& other )
+	{
+		cache = other.cache;
+		return *this;
+	}
+
+	void CodeObject::tag( NodeKind::Kind value )
+	{
+		kind = static_cast< unsigned char >( value );
+	}
+
 	CodeObject::~CodeObject( )
 	{
 	}
 
 	void CodeObject::write( wostream& os , unsigned long i ) const
 	{
-		writetext( os , i );
+		cache.Track( );
+		if( hashing && hashing -> object != this )
+		{
+			os << L'\0' << Hash( );
+			if( hashing -> nested )
+				hashing -> nested -> push_back( this );
+		}
+		else if( !cache.Enabled( ) )
+			writetext( os , i );
+		else if( !cache.Lookup( os , i ) )
+		{
+			OutputStream text;
+			{
+				RenderCache::Frame frame( cache );
+				writetext( text , i );
+			}
+			cache.Store( text.str( ) , i );
+			text.WriteTo( os );
+		}
 	}
 
 	void CodeObject::write( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
 	{
-		writetext( declos , defos , decltabs , deftabs );
+		cache.Track( );
+		if( hashing && hashing -> object != this )
+		{
+			declos << L'\0' << Hash( );
+			if( hashing -> nested )
+				hashing -> nested -> push_back( this );
+		}
+		else if( !cache.Enabled( ) || DefinitionScope::Active( ) )
+			writetext( declos , defos , decltabs , deftabs );
+		else if( !cache.Lookup( declos , defos , decltabs , deftabs ) )
+		{
+			OutputStream decltext , deftext;
+			{
+				RenderCache::Frame frame( cache );
+				writetext( decltext , deftext , decltabs , deftabs );
+			}
+			cache.Store( decltext.str( ) , deftext.str( ) , decltabs , deftabs );
+			decltext.WriteTo( declos );
+			deftext.WriteTo( defos );
+		}
+	}
+
+	void CodeObject::write( wostream& declos , wostream& defos , wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		cache.Track( );
+		writetext( declos , defos , fwdos , decltabs , deftabs );
+	}
+
+	void CodeObject::writetext( wostream& declos , wostream& defos , wostream& , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		write( declos , defos , decltabs , deftabs );
+	}
+
+	__declspec( thread ) DefinitionScope* DefinitionScope::current = 0;
+
+	DefinitionScope::DefinitionScope( std::vector< wstring >& pieces )
+		: pieces( pieces ) , previous( current )
+	{
+		current = this;
+	}
+
+	DefinitionScope::~DefinitionScope( )
+	{
+		current = previous;
+	}
+
+	bool DefinitionScope::Collect( const CodeObject& function , unsigned long tabs )
+	{
+		if( !current )
+			return false;
+		OutputStream text;
+		function.write( text , tabs );
+		current -> pieces.push_back( text.str( ) );
+		return true;
+	}
+
+	wstring CodeObject::structure( NodeList* nested , NodeList* referred ) const
+	{
+		HashingScope scope( *this , nested , referred );
+		OutputStream text;
+		writestructure( text );
+		return text.str( );
+	}
+
+	void CodeObject::writestructure( wostream& os ) const
+	{
+		writetext( os , 0 );
+	}
+
+	void CodeObject::refer( const CodeObject& entity )
+	{
+		if( hashing && hashing -> referred )
+			hashing -> referred -> push_back( &entity );
+	}
+
+	unsigned long long CodeObject::Hash( ) const
+	{
+		unsigned long long value;
+		if( cache.LookupHash( value ) )
+			return value;
+		{
+			// Everything read while rendering is tracked, so changing any of it discards the stored hash.
+			RenderCache::Frame frame( cache );
+			value = fingerprint( Kind( ) , structure( 0 , 0 ) );
+		}
+		cache.StoreHash( value );
+		return value;
+	}
+
+	bool CodeObject::Equals( const CodeObject& other ) const
+	{
+		return Equals( other , Counterparts( ) );
+	}
+
+	bool CodeObject::Equals( const CodeObject& other , const Counterparts& counterparts ) const
+	{
+		Counterparts pairs;
+		ReferencePairs references;
+		if( !matches( other , pairs , references ) )
+			return false;
+		for( ReferencePairs::const_iterator iter = references.begin( ) ; iter != references.end( ) ; ++iter )
+		{
+			if( iter -> first == iter -> second )
+				continue;
+			Counterparts::const_iterator match = pairs.find( iter -> first );
+			if( match != pairs.end( ) && match -> second == iter -> second )
+				continue;
+			match = counterparts.find( iter -> first );
+			if( match == counterparts.end( ) || match -> second != iter -> second )
+				return false;
+		}
+		return true;
+	}
+
+	bool CodeObject::matches( const CodeObject& other , Counterparts& pairs , ReferencePairs& references ) const
+	{
+		if( this == &other )
+			return true;
+		if( Kind( ) != other.Kind( ) || Hash( ) != other.Hash( ) )
+			return false;
+		NodeList nested , othernested , referred , otherreferred;
+		if( structure( &nested , &referred ) != other.structure( &othernested , &otherreferred ) )
+			return false;
+		if( nested.size( ) != othernested.size( ) || referred.size( ) != otherreferred.size( ) )
+			return false;
+		pairs[ this ] = &other;
+		for( NodeList::size_type i = 0 ; i < nested.size( ) ; ++i )
+			if( !nested[ i ] -> matches( *othernested[ i ] , pairs , references ) )
+				return false;
+		for( NodeList::size_type i = 0 ; i < referred.size( ) ; ++i )
+			references.push_back( std::make_pair( referred[ i ] , otherreferred[ i ] ) );
+		// Owned nodes written out inline, like parameters, are part of this structure already and only need pairing up.
+		correspond( other , pairs );
+		return true;
+	}
+
+	void CodeObject::correspond( const CodeObject& other , Counterparts& pairs ) const
+	{
+		NodeList children , otherchildren;
+		NodeChildren::Append( *this , children );
+		NodeChildren::Append( other , otherchildren );
+		for( NodeList::size_type i = 0 ; i < children.size( ) && i < otherchildren.size( ) ; ++i )
+			if( pairs.insert( std::make_pair( children[ i ] , otherchildren[ i ] ) ).second )
+				children[ i ] -> correspond( *otherchildren[ i ] , pairs );
+	}
+
+	bool CodeObject::Cached( ) const
+	{
+		return cache.Enabled( );
+	}
+
+	CodeObject& CodeObject::Cached( bool flag )
+	{
+		cache.Enabled( flag );
+		Invalidate( );
+		return *this;
+	}
+
+	void CodeObject::Invalidate( )
+	{
+		cache.Invalidate( );
+	}
+
+	void CodeObject::track( ) const
+	{
+		cache.Track( );
+	}
+
+	bool CodeObject::cachedorder( std::vector< Emission >& order ) const
+	{
+		return cache.LookupOrder( order );
+	}
+
+	void CodeObject::cacheorder( const std::vector< Emission >& order ) const
+	{
+		cache.StoreOrder( order );
+	}
+
+	void CodeObject::remap( const CloneScope& )
+	{
 	}
 
 	Expression::Expression( )
@@ -48,6 +329,7 @@ namespace CPlusPlusCodeProvider
 	Type& Type::Assign( const CodeObject& object )
 	{
 		Assign( cast< Type >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -57,13 +339,13 @@ namespace CPlusPlusCodeProvider
 	}
 
 	Type::Type( const wstring& _Name )
-		: name( _Name ) , comment( Comment::Instantiate( ) )
+		: name( _Name )
 	{
 	}
 
 	Comment& Type::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	const Comment& Type::Comment( ) const
@@ -71,19 +353,28 @@ namespace CPlusPlusCodeProvider
 		return *comment;
 	}
 
-	wstring Type::Name( ) const
+	const wstring& Type::Name( ) const
 	{
 		return name;
 	}
 
+	void Type::writecomment( wostream& os , unsigned long tabs ) const
+	{
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
+			os << L'\n';
+	}
+
 	CodeSnippet::CodeSnippet( const wstring& code )
 		: snippet( code )
 	{
+		tag( NodeKind::CodeSnippet );
 	}
 
 	CodeSnippet& CodeSnippet::Assign( const CodeObject& object )
 	{
 		snippet = cast< CodeSnippet >( object).snippet;
+		Invalidate( );
 		return *this;
 	}
 
@@ -103,29 +394,29 @@ namespace CPlusPlusCodeProvider
 	}
 
 	Callable::Callable( const Callable& other )
-		: specs( other.specs ) , name( other.name ) , argumentlist( new ParameterCollection( *other.argumentlist ) ) , exception_list( new StringCollection( *other.exception_list ) ) , return_type( other.return_type.get( ) ? new copying_pointer< VariableDeclaration >( *other.return_type ) : 0 ) ,  comment( other.comment ) 
+		: specs( other.specs ) , name( other.name ) , argumentlist( other.argumentlist ) , exception_list( other.exception_list ) , return_type( other.return_type.get( ) ? new copying_pointer< VariableDeclaration >( *other.return_type ) : 0 ) ,  comment( other.comment ) 
 	{
 	}
 
 	Callable::Callable( const wstring& name_ , copying_pointer< VariableDeclaration >& type )
-		: name( name_ ) , argumentlist( new ParameterCollection( ) ) , exception_list( new StringCollection( ) ) , specs( ExceptionSpecification::all ) , return_type( new copying_pointer< VariableDeclaration >( type ) ) , comment( Comment::Instantiate( ) )
+		: name( name_ ) , specs( ExceptionSpecification::all ) , return_type( new copying_pointer< VariableDeclaration >( type ) )
 	{
 	}
 
 	Callable::Callable( const wstring& name_ )
-		: name( name_ ) , argumentlist( new ParameterCollection( ) ) , exception_list( new StringCollection( ) ) , specs( ExceptionSpecification::all ) , return_type( 0 ) , comment( Comment::Instantiate( ) )
+		: name( name_ ) , specs( ExceptionSpecification::all ) , return_type( 0 )
 	{
 	}
 
 	Callable& Callable::Assign( const Callable& ref )
 	{
-		argumentlist.reset( new ParameterCollection( *ref.argumentlist ) );
+		argumentlist = ref.argumentlist;
 		if( ref.return_type.get( ) )
-			return_type.reset( new copying_pointer< VariableDeclaration >( &( *ref.return_type ) -> Duplicate( ) ) );
+			return_type.reset( new copying_pointer< VariableDeclaration >( *ref.return_type ) );
 		else
 			return_type.reset( );
 		name = ref.name;
-		exception_list.reset( new StringCollection( *ref.exception_list ) );
+		exception_list = ref.exception_list;
 		specs = ref.specs;
 		return *this;
 	}
@@ -137,7 +428,7 @@ namespace CPlusPlusCodeProvider
 
 	Comment& Callable::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	const Comment& Callable::Comment( ) const
@@ -145,12 +436,17 @@ namespace CPlusPlusCodeProvider
 		return *comment;
 	}
 
-	wstring Callable::Name( ) const
+	const wstring& Callable::Name( ) const
 	{
 		return name;
 	}
 
-	ParameterCollection& Callable::Parameters( ) const
+	ParameterCollection& Callable::Parameters( )
+	{
+		return argumentlist.Acquire( );
+	}
+
+	const ParameterCollection& Callable::Parameters( ) const
 	{
 		return *argumentlist;
 	}
@@ -163,12 +459,20 @@ namespace CPlusPlusCodeProvider
 	Callable& Callable::ExceptionSpecifications( int spec )
 	{
 		specs = spec;
-		if( specs != ExceptionSpecification::some )
-			exception_list -> clear( );
+		if( specs != ExceptionSpecification::some && exception_list.Allocated( ) )
+			exception_list.Acquire( ).clear( );
+		CodeObject* object = dynamic_cast< CodeObject* >( this );
+		if( object )
+			object -> Invalidate( );
 		return *this;
 	}
 
-	StringCollection& Callable::ExceptionList( ) const
+	StringCollection& Callable::ExceptionList( )
+	{
+		return exception_list.Acquire( );
+	}
+
+	const StringCollection& Callable::ExceptionList( ) const
 	{
 		return *exception_list;
 	}
@@ -178,9 +482,16 @@ namespace CPlusPlusCodeProvider
 		return return_type.get( );
 	}
 
+	void Callable::writecomment( wostream& os , unsigned long tabs ) const
+	{
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
+			os << L'\n';
+	}
+
 	void Callable::writeparameters( wostream& os ) const
 	{
-		const ParameterCollection& declarations = Parameters( );
+		const ParameterCollection& declarations = *argumentlist;
 		os << L"( ";
 		if( declarations.size( ) )
 		{
@@ -202,11 +513,11 @@ namespace CPlusPlusCodeProvider
 			os << L" throw( )";
 		else if( ExceptionSpecifications( ) == ExceptionSpecification::some )
 		{
-			if( ExceptionList( ).size( ) > 0 )
+			if( exception_list -> size( ) > 0 )
 			{
-				StringCollection::const_iterator i = ExceptionList( ).begin( );
+				StringCollection::const_iterator i = exception_list -> begin( );
 				os << L" throw( " << *i;
-				for( ++i ; i != ExceptionList( ).end( ) ; ++i )
+				for( ++i ; i != exception_list -> end( ) ; ++i )
 					os << L" , " << *i;
 				os << L" )";
 			}
@@ -8,7 +8,15 @@
 #include <iosfwd>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "utility.h"
+#include "arena.h"
+#include "identifier.h"
+#include "rendercache.h"
+#include "nodekind.h"
+#include "lazycollection.h"
 
 namespace CPlusPlusCodeProvider
 {
@@ -17,12 +25,51 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class CodeObject
 	{
+		RenderCache cache;
+		unsigned char kind;
+		bool interned;
+
+		friend class CloneScope;
+		friend class NodePool;
+		friend class DeclaratorSpecifier;
+		friend class BaseType;
+
+		typedef std::vector< const CodeObject* > NodeList;
+		typedef std::vector< std::pair< const CodeObject* , const CodeObject* > > ReferencePairs;
+
+		std::wstring structure( NodeList* nested , NodeList* referred ) const;
+		bool matches( const CodeObject& other , std::unordered_map< const CodeObject* , const CodeObject* >& pairs , ReferencePairs& references ) const;
+		void correspond( const CodeObject& other , std::unordered_map< const CodeObject* , const CodeObject* >& pairs ) const;
 	public:
+		/// <summary>
+		/// Nodes of one code graph mapped to the nodes standing for them in another.
+		/// </summary>
+		typedef std::unordered_map< const CodeObject* , const CodeObject* > Counterparts;
+
 		/// <summary>
 		/// Destructs a CodeObject.
 		/// </summary>
 		virtual ~CodeObject( ) = 0;
 
+		/// <summary>
+		/// Allocates memory for a code object from the CodeArena current on the calling thread, or from the heap if there is none.
+		/// </summary>
+		/// <parameter name="size">Size of the object being allocated.</parameter>
+		/// <returns>A pointer to memory for the new object.</returns>
+		static void* operator new( std::size_t size )
+		{
+			return CodeArena::Allocate( size );
+		}
+
+		/// <summary>
+		/// Frees memory of a code object allocated by operator new.
+		/// </summary>
+		/// <parameter name="p">Pointer to the memory being freed.</parameter>
+		static void operator delete( void* p )
+		{
+			CodeArena::Deallocate( p );
+		}
+
 		/// <summary>
 		/// This function returns an exact copy of calling object.
 		/// </summary>
@@ -36,6 +83,27 @@ namespace CPlusPlusCodeProvider
 		/// <returns>Invoking object with contents replaced by those of parameter.</returns>
 		virtual CodeObject& Assign( const CodeObject& object ) = 0;
 
+		/// <summary>
+		/// Returns the tag which identifies the concrete type of this object.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Kind of this object.</returns>
+		NodeKind::Kind Kind( ) const
+		{
+			return static_cast< NodeKind::Kind >( kind );
+		}
+
+		/// <summary>
+		/// Tells whether this object is owned by a NodePool and shared by every copying_pointer which holds it.
+		/// Interned objects must not be modified, copying_pointer copies them before giving out non-constant access.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if this object is interned, otherwise, false.</returns>
+		bool Interned( ) const
+		{
+			return interned;
+		}
+
 		/// <summary>
 		/// Writes out this object to the given stream.
 		/// </summary>
@@ -52,11 +120,129 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Number of tabs to output at the start of each line</parameter>
 		/// <IsConstMember value="true"/>
 		void write( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
+
+		/// <summary>
+		/// Writes out this object split across the two streams, along with forward declarations of the classes, unions and enumerations it defines at namespace scope to a third stream.
+		/// The third stream makes up a forward declaration header which can be included instead of the declaration header where the types are only referred to.
+		/// </summary>
+		/// <parameter name="declas">Declaration output stream.</parameter>
+		/// <parameter name="defos">Definition output stream.</parameter>
+		/// <parameter name="fwdos">Forward declaration output stream.</parameter>
+		/// <parameter name="tabs">Number of tabs to output at the start of each line</parameter>
+		/// <IsConstMember value="true"/>
+		void write( std::wostream& declos , std::wostream& defos , std::wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const;
+
+		/// <summary>
+		/// Returns whether renderings of this object are remembered, so writing it out again unchanged only copies text.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if renderings are remembered, otherwise, false.</returns>
+		bool Cached( ) const;
+
+		/// <summary>
+		/// Turns remembering of renderings of this object on or off.
+		/// Remembered renderings are discarded whenever this object, or anything written out as part of it, is changed through its setters or collections.
+		/// </summary>
+		/// <parameter name="flag">True to remember renderings.</parameter>
+		/// <returns>A reference to this object.</returns>
+		CodeObject& Cached( bool flag );
+
+		/// <summary>
+		/// Returns a hash of the structure of this object, which covers its kind, names, specifiers and the hashes of the objects written out as part of it, in order.
+		/// The hash is computed on first use and kept until this object or anything written out as part of it is changed, so recomputing it after a change only visits the changed path.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Structural hash of this object.</returns>
+		unsigned long long Hash( ) const;
+
+		/// <summary>
+		/// Tells whether the given object is structurally equal to this one.
+		/// Objects whose hashes differ are unequal without further work, otherwise their own text is compared, the objects written out as part of them are compared the same way in order, and nodes they refer to by name must be the same node or ones inside the compared objects standing in the same place.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Object to compare with.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if both objects have the same structure, otherwise, false.</returns>
+		bool Equals( const CodeObject& other ) const;
+
+		/// <summary>
+		/// Tells whether the given object is structurally equal to this one, where the other object belongs to a different code graph.
+		/// Nodes referred to by name outside the compared objects also match if they are counterparts of each other.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Object to compare with.</parameter>
+		/// <parameter name="counterparts" IsConst="true">Nodes of this object's graph mapped to the nodes standing for them in the other's.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if both objects have the same structure, otherwise, false.</returns>
+		bool Equals( const CodeObject& other , const Counterparts& counterparts ) const;
+
+		/// <summary>
+		/// Discards remembered renderings of this object and of every object it was written out as part of.
+		/// Setters call this, it only has to be called after changing this object in some other way.
+		/// </summary>
+		void Invalidate( );
 	protected:
 		/// <summary>
-		/// Default constructor for CodeObject, does nothing.
+		/// Default constructor for CodeObject, the object is left untagged until the constructor of its concrete type runs.
 		/// </summary>
 		CodeObject( );
+
+		/// <summary>
+		/// Copy constructor for CodeObject, the copy has the kind of the original but is never interned.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Object to copy.</parameter>
+		CodeObject( const CodeObject& other );
+
+		/// <summary>
+		/// Assigns another object to this one, this object keeps its own kind.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Object which is assigned to this one.</parameter>
+		/// <returns>A reference to this object.</returns>
+		CodeObject& operator = ( const CodeObject& other );
+
+		/// <summary>
+		/// Records the concrete type of this object, every constructor of a concrete type calls this.
+		/// </summary>
+		/// <parameter name="value">Kind of the type being constructed.</parameter>
+		void tag( NodeKind::Kind value );
+
+		/// <summary>
+		/// Records that this object is part of the rendering being remembered, for writers which do not go through write.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		void track( ) const;
+
+		/// <summary>
+		/// Reads the order in which this object writes out its declarations, if one was stored since this object or anything written out as part of it last changed.
+		/// </summary>
+		/// <parameter name="order">Receives the order.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if an order was stored, otherwise, false.</returns>
+		bool cachedorder( std::vector< Emission >& order ) const;
+
+		/// <summary>
+		/// Stores the order in which this object writes out its declarations, it is only kept if this object is being rendered into its cache or hashed.
+		/// </summary>
+		/// <parameter name="order" IsConst="true">Order of the declarations of this object.</parameter>
+		/// <IsConstMember value="true"/>
+		void cacheorder( const std::vector< Emission >& order ) const;
+
+		/// <summary>
+		/// Records that the structure being written out refers to the given node by name, so Equals can tell which node it is, writers call this wherever they write out only the name of a node they do not own.
+		/// </summary>
+		/// <parameter name="entity" IsConst="true">Node referred to.</parameter>
+		static void refer( const CodeObject& entity );
+		/// <summary>
+		/// Redirects references this object holds to other nodes, to the copies made of them by a clone which copied this object.
+		/// Default implementation does nothing.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		virtual void remap( const CloneScope& scope );
+		/// <summary>
+		/// Writes out what Hash and Equals compare this object by, objects written out as part of it contribute their hash.
+		/// Default implementation renders this object.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the structure.</parameter>
+		/// <IsConstMember value="true"/>
+		virtual void writestructure( std::wostream& os ) const;
 		/// <summary>
 		/// Writes out this object to the given stream.
 		/// </summary>
@@ -73,6 +259,62 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Number of tabs to output at the start of each line</parameter>
 		/// <IsConstMember value="true"/>
 		virtual void writetext( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const = 0;
+
+		/// <summary>
+		/// Writes out this object split across the two streams along with its forward declarations.
+		/// Default implementation writes nothing to the forward declaration stream.
+		/// </summary>
+		/// <parameter name="declas">Declaration output stream.</parameter>
+		/// <parameter name="defos">Definition output stream.</parameter>
+		/// <parameter name="fwdos">Forward declaration output stream.</parameter>
+		/// <parameter name="tabs">Number of tabs to output at the start of each line</parameter>
+		/// <IsConstMember value="true"/>
+		virtual void writetext( std::wostream& declos , std::wostream& defos , std::wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const;
+	};
+
+	/// <summary>
+	/// While a DefinitionScope is alive on a thread, each function definition bound for a definition stream is collected as a piece of its own instead.
+	/// Renderings remembered for the objects enclosing those functions are neither used nor stored meanwhile, as they hold the definitions run together.
+	/// </summary>
+	class DefinitionScope
+	{
+		std::vector< std::wstring >& pieces;
+		DefinitionScope* previous;
+
+		/// <summary>
+		/// Collection in progress on this thread, null if there is none.
+		/// </summary>
+		static __declspec( thread ) DefinitionScope* current;
+
+		DefinitionScope( const DefinitionScope& );
+		DefinitionScope& operator = ( const DefinitionScope& );
+	public:
+		/// <summary>
+		/// Starts collecting definitions on the calling thread.
+		/// </summary>
+		/// <parameter name="pieces">Collection which receives the definitions, one per function, in the order they are written out.</parameter>
+		DefinitionScope( std::vector< std::wstring >& pieces );
+		/// <summary>
+		/// Restores the collection which was in progress before this object was constructed, if any.
+		/// </summary>
+		~DefinitionScope( );
+
+		/// <summary>
+		/// Tells whether definitions are being collected on the calling thread.
+		/// </summary>
+		/// <returns>True if definitions are being collected, otherwise, false.</returns>
+		static bool Active( )
+		{
+			return current != 0;
+		}
+
+		/// <summary>
+		/// Collects the definition of the given function if definitions are being collected on the calling thread.
+		/// </summary>
+		/// <parameter name="function" IsConst="true">Function whose definition is written out.</parameter>
+		/// <parameter name="tabs">Number of tabs to output at the start of each line.</parameter>
+		/// <returns>True if the definition was collected, false if it should be written out to the definition stream.</returns>
+		static bool Collect( const CodeObject& function , unsigned long tabs );
 	};
 
 	/// <summary>
@@ -80,10 +322,11 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Comment : public CodeObject
 	{
-		mutable std::wstring text;
+		friend class Snapshot;
+		std::wstring text;
 		const CodeObject* object;
-		mutable bool multiline;
-		mutable bool object_source;
+		bool multiline;
+		bool object_source;
 	public:
 		/// <summary>
 		/// Creates a new Comment given its contents.
@@ -143,6 +386,11 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		/// <returns>True if this comment is empty.</returns>
 		bool IsEmpty( ) const;
+
+		/// <summary>
+		/// Provides a single empty Comment which is shared by all constructs that have not been given a comment.
+		/// </summary>
+		static const Comment empty;
 	protected:
 		/// <summary>
 		/// This constructor constructs a Comment object given its contents.
@@ -174,13 +422,130 @@ namespace CPlusPlusCodeProvider
 		void writetext( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
 	};
 
+	/// <summary>
+	/// Owns the Comment of a construct, which is allocated only when it is first written to, until then it reads as Comment::empty.
+	/// Renderings made while there is no Comment depend on this object, so that allocating it later discards them.
+	/// </summary>
+	class LazyComment
+	{
+		friend class Snapshot;
+		copying_pointer< Comment > comment;
+		RenderCache cache;
+	public:
+		/// <summary>
+		/// Constructs a LazyComment without allocating anything.
+		/// </summary>
+		LazyComment( )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a copy of another LazyComment, nothing is allocated if the other one is empty.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other LazyComment to copy.</parameter>
+		LazyComment( const LazyComment& other )
+			: comment( other.IsEmpty( ) ? copying_pointer< Comment >( ) : other.comment )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a LazyComment by taking over the Comment of another one.
+		/// </summary>
+		/// <parameter name="other">Other LazyComment whose Comment is taken over, it is left without one.</parameter>
+		LazyComment( LazyComment&& other ) throw( )
+			: comment( std::move( other.comment ) )
+		{
+		}
+
+		/// <summary>
+		/// Replaces the Comment of this object with a copy of another one's, nothing is allocated if the other one is empty.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other LazyComment to copy.</parameter>
+		/// <returns>A reference to this object.</returns>
+		LazyComment& operator = ( const LazyComment& other )
+		{
+			if( this != &other )
+				*this = LazyComment( other );
+			return *this;
+		}
+
+		/// <summary>
+		/// Replaces the Comment of this object by taking over the Comment of another one.
+		/// </summary>
+		/// <parameter name="other">Other LazyComment whose Comment is taken over, it is left without one.</parameter>
+		/// <returns>A reference to this object.</returns>
+		LazyComment& operator = ( LazyComment&& other ) throw( )
+		{
+			if( this != &other )
+			{
+				if( comment.pointer( ) )
+					comment -> Invalidate( );
+				comment = std::move( other.comment );
+				cache.Invalidate( );
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// Gives read access to the Comment without allocating it.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>The owned Comment, or Comment::empty if nothing has been allocated yet.</returns>
+		const Comment& operator * ( ) const
+		{
+			if( comment.pointer( ) )
+				return *comment;
+			cache.Track( );
+			return Comment::empty;
+		}
+
+		/// <summary>
+		/// Gives write access to the Comment, allocating it on first use.
+		/// </summary>
+		/// <returns>The owned Comment.</returns>
+		Comment& Acquire( )
+		{
+			if( !comment.pointer( ) )
+			{
+				comment = Comment::Instantiate( );
+				cache.Invalidate( );
+			}
+			return *comment;
+		}
+
+		/// <summary>
+		/// Tells whether there is no Comment or it has no content.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if the Comment is empty.</returns>
+		bool IsEmpty( ) const
+		{
+			return ( **this ).IsEmpty( );
+		}
+
+		/// <summary>
+		/// Writes out the Comment, nothing is written if it has not been allocated.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for the Comment.</parameter>
+		/// <IsConstMember value="true"/>
+		void write( std::wostream& os , unsigned long tabs ) const
+		{
+			if( comment.pointer( ) )
+				comment -> write( os , tabs );
+			else
+				cache.Track( );
+		}
+	};
+
 	/// <summary>
 	/// Base class for all types, provides common services like naming to all types.
 	/// </summary>
 	class Type : public CodeObject
 	{
-		std::wstring name;
-		copying_pointer< Comment > comment;
+		friend class Snapshot;
+		Identifier name;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this Type.
@@ -206,8 +571,8 @@ namespace CPlusPlusCodeProvider
 		/// This function allows you to access the name of this type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
-		/// <returns>Returns the name of this type.</returns>
-		virtual std::wstring Name( ) const;
+		/// <returns>Returns the name of this type, which stays valid for the lifetime of the process.</returns>
+		virtual const std::wstring& Name( ) const;
 	protected:
 		/// <summary>
 		/// Constructs a new object given its typename.
@@ -221,6 +586,14 @@ namespace CPlusPlusCodeProvider
 		/// <parameter IsConst="true" name="other">Another type whose name is copied to this one.</parameter>
 		/// <parameter>This parameter is not used.It is just there to help resolve this function.</parameter>
 		void Assign( const Type& other , bool );
+
+		/// <summary>
+		/// Writes out the comment applied to this Type followed by a line break, nothing is written if there is no comment.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for the comment.</parameter>
+		/// <IsConstMember value="true"/>
+		void writecomment( std::wostream& os , unsigned long tabs ) const;
 	};
 
 	/// <summary>
@@ -272,6 +645,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class CodeSnippet : public CodeObject
 	{
+		friend class Snapshot;
 		std::wstring snippet;
 	public:
 		/// <summary>
@@ -327,11 +701,16 @@ namespace CPlusPlusCodeProvider
 
 	class Callable
 	{
-		std::wstring name;
-		std::auto_ptr< StringCollection > exception_list;
-		std::auto_ptr< ParameterCollection > argumentlist;
+		friend class NodeChildren;
+		friend class Snapshot;
+		friend class SymbolTable;
+		friend class DependencyGraph;
+
+		Identifier name;
+		LazyCollection< StringCollection > exception_list;
+		LazyCollection< ParameterCollection > argumentlist;
 		std::auto_ptr< copying_pointer< VariableDeclaration > > return_type;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 		int specs;
 	public:
 		/// <summary>
@@ -359,19 +738,30 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A reference to comments.</returns>
 		CPlusPlusCodeProvider::Comment& Comment( );
 
-		virtual std::wstring Name( ) const;
+		/// <summary>
+		/// This function allows you to access the name of this function.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Returns the name of this function, which stays valid for the lifetime of the process.</returns>
+		virtual const std::wstring& Name( ) const;
+		/// <summary>
+		/// Provides access to all the arguments for this function call.
+		/// </summary>
+		/// <returns>An ExpressionCollection containing all the arguments.</returns>
+		virtual ParameterCollection& Parameters( );
 		/// <summary>
 		/// Provides access to all the arguments for this function call.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>An ExpressionCollection containing all the arguments.</returns>
-		virtual ParameterCollection& Parameters( ) const;
+		virtual const ParameterCollection& Parameters( ) const;
 
 		int ExceptionSpecifications( ) const;
 		Callable& ExceptionSpecifications( int );
 
+		StringCollection& ExceptionList( );
 		/// <IsConstMember value="true"/>
-		StringCollection& ExceptionList( ) const;
+		const StringCollection& ExceptionList( ) const;
 
 		/// <IsConstMember value="true"/>
 		virtual copying_pointer< VariableDeclaration >* ReturnType( ) const;
@@ -384,6 +774,14 @@ namespace CPlusPlusCodeProvider
 		void writeparameters( std::wostream& ) const;
 		/// <IsConstMember value="true"/>
 		void writeexceptionspecs( std::wostream& ) const;
+
+		/// <summary>
+		/// Writes out the comment applied to this function followed by a line break, nothing is written if there is no comment.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for the comment.</parameter>
+		/// <IsConstMember value="true"/>
+		void writecomment( std::wostream& os , unsigned long tabs ) const;
 	};
 
 	/// <summary>
@@ -0,0 +1,162 @@
+#include <new>
+#include <map>
+#include <utility>
+#include "arena.h"
+
+namespace CPlusPlusCodeProvider
+{
+	namespace
+	{
+		/// <summary>
+		/// Arena which receives node allocations made by this thread, null means the heap.
+		/// </summary>
+		__declspec( thread ) CodeArena* current = 0;
+
+		/// <summary>
+		/// Chunks of the arenas created on a thread keyed by their first byte, each mapped to its end and the arena which owns it.
+		/// </summary>
+		typedef std::map< const char* , std::pair< const char* , CodeArena* > > ChunkMap;
+
+		/// <summary>
+		/// Chunks of the live arenas created on this thread, null when there are none so that heap memory is freed without a lookup.
+		/// </summary>
+		__declspec( thread ) ChunkMap* owned = 0;
+
+		/// <summary>
+		/// Blocks are rounded up to the size of this union so that they are suitably aligned for any code-graph node.
+		/// </summary>
+		union Alignment
+		{
+			void* pointer;
+			long double number;
+		};
+
+		std::size_t aligned( std::size_t size )
+		{
+			return ( size + sizeof( Alignment ) - 1 ) / sizeof( Alignment ) * sizeof( Alignment );
+		}
+	}
+
+	struct CodeArena::Chunk
+	{
+		Chunk* next;
+		std::size_t size;
+		std::size_t used;
+	};
+
+	CodeArena::CodeArena( std::size_t size )
+		: chunks( 0 ) , chunksize( size ) , reserved( 0 ) , references( 1 )
+	{
+	}
+
+	CodeArena::~CodeArena( )
+	{
+		while( chunks )
+		{
+			Chunk* next = chunks -> next;
+			owned -> erase( reinterpret_cast< const char* >( chunks ) );
+			::operator delete( chunks );
+			chunks = next;
+		}
+		if( owned && owned -> empty( ) )
+		{
+			delete owned;
+			owned = 0;
+		}
+	}
+
+	CodeArena& CodeArena::Instantiate( std::size_t size )
+	{
+		return *new CodeArena( size );
+	}
+
+	CodeArena& CodeArena::AddReference( )
+	{
+		++references;
+		return *this;
+	}
+
+	void CodeArena::Release( )
+	{
+		if( --references == 0 )
+			delete this;
+	}
+
+	std::size_t CodeArena::Reserved( ) const
+	{
+		return reserved;
+	}
+
+	void* CodeArena::allocate( std::size_t size )
+	{
+		const std::size_t offset = aligned( sizeof( Chunk ) );
+		size = aligned( size );
+		if( !chunks || chunks -> size - chunks -> used < size )
+		{
+			std::size_t total = offset + ( size > chunksize ? size : chunksize );
+			if( !owned )
+				owned = new ChunkMap;
+			Chunk* chunk = static_cast< Chunk* >( ::operator new( total ) );
+			const char* first = reinterpret_cast< const char* >( chunk );
+			try
+			{
+				owned -> insert( std::make_pair( first , std::make_pair( first + total , this ) ) );
+			}
+			catch( ... )
+			{
+				::operator delete( chunk );
+				throw;
+			}
+			chunk -> next = chunks;
+			chunk -> size = total;
+			chunk -> used = offset;
+			chunks = chunk;
+			reserved += total;
+		}
+		void* p = reinterpret_cast< char* >( chunks ) + chunks -> used;
+		chunks -> used += size;
+		return p;
+	}
+
+	CodeArena* CodeArena::owner( const void* p )
+	{
+		if( !owned )
+			return 0;
+		const char* address = static_cast< const char* >( p );
+		ChunkMap::const_iterator found = owned -> upper_bound( address );
+		if( found == owned -> begin( ) )
+			return 0;
+		--found;
+		return address < found -> second.first ? found -> second.second : 0;
+	}
+
+	void* CodeArena::Allocate( std::size_t size )
+	{
+		if( !current )
+			return ::operator new( size );
+		void* p = current -> allocate( size );
+		++current -> references;
+		return p;
+	}
+
+	void CodeArena::Deallocate( void* p )
+	{
+		if( !p )
+			return;
+		if( CodeArena* arena = owner( p ) )
+			arena -> Release( );
+		else
+			::operator delete( p );
+	}
+
+	CodeArena::Scope::Scope( CodeArena& arena )
+		: previous( current )
+	{
+		current = &arena;
+	}
+
+	CodeArena::Scope::~Scope( )
+	{
+		current = previous;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+#include <cstddef>
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// A monotonic allocator which hands out memory for code-graph nodes and their collections from a few large chunks.
+	/// Individual deallocations are free, the chunks are returned in one shot once the owner and every node allocated in it have let go of the arena.
+	/// Blocks carry no header, memory is told apart from the heap's by looking it up among the chunks of the arenas created on the freeing thread.
+	/// </summary>
+	/// <remarks>Neither allocation nor reference counting is synchronized. An arena, and every node and collection allocated in it, must only be used on the thread which created the arena. Nodes allocated from the heap may still be freed on any thread.</remarks>
+	class CodeArena
+	{
+		struct Chunk;
+
+		Chunk* chunks;
+		std::size_t chunksize;
+		std::size_t reserved;
+		long references;
+
+		/// <summary>
+		/// Constructs an empty arena which grows in chunks of given size.
+		/// </summary>
+		/// <parameter name="size">Size of each chunk in bytes.</parameter>
+		explicit CodeArena( std::size_t size );
+		/// <summary>
+		/// Returns all the chunks owned by this arena.
+		/// </summary>
+		~CodeArena( );
+
+		CodeArena( const CodeArena& );
+		CodeArena& operator = ( const CodeArena& );
+
+		/// <summary>
+		/// Carves a block of given size out of this arena.
+		/// </summary>
+		/// <parameter name="size">Number of bytes required.</parameter>
+		/// <returns>A pointer to at least size bytes suitably aligned for any code-graph node.</returns>
+		void* allocate( std::size_t size );
+
+		/// <summary>
+		/// Finds the arena created on the calling thread whose chunks hold the given memory.
+		/// </summary>
+		/// <parameter name="p">Pointer previously returned by Allocate.</parameter>
+		/// <returns>The arena the memory belongs to, or null if it came from the heap.</returns>
+		static CodeArena* owner( const void* p );
+	public:
+		/// <summary>
+		/// Default size of each chunk allocated by an arena.
+		/// </summary>
+		static const std::size_t DefaultChunkSize = 64 * 1024;
+
+		/// <summary>
+		/// Creates a new arena, the caller holds the only reference to it and must call Release when done.
+		/// </summary>
+		/// <parameter name="size">Size of each chunk in bytes.</parameter>
+		/// <returns>A reference to the new arena.</returns>
+		static CodeArena& Instantiate( std::size_t size = DefaultChunkSize );
+
+		/// <summary>
+		/// Adds a reference to this arena.
+		/// </summary>
+		/// <returns>This object.</returns>
+		CodeArena& AddReference( );
+
+		/// <summary>
+		/// Gives up a reference to this arena, returning its memory if that was the last one.
+		/// </summary>
+		void Release( );
+
+		/// <summary>
+		/// Returns the number of bytes reserved by this arena from the heap.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Sum of sizes of all chunks owned by this arena.</returns>
+		std::size_t Reserved( ) const;
+
+		/// <summary>
+		/// Allocates memory from the arena current on the calling thread, or from the heap if there is none.
+		/// </summary>
+		/// <parameter name="size">Number of bytes required.</parameter>
+		/// <returns>A pointer to at least size bytes.</returns>
+		static void* Allocate( std::size_t size );
+
+		/// <summary>
+		/// Frees memory returned by Allocate, memory belonging to an arena is reclaimed when the arena goes away.
+		/// </summary>
+		/// <parameter name="p">Pointer previously returned by Allocate, may be null.</parameter>
+		static void Deallocate( void* p );
+
+		/// <summary>
+		/// Makes an arena current on the calling thread for the lifetime of this object, restoring the previous one afterwards.
+		/// </summary>
+		class Scope
+		{
+			CodeArena* previous;
+
+			Scope( const Scope& );
+			Scope& operator = ( const Scope& );
+		public:
+			/// <summary>
+			/// Makes the given arena current on the calling thread.
+			/// </summary>
+			/// <parameter name="arena">Arena which will receive all node allocations made by this thread.</parameter>
+			explicit Scope( CodeArena& arena );
+			/// <summary>
+			/// Restores the arena which was current before this object was constructed.
+			/// </summary>
+			~Scope( );
+		};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+// Measures the heap used by code-graph nodes whose member collections are allocated on first use.
+// Not part of the library build, compile it together with the library sources and run it with no arguments.
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "../collections.h"
+#include "../types.h"
+#include "../functions.h"
+#include "../declarations.h"
+
+using namespace CPlusPlusCodeProvider;
+
+namespace
+{
+	std::size_t bytes = 0 , blocks = 0;
+
+	const int Nodes = 1000;
+
+	/// <summary>
+	/// Heap use counted since a point in the benchmark, printed as averages per node.
+	/// </summary>
+	class Measurement
+	{
+		const char* label;
+		std::size_t startbytes , startblocks;
+	public:
+		Measurement( const char* name )
+			: label( name ) , startbytes( bytes ) , startblocks( blocks )
+		{
+		}
+
+		void Report( int count ) const
+		{
+			std::cout << label << ": " << ( bytes - startbytes ) / double( count ) << " bytes, " << ( blocks - startblocks ) / double( count ) << " blocks\n";
+		}
+	};
+
+	copying_pointer< UserDefinedType > emptyclass( )
+	{
+		return UserDefinedType::Instantiate( L"T" , UserDefinedType::Class );
+	}
+}
+
+void* operator new( std::size_t size )
+{
+	bytes += size;
+	++blocks;
+	if( void* p = std::malloc( size ) )
+		return p;
+	throw std::bad_alloc( );
+}
+
+void operator delete( void* p ) throw( )
+{
+	std::free( p );
+}
+
+int main( )
+{
+	{
+		std::vector< copying_pointer< UserDefinedType > > types;
+		types.reserve( Nodes );
+		Measurement measure( "empty UserDefinedType" );
+		for( int i = 0 ; i < Nodes ; ++i )
+			types.push_back( emptyclass( ) );
+		measure.Report( Nodes );
+
+		Measurement reads( "reading members of an empty UserDefinedType" );
+		std::size_t members = 0;
+		for( int i = 0 ; i < Nodes ; ++i )
+		{
+			const UserDefinedType& type = *static_cast< const copying_pointer< UserDefinedType >& >( types[ i ] );
+			members += type.BaseTypes( ).size( ) + type.MemberFunctions( ).size( ) + type.MemberVariables( ).size( ) + type.Constructors( ).size( );
+		}
+		reads.Report( Nodes );
+	}
+	{
+		std::vector< copying_pointer< Union > > unions;
+		unions.reserve( Nodes );
+		Measurement measure( "empty Union" );
+		for( int i = 0 ; i < Nodes ; ++i )
+			unions.push_back( Union::Instantiate( L"U" ) );
+		measure.Report( Nodes );
+	}
+	{
+		copying_pointer< UserDefinedType > type = emptyclass( );
+		std::vector< copying_pointer< MemberFunction > > functions;
+		functions.reserve( Nodes );
+		Measurement measure( "MemberFunction, no parameters" );
+		for( int i = 0 ; i < Nodes ; ++i )
+			functions.push_back( MemberFunction::Instantiate( *type , L"f" , Public ) );
+		measure.Report( Nodes );
+	}
+	{
+		std::vector< copying_pointer< UserDefinedType > > types;
+		types.reserve( Nodes );
+		Measurement measure( "class with one function and one constructor" );
+		for( int i = 0 ; i < Nodes ; ++i )
+		{
+			types.push_back( emptyclass( ) );
+			UserDefinedType& type = *types.back( );
+			copying_pointer< MemberFunction > function = MemberFunction::Instantiate( type , L"f" , Public );
+			type.MemberFunctions( ).push_back( function );
+			copying_pointer< Constructor > constructor = Constructor::Instantiate( type );
+			type.Constructors( ).push_back( constructor );
+		}
+		measure.Report( Nodes );
+	}
+	return 0;
+}
\ No newline at end of file
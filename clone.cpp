@@ -0,0 +1,32 @@
+#include "clone.h"
+#include "cppcodeprovider.h"
+
+namespace CPlusPlusCodeProvider
+{
+	__declspec( thread ) CloneScope* CloneScope::current = 0;
+
+	CloneScope::CloneScope( )
+		: previous( current )
+	{
+		current = this;
+	}
+
+	CloneScope::~CloneScope( )
+	{
+		current = previous;
+	}
+
+	void CloneScope::record( const CodeObject& original , CodeObject& copy )
+	{
+		remapped[ dynamic_cast< const void* >( &original ) ] = dynamic_cast< void* >( &copy );
+		copies.push_back( &copy );
+	}
+
+	void CloneScope::Complete( )
+	{
+		// Remapping may copy further nodes, those are appended and visited by this same loop.
+		for( std::vector< CodeObject* >::size_type i = 0 ; i < copies.size( ) ; ++i )
+			copies[ i ] -> remap( *this );
+		copies.clear( );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef CLONE_HEADER
+#define CLONE_HEADER
+
+#include <unordered_map>
+#include <vector>
+
+namespace CPlusPlusCodeProvider
+{
+	class CodeObject;
+
+	/// <summary>
+	/// Deep copies a subtree of the code-graph in one pass, references between nodes of the subtree are redirected to their copies.
+	/// While a CloneScope is alive on a thread, shared nodes are copied instead of being shared, and every node copied through a proxy pointer is recorded against its original.
+	/// References outside the subtree are left pointing at the original nodes.
+	/// </summary>
+	class CloneScope
+	{
+		std::unordered_map< const void* , void* > remapped;
+		std::vector< CodeObject* > copies;
+		CloneScope* previous;
+
+		/// <summary>
+		/// Clone in progress on this thread, null if there is none.
+		/// </summary>
+		static __declspec( thread ) CloneScope* current;
+
+		CloneScope( const CloneScope& );
+		CloneScope& operator = ( const CloneScope& );
+
+		void record( const CodeObject& original , CodeObject& copy );
+	public:
+		/// <summary>
+		/// Starts a clone on the calling thread.
+		/// </summary>
+		CloneScope( );
+		/// <summary>
+		/// Restores the clone which was in progress before this object was constructed, if any.
+		/// </summary>
+		~CloneScope( );
+
+		/// <summary>
+		/// Tells whether a clone is in progress on the calling thread.
+		/// </summary>
+		/// <returns>True if nodes being copied are recorded, otherwise, false.</returns>
+		static bool Active( )
+		{
+			return current != 0;
+		}
+
+		/// <summary>
+		/// Records a node copied while a clone is in progress on the calling thread, does nothing otherwise.
+		/// </summary>
+		/// <parameter name="original" IsConst="true">Node which was copied.</parameter>
+		/// <parameter name="copy">The newly made copy.</parameter>
+		static void Copied( const CodeObject& original , CodeObject& copy )
+		{
+			if( current )
+				current -> record( original , copy );
+		}
+
+		/// <summary>
+		/// Redirects each recorded copy's references to nodes copied in this clone, after all nodes of the subtree have been copied.
+		/// </summary>
+		void Complete( );
+
+		/// <summary>
+		/// Redirects a reference to the copy of the node it refers to, if that node has been copied in this clone.
+		/// </summary>
+		/// <parameter name="pointer">Reference which is updated in place, null is left alone.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <requirements>T must be a polymorphic type.</requirements>
+		template< typename T > void Remap( T*& pointer ) const
+		{
+			if( !pointer )
+				return;
+			const void* whole = dynamic_cast< const void* >( pointer );
+			std::unordered_map< const void* , void* >::const_iterator found = remapped.find( whole );
+			// The copy has the same dynamic type, so the referenced base lies at the same offset inside it.
+			if( found != remapped.end( ) )
+				pointer = reinterpret_cast< T* >( static_cast< char* >( found -> second ) + ( reinterpret_cast< const char* >( pointer ) - static_cast< const char* >( whole ) ) );
+		}
+	};
+}
+
+#endif
\ No newline at end of file
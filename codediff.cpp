@@ -0,0 +1,249 @@
+#include <unordered_map>
+#include "codediff.h"
+#include "visitor.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::wstring;
+	using std::vector;
+
+	namespace
+	{
+		typedef std::unordered_multimap< unsigned long long , vector< const CodeObject* >::size_type > HashIndex;
+
+		/// <summary>
+		/// Tells whether a node is a declaration which is matched on its own rather than being part of the one enclosing it.
+		/// </summary>
+		bool declaration( const CodeObject& node )
+		{
+			switch( node.Kind( ) )
+			{
+			case NodeKind::CodeSnippet:
+			case NodeKind::Namespace:
+			case NodeKind::Typedefinition:
+			case NodeKind::PreprocessorDirective:
+			case NodeKind::MacroTestDirective:
+			case NodeKind::VariableDeclaration:
+			case NodeKind::VariableDeclarationList:
+			case NodeKind::Function:
+			case NodeKind::MemberFunction:
+			case NodeKind::Constructor:
+			case NodeKind::Destructor:
+			case NodeKind::Operator:
+			case NodeKind::MemberOperator:
+			case NodeKind::Union:
+			case NodeKind::Enumeration:
+			case NodeKind::UserDefinedType:
+				return true;
+			default:
+				break;
+			}
+			return false;
+		}
+
+		wstring join( const StringCollection& names )
+		{
+			wstring result;
+			for( StringCollection::const_iterator iter = names.begin( ) ; iter != names.end( ) ; ++iter )
+			{
+				if( !result.empty( ) )
+					result += L", ";
+				result += *iter;
+			}
+			return result;
+		}
+
+		/// <summary>
+		/// Returns the name a declaration is matched by, empty for those which have none.
+		/// </summary>
+		wstring name( const CodeObject& node )
+		{
+			switch( node.Kind( ) )
+			{
+			case NodeKind::Namespace:
+				return static_cast< const Namespace& >( node ).Name( );
+			case NodeKind::Typedefinition:
+				return join( static_cast< const Typedefinition& >( node ).Synonyms( ) );
+			case NodeKind::VariableDeclaration:
+				return static_cast< const VariableDeclaration& >( node ).Declarator( ).Name( );
+			case NodeKind::VariableDeclarationList:
+				{
+					const DeclaratorList& declarators = static_cast< const VariableDeclarationList& >( node ).Declarators( );
+					wstring result;
+					for( DeclaratorList::const_iterator iter = declarators.begin( ) ; iter != declarators.end( ) ; ++iter )
+					{
+						if( !result.empty( ) )
+							result += L", ";
+						result += iter -> Name( );
+					}
+					return result;
+				}
+			case NodeKind::Function:
+			case NodeKind::MemberFunction:
+			case NodeKind::Constructor:
+			case NodeKind::Destructor:
+			case NodeKind::Operator:
+			case NodeKind::MemberOperator:
+				return static_cast< const Function& >( node ).Name( );
+			case NodeKind::Union:
+			case NodeKind::Enumeration:
+			case NodeKind::UserDefinedType:
+				return static_cast< const Type& >( node ).Name( );
+			default:
+				break;
+			}
+			return wstring( );
+		}
+
+		/// <summary>
+		/// Builds the key declarations are matched by, declarations of different kinds never match even if their names do.
+		/// </summary>
+		wstring key( const CodeObject& node , const wstring& name )
+		{
+			return wstring( 1 , static_cast< wchar_t >( node.Kind( ) ) ) + name;
+		}
+
+		bool container( const CodeObject& node )
+		{
+			return node.Kind( ) == NodeKind::Namespace || node.Kind( ) == NodeKind::UserDefinedType;
+		}
+	}
+
+	void CodeDiff::declarations( const CodeObject& scope , vector< const CodeObject* >& members )
+	{
+		vector< const CodeObject* > children;
+		NodeChildren::Append( scope , children );
+		for( vector< const CodeObject* >::const_iterator iter = children.begin( ) ; iter != children.end( ) ; ++iter )
+			if( declaration( **iter ) )
+				members.push_back( *iter );
+	}
+
+	void CodeDiff::counterparts( const vector< const CodeObject* >& before , const vector< const CodeObject* >& after , CodeObject::Counterparts& pairs )
+	{
+		std::unordered_map< wstring , vector< const CodeObject* > > groups;
+		for( vector< const CodeObject* >::const_iterator iter = before.begin( ) ; iter != before.end( ) ; ++iter )
+			groups[ key( **iter , name( **iter ) ) ].push_back( *iter );
+		std::unordered_map< wstring , vector< const CodeObject* >::size_type > used;
+		for( vector< const CodeObject* >::const_iterator iter = after.begin( ) ; iter != after.end( ) ; ++iter )
+		{
+			const wstring match = key( **iter , name( **iter ) );
+			std::unordered_map< wstring , vector< const CodeObject* > >::const_iterator group = groups.find( match );
+			if( group == groups.end( ) )
+				continue;
+			vector< const CodeObject* >::size_type& next = used[ match ];
+			if( next == group -> second.size( ) )
+				continue;
+			const CodeObject* old = group -> second[ next++ ];
+			pairs[ old ] = *iter;
+			vector< const CodeObject* > oldmembers , newmembers;
+			declarations( *old , oldmembers );
+			declarations( **iter , newmembers );
+			counterparts( oldmembers , newmembers , pairs );
+		}
+	}
+
+	void CodeDiff::compare( const wstring& scope , const vector< const CodeObject* >& before , const vector< const CodeObject* >& after , const CodeObject::Counterparts& pairs , DifferenceCollection& differences )
+	{
+		typedef vector< const CodeObject* >::size_type size_type;
+		// Old declarations sharing a key, in order, and their positions by hash for finding unchanged ones in constant time.
+		struct Group
+		{
+			vector< size_type > members;
+			HashIndex hashes;
+			size_type next;
+		};
+		std::unordered_map< wstring , Group > groups;
+		vector< wstring > names( before.size( ) );
+		vector< bool > matched( before.size( ) , false );
+		for( size_type i = 0 ; i < before.size( ) ; ++i )
+		{
+			names[ i ] = name( *before[ i ] );
+			Group& group = groups[ key( *before[ i ] , names[ i ] ) ];
+			group.members.push_back( i );
+			group.hashes.insert( std::make_pair( before[ i ] -> Hash( ) , i ) );
+			group.next = 0;
+		}
+
+		// Unchanged declarations are matched first, so that an edit to one overload is not reported against another.
+		vector< const CodeObject* > partners( after.size( ) , 0 );
+		vector< wstring > keys( after.size( ) );
+		for( size_type i = 0 ; i < after.size( ) ; ++i )
+		{
+			keys[ i ] = key( *after[ i ] , name( *after[ i ] ) );
+			std::unordered_map< wstring , Group >::iterator group = groups.find( keys[ i ] );
+			if( group == groups.end( ) )
+				continue;
+			std::pair< HashIndex::iterator , HashIndex::iterator > range = group -> second.hashes.equal_range( after[ i ] -> Hash( ) );
+			for( HashIndex::iterator candidate = range.first ; candidate != range.second ; ++candidate )
+				if( before[ candidate -> second ] -> Equals( *after[ i ] , pairs ) )
+				{
+					partners[ i ] = before[ candidate -> second ];
+					matched[ candidate -> second ] = true;
+					group -> second.hashes.erase( candidate );
+					break;
+				}
+		}
+
+		for( size_type i = 0 ; i < after.size( ) ; ++i )
+		{
+			if( partners[ i ] )
+				continue;
+			const wstring qualified = scope + keys[ i ].substr( 1 );
+			std::unordered_map< wstring , Group >::iterator group = groups.find( keys[ i ] );
+			const CodeObject* old = 0;
+			// Unnamed declarations have nothing to identify them by, so they are only ever added or removed.
+			if( group != groups.end( ) && keys[ i ].size( ) > 1 )
+			{
+				Group& candidates = group -> second;
+				while( candidates.next < candidates.members.size( ) && matched[ candidates.members[ candidates.next ] ] )
+					++candidates.next;
+				if( candidates.next < candidates.members.size( ) )
+				{
+					matched[ candidates.members[ candidates.next ] ] = true;
+					old = before[ candidates.members[ candidates.next ] ];
+				}
+			}
+			if( !old )
+			{
+				Difference difference = { Difference::Added , qualified , 0 , after[ i ] };
+				differences.push_back( difference );
+				continue;
+			}
+			if( after[ i ] -> Kind( ) != NodeKind::Namespace )
+			{
+				Difference difference = { Difference::Modified , qualified , old , after[ i ] };
+				differences.push_back( difference );
+			}
+			if( container( *after[ i ] ) )
+			{
+				vector< const CodeObject* > oldmembers , newmembers;
+				declarations( *old , oldmembers );
+				declarations( *after[ i ] , newmembers );
+				compare( qualified + L"::" , oldmembers , newmembers , pairs , differences );
+			}
+		}
+
+		for( size_type i = 0 ; i < before.size( ) ; ++i )
+			if( !matched[ i ] )
+			{
+				Difference difference = { Difference::Removed , scope + names[ i ] , before[ i ] , 0 };
+				differences.push_back( difference );
+			}
+	}
+
+	DifferenceCollection CodeDiff::Compare( const CompilationUnit& before , const CompilationUnit& after )
+	{
+		vector< const CodeObject* > oldmembers , newmembers;
+		for( CodeCollection::const_iterator iter = before.codeblock.begin( ) ; iter != before.codeblock.end( ) ; ++iter )
+			if( declaration( **iter ) )
+				oldmembers.push_back( iter -> pointer( ) );
+		for( CodeCollection::const_iterator iter = after.codeblock.begin( ) ; iter != after.codeblock.end( ) ; ++iter )
+			if( declaration( **iter ) )
+				newmembers.push_back( iter -> pointer( ) );
+		CodeObject::Counterparts pairs;
+		counterparts( oldmembers , newmembers , pairs );
+		DifferenceCollection differences;
+		compare( L"" , oldmembers , newmembers , pairs , differences );
+		return differences;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef CODEDIFF_HEADER
+#define CODEDIFF_HEADER
+
+#include <string>
+#include <vector>
+#include "cppcodeprovider.h"
+#include "compilationunit.h"
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// Describes one declaration which was added, removed or modified between two compilation units.
+	/// </summary>
+	struct Difference
+	{
+		/// <summary>
+		/// Provides the ways in which a declaration can differ.
+		/// </summary>
+		enum ChangeType
+		{
+			/// <summary>
+			/// The declaration is only present in the new compilation unit.
+			/// </summary>
+			Added ,
+			/// <summary>
+			/// The declaration is only present in the old compilation unit.
+			/// </summary>
+			Removed ,
+			/// <summary>
+			/// The declaration is present in both but its structure differs.
+			/// </summary>
+			Modified
+		};
+
+		/// <summary>
+		/// How the declaration differs.
+		/// </summary>
+		ChangeType Change;
+		/// <summary>
+		/// Name of the declaration qualified with the namespaces and types enclosing it, empty for unnamed declarations such as preprocessor directives.
+		/// </summary>
+		std::wstring Name;
+		/// <summary>
+		/// Declaration in the old compilation unit, null if it was added.
+		/// </summary>
+		const CodeObject* Before;
+		/// <summary>
+		/// Declaration in the new compilation unit, null if it was removed.
+		/// </summary>
+		const CodeObject* After;
+	};
+
+	typedef std::vector< Difference > DifferenceCollection;
+
+	/// <summary>
+	/// Compares two versions of a compilation unit declaration by declaration, so that only the changed ones need to be generated and compiled again.
+	/// Declarations are matched by kind and qualified name, overloads sharing a name are matched with equal ones first and the rest in order.
+	/// Matched declarations are compared by structural hash, a modified type is reported along with its modified members and a namespace is descended into without being reported itself.
+	/// Names a declaration refers to are resolved to the declaration of the same kind and qualified name in the other version, so a declaration is only reported when it changes itself.
+	/// </summary>
+	/// <remarks>Hashes are cached, so comparing takes time linear in the size of both graphs the first time and only revisits changed paths afterwards.</remarks>
+	class CodeDiff
+	{
+		CodeDiff( );
+
+		/// <summary>
+		/// Appends the declarations owned by a namespace or a type, leaving out comments and template parameters.
+		/// </summary>
+		static void declarations( const CodeObject& scope , std::vector< const CodeObject* >& members );
+
+		/// <summary>
+		/// Pairs up the declarations of one scope in both versions by kind, name and position among those sharing both, descending into each pair.
+		/// </summary>
+		static void counterparts( const std::vector< const CodeObject* >& before , const std::vector< const CodeObject* >& after , CodeObject::Counterparts& pairs );
+
+		/// <summary>
+		/// Matches the declarations of one scope in both versions, appending their differences and descending into modified namespaces and types.
+		/// </summary>
+		static void compare( const std::wstring& scope , const std::vector< const CodeObject* >& before , const std::vector< const CodeObject* >& after , const CodeObject::Counterparts& pairs , DifferenceCollection& differences );
+	public:
+		/// <summary>
+		/// Lists the declarations which differ between two versions of a compilation unit.
+		/// </summary>
+		/// <parameter name="before" IsConst="true">Old version of the compilation unit.</parameter>
+		/// <parameter name="after" IsConst="true">New version of the compilation unit.</parameter>
+		/// <returns>Differences of each scope in the order of the new version, followed by the declarations removed from it, with the members of a modified declaration right after it.</returns>
+		static DifferenceCollection Compare( const CompilationUnit& before , const CompilationUnit& after );
+	};
+}
+
+#endif
\ No newline at end of file
@@ -1,22 +1,101 @@
 #ifndef COLLECTIONS_HEADER
 #define COLLECTIONS_HEADER
 
-#include <list>
+#include <atomic>
+#include <vector>
 #include <string>
+#include <utility>
 #include "utility.h"
+#include "arena.h"
+#include "identifier.h"
+#include "rendercache.h"
 
 namespace CPlusPlusCodeProvider
 {
 	/// <summary>
-	/// Provides a modified interface to std::list&lt; T &gt;.
+	/// Hands out the first revision numbers of collections, by which a TypedCollection tells apart a change to elements already in it from an append.
 	/// </summary>
+	class CollectionRevision
+	{
+		static std::atomic< unsigned long long > stamps;
+	public:
+		/// <summary>
+		/// Returns a revision number no collection has started from before, its low 32 bits are zero and left for the collection to count its own changes in.
+		/// </summary>
+		/// <returns>A fresh revision number.</returns>
+		static unsigned long long Stamp( );
+	};
+
+	/// <summary>
+	/// Provides a modified interface to std::vector&lt; T &gt;, elements are stored contiguously so building and iterating them is cache friendly.
+	/// </summary>
+	/// <remarks>The revision is advanced whenever elements may be removed or replaced, which includes handing out a non-const iterator, but not by appending. Each collection counts its own changes, so changing one never touches state shared with others.</remarks>
 	template< typename T > class TypedCollection
 	{
-		std::list< T > data;
+		std::vector< T > data;
+		RenderCache cache;
+		unsigned long long stamp;
 	public:
-		typedef typename std::list< T >::iterator iterator;
-		typedef typename std::list< T >::const_iterator const_iterator;
-		typedef typename std::list< T >::size_type size_type;
+		typedef typename std::vector< T >::iterator iterator;
+		typedef typename std::vector< T >::const_iterator const_iterator;
+		typedef typename std::vector< T >::size_type size_type;
+
+		/// <summary>
+		/// Constructs an empty TypedCollection.
+		/// </summary>
+		TypedCollection( )
+			: stamp( CollectionRevision::Stamp( ) )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a copy of another TypedCollection.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other TypedCollection to copy.</parameter>
+		TypedCollection( const TypedCollection& other )
+			: data( other.data ) , stamp( CollectionRevision::Stamp( ) )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a TypedCollection by taking over the elements of another one.
+		/// </summary>
+		/// <parameter name="other">Other TypedCollection whose elements are taken over, it is left empty.</parameter>
+		TypedCollection( TypedCollection&& other ) throw( )
+			: data( std::move( other.data ) ) , stamp( CollectionRevision::Stamp( ) )
+		{
+			++other.stamp;
+		}
+
+		/// <summary>
+		/// Replaces contents of this TypedCollection with a copy of another one.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other TypedCollection to copy.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& operator = ( const TypedCollection& other )
+		{
+			data = other.data;
+			++stamp;
+			cache.Invalidate( );
+			return *this;
+		}
+
+		/// <summary>
+		/// Replaces contents of this TypedCollection by taking over the elements of another one.
+		/// </summary>
+		/// <parameter name="other">Other TypedCollection whose elements are taken over, it is left empty.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& operator = ( TypedCollection&& other ) throw( )
+		{
+			if( this != &other )
+			{
+				data = std::move( other.data );
+				++stamp;
+				++other.stamp;
+				cache.Invalidate( );
+			}
+			return *this;
+		}
 
 		/// <summary>
 		/// Appends a sequence to this one.
@@ -26,14 +105,18 @@ namespace CPlusPlusCodeProvider
 		template< typename iter > void append( iter start , iter finish )
 		{
 			data.insert( data.end( ) , start , finish );
+			cache.Invalidate( );
 		}
 
 		/// <summary>
 		/// Allows you to iterate the sequence.
 		/// </summary>
 		/// <returns>An iterator that points to the beginning of the sequence.</returns>
+		/// <remarks>Elements may be replaced or changed through the iterator, shared ones are copied on first change without telling their holders, so the revision of this collection is renewed and its renderings are discarded.</remarks>
 		iterator begin( )
 		{
+			cache.Invalidate( );
+			++stamp;
 			return data.begin( );
 		}
 
@@ -44,6 +127,8 @@ namespace CPlusPlusCodeProvider
 		/// <returns>An iterator that points to the beginning of the sequence.</returns>
 		const_iterator begin( ) const
 		{
+			if( this != &empty )
+				cache.Track( );
 			return data.begin( );
 		}
 
@@ -76,12 +161,35 @@ namespace CPlusPlusCodeProvider
 			return data.size( );
 		}
 
+		/// <summary>
+		/// Returns the revision of this collection, which stays the same as long as elements are only appended to it.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A number which differs from every earlier revision of any collection once elements may have been removed or replaced, unless this collection changed 2^32 times.</returns>
+		unsigned long long revision( ) const
+		{
+			return stamp;
+		}
+
+		/// <summary>
+		/// Makes room for at least the given number of elements so that adding up to that many does not reallocate.
+		/// </summary>
+		/// <parameter name="count">Number of elements to make room for.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& reserve( size_type count )
+		{
+			data.reserve( count );
+			return *this;
+		}
+
 		/// <summary>
 		/// Purges all the elements contained in the sequenece.
 		/// </summary>
 		void clear( )
 		{
 			data.clear( );
+			++stamp;
+			cache.Invalidate( );
 		}
 
 		/// <summary>
@@ -92,24 +200,91 @@ namespace CPlusPlusCodeProvider
 		TypedCollection& push_back( const T& value )
 		{
 			data.push_back( value );
+			cache.Invalidate( );
+			return *this;
+		}
+
+		/// <summary>
+		/// Adds an element to the end of sequenece by moving it in, no copy is made.
+		/// </summary>
+		/// <parameter name="value">Element to be added, it is left in a moved-from state.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& push_back( T&& value )
+		{
+			data.push_back( std::move( value ) );
+			cache.Invalidate( );
 			return *this;
 		}
 
+		/// <summary>
+		/// Allocates memory for a collection from the CodeArena current on the calling thread, or from the heap if there is none.
+		/// </summary>
+		/// <parameter name="size">Size of the collection being allocated.</parameter>
+		/// <returns>A pointer to memory for the new collection.</returns>
+		static void* operator new( std::size_t size )
+		{
+			return CodeArena::Allocate( size );
+		}
+
+		/// <summary>
+		/// Frees memory of a collection allocated by operator new.
+		/// </summary>
+		/// <parameter name="p">Pointer to the memory being freed.</parameter>
+		static void operator delete( void* p )
+		{
+			CodeArena::Deallocate( p );
+		}
+
 		/// <summary>
 		/// Provides a single empty TypedCollection in order to save space, both at compile time and at runtime.
 		/// </summary>
 		static const TypedCollection< T > empty;
 	};
 
+	template< typename T > const TypedCollection< T > TypedCollection< T >::empty;
+
 	/// <summary>
 	/// A partial specialization of TypedCollection for pointers, this class owns the pointers put into it and deletes them when purge is called.
 	/// </summary>
 	template< typename T > class TypedCollection< T* >
 	{
-		std::list< T* > data;
+		std::vector< T* > data;
+		RenderCache cache;
 	public:
-		typedef typename std::list< T* >::const_iterator const_iterator;
-		typedef typename std::list< T* >::size_type size_type;
+		typedef typename std::vector< T* >::const_iterator const_iterator;
+		typedef typename std::vector< T* >::size_type size_type;
+
+		/// <summary>
+		/// Constructs an empty TypedCollection.
+		/// </summary>
+		TypedCollection( )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a TypedCollection by taking over the elements of another one.
+		/// </summary>
+		/// <parameter name="other">Other TypedCollection whose elements are taken over, it is left empty.</parameter>
+		TypedCollection( TypedCollection&& other ) throw( )
+			: data( std::move( other.data ) )
+		{
+		}
+
+		/// <summary>
+		/// Replaces contents of this TypedCollection by taking over the elements of another one.
+		/// </summary>
+		/// <parameter name="other">Other TypedCollection whose elements are taken over, it is left empty.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& operator = ( TypedCollection&& other ) throw( )
+		{
+			if( this != &other )
+			{
+				purge( );
+				data = std::move( other.data );
+				cache.Invalidate( );
+			}
+			return *this;
+		}
 
 		/// <summary>
 		/// Deletes all the contained pointer.
@@ -127,6 +302,7 @@ namespace CPlusPlusCodeProvider
 		template< typename iter > void append( iter start , iter finish )
 		{
 			data.insert( data.end( ) , start , finish );
+			cache.Invalidate( );
 		}
 
 		/// <summary>
@@ -136,6 +312,8 @@ namespace CPlusPlusCodeProvider
 		/// <returns>An iterator that points to the beginning of the sequence.</returns>
 		const_iterator begin( ) const
 		{
+			if( this != &empty )
+				cache.Track( );
 			return data.begin( );
 		}
 
@@ -159,12 +337,24 @@ namespace CPlusPlusCodeProvider
 			return data.size( );
 		}
 
+		/// <summary>
+		/// Makes room for at least the given number of elements so that adding up to that many does not reallocate.
+		/// </summary>
+		/// <parameter name="count">Number of elements to make room for.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& reserve( size_type count )
+		{
+			data.reserve( count );
+			return *this;
+		}
+
 		/// <summary>
 		/// Purges all the elements contained in the sequenece.
 		/// </summary>
 		void clear( )
 		{
 			data.clear( );
+			cache.Invalidate( );
 		}
 
 		/// <summary>
@@ -175,6 +365,7 @@ namespace CPlusPlusCodeProvider
 		TypedCollection& push_back( T& value )
 		{
 			data.push_back( &value );
+			cache.Invalidate( );
 			return *this;
 		}
 
@@ -188,21 +379,95 @@ namespace CPlusPlusCodeProvider
 			clear( );
 		}
 
+		/// <summary>
+		/// Allocates memory for a collection from the CodeArena current on the calling thread, or from the heap if there is none.
+		/// </summary>
+		/// <parameter name="size">Size of the collection being allocated.</parameter>
+		/// <returns>A pointer to memory for the new collection.</returns>
+		static void* operator new( std::size_t size )
+		{
+			return CodeArena::Allocate( size );
+		}
+
+		/// <summary>
+		/// Frees memory of a collection allocated by operator new.
+		/// </summary>
+		/// <parameter name="p">Pointer to the memory being freed.</parameter>
+		static void operator delete( void* p )
+		{
+			CodeArena::Deallocate( p );
+		}
+
 		/// <summary>
 		/// Provides a single empty TypedCollection in order to save space, both at compile time and at runtime.
 		/// </summary>
 		static const TypedCollection< T* > empty;
 	};
 
+	template< typename T > const TypedCollection< T* > TypedCollection< T* >::empty;
+
 	/// <summary>
-	/// Specialization for std::wstring.
+	/// Specialization for std::wstring, strings are stored as pooled Identifiers so repeated names share storage.
 	/// </summary>
 	template< > class TypedCollection< std::wstring >
 	{
-		std::list< std::wstring > data;
+		std::vector< Identifier > data;
+		RenderCache cache;
 	public:
-		typedef std::list< std::wstring >::const_iterator const_iterator;
-		typedef std::list< std::wstring >::size_type size_type;
+		typedef std::vector< Identifier >::const_iterator const_iterator;
+		typedef std::vector< Identifier >::size_type size_type;
+
+		/// <summary>
+		/// Constructs an empty TypedCollection.
+		/// </summary>
+		TypedCollection( )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a copy of another TypedCollection.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other TypedCollection to copy.</parameter>
+		TypedCollection( const TypedCollection& other )
+			: data( other.data )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a TypedCollection by taking over the elements of another one.
+		/// </summary>
+		/// <parameter name="other">Other TypedCollection whose elements are taken over, it is left empty.</parameter>
+		TypedCollection( TypedCollection&& other ) throw( )
+			: data( std::move( other.data ) )
+		{
+		}
+
+		/// <summary>
+		/// Replaces contents of this TypedCollection with a copy of another one.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other TypedCollection to copy.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& operator = ( const TypedCollection& other )
+		{
+			data = other.data;
+			cache.Invalidate( );
+			return *this;
+		}
+
+		/// <summary>
+		/// Replaces contents of this TypedCollection by taking over the elements of another one.
+		/// </summary>
+		/// <parameter name="other">Other TypedCollection whose elements are taken over, it is left empty.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& operator = ( TypedCollection&& other ) throw( )
+		{
+			if( this != &other )
+			{
+				data = std::move( other.data );
+				cache.Invalidate( );
+			}
+			return *this;
+		}
 
 		/// <summary>
 		/// Allows you to iterate the sequence.
@@ -211,6 +476,8 @@ namespace CPlusPlusCodeProvider
 		/// <returns>An iterator that points to the beginning of the sequence.</returns>
 		const_iterator begin( ) const
 		{
+			if( this != &empty )
+				cache.Track( );
 			return data.begin( );
 		}
 
@@ -234,25 +501,57 @@ namespace CPlusPlusCodeProvider
 			return data.size( );
 		}
 
+		/// <summary>
+		/// Makes room for at least the given number of elements so that adding up to that many does not reallocate.
+		/// </summary>
+		/// <parameter name="count">Number of elements to make room for.</parameter>
+		/// <returns>A reference to this object.</returns>
+		TypedCollection& reserve( size_type count )
+		{
+			data.reserve( count );
+			return *this;
+		}
+
 		/// <summary>
 		/// Purges all the elements contained in the sequenece.
 		/// </summary>
 		void clear( )
 		{
 			data.clear( );
+			cache.Invalidate( );
 		}
 
 		/// <summary>
 		/// Adds an element to the end of sequenece.
 		/// </summary>
-		/// <parameter name="value" IsConst="true">Element to be added.</parameter>
+		/// <parameter name="value" IsConst="true">Element to be added, a string converts to its pooled Identifier.</parameter>
 		/// <returns>A reference to this object.</returns>
-		TypedCollection& push_back( const std::wstring& value )
+		TypedCollection& push_back( const Identifier& value )
 		{
 			data.push_back( value );
+			cache.Invalidate( );
 			return *this;
 		}
 
+		/// <summary>
+		/// Allocates memory for a collection from the CodeArena current on the calling thread, or from the heap if there is none.
+		/// </summary>
+		/// <parameter name="size">Size of the collection being allocated.</parameter>
+		/// <returns>A pointer to memory for the new collection.</returns>
+		static void* operator new( std::size_t size )
+		{
+			return CodeArena::Allocate( size );
+		}
+
+		/// <summary>
+		/// Frees memory of a collection allocated by operator new.
+		/// </summary>
+		/// <parameter name="p">Pointer to the memory being freed.</parameter>
+		static void operator delete( void* p )
+		{
+			CodeArena::Deallocate( p );
+		}
+
 		/// <summary>
 		/// Provides a single empty TypedCollection&lt; std::wstring &gt; in order to save space, both at compile time and at runtime.
 		/// </summary>
@@ -274,7 +573,7 @@ namespace CPlusPlusCodeProvider
 	/// <summary>
 	/// Provides a strongly typed collection of all statements.
 	/// </summary>
-	typedef TypedCollection< copying_pointer< CodeObject > > CodeCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > CodeCollection;
 
 	class Constructor;
 	/// <summary>
@@ -1,15 +1,18 @@
 #include "cppcodeprovider.h"
-#include <sstream>
+#include "output.h"
 
 namespace CPlusPlusCodeProvider
 {
 	using std::wstring;
 	using std::wostream;
 
+	const Comment Comment::empty( L"" );
+
 	Comment& Comment::Assign( const CodeObject& object )
 	{
 		const Comment& ref = cast< Comment >( object );
 		text = ref.text;
+		Invalidate( );
 		return *this;
 	}
 
@@ -21,11 +24,13 @@ namespace CPlusPlusCodeProvider
 	Comment::Comment( const wstring& comment )
 		 : text( comment ) , object_source( false ) , multiline( false )
 	{
+		tag( NodeKind::Comment );
 	}
 
 	Comment::Comment( const CodeObject& other )
 		: object( &other ) , object_source( true ) , multiline( false )
 	{
+		tag( NodeKind::Comment );
 	}
 
 	bool Comment::IsEmpty( ) const
@@ -41,6 +46,7 @@ namespace CPlusPlusCodeProvider
 	Comment& Comment::MultiLine( bool flag )
 	{
 		multiline = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -51,21 +57,23 @@ namespace CPlusPlusCodeProvider
 
 	void Comment::writetext( wostream& os , unsigned long tabs ) const
 	{
+		wstring contents = text;
+		bool block = multiline;
 		if( object_source )
 		{
-			std::wstringstream ws;
+			OutputStream ws;
 			object -> write( ws , tabs );
-			text = ws.str( );
-			multiline = text.find_first_of( L'\n' ) != wstring::npos;
+			contents = ws.str( );
+			block = contents.find_first_of( L'\n' ) != wstring::npos;
 		}
-		if( !text.size( ) )
+		if( !contents.size( ) )
 			return;
-		if( !MultiLine( ) )
-			os << L"/*" << text << L"*/";
+		if( !block )
+			os << L"/*" << contents << L"*/";
 		else
 		{
 			os << L"//";
-			wstring result = text;
+			wstring result = contents;
 			wstring::size_type n = result.find( L'\n' );
 			while( n != wstring::npos )
 				result.replace( n , 1 , L'\n' + wstring( tabs , FormattingData::IndentationCharacter ) + L"//" ) , n = result.find( L'\n' , ++n );
@@ -1,19 +1,90 @@
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <utility>
 #include "cppcodeprovider.h"
 #include "compilationunit.h"
+#include "dependencygraph.h"
+#include "namespace.h"
+#include "output.h"
 
 namespace CPlusPlusCodeProvider
 {
+	using std::invalid_argument;
+	using std::vector;
+	using std::wostream;
+	using std::wstring;
+
 	CompilationUnit::CompilationUnit( const std::wstring& str )
-		: name( str ) , comment( Comment::Instantiate( ) )
+		: arena( 0 ) , name( str )
+	{
+	}
+
+	CompilationUnit::CompilationUnit( const CompilationUnit& other )
+		: arena( 0 ) , codeblock( other.codeblock ) , name( other.name ) , comment( other.comment )
+	{
+	}
+
+	CompilationUnit::CompilationUnit( CompilationUnit&& other )
+		: arena( other.arena ) , codeblock( std::move( other.codeblock ) ) , name( std::move( other.name ) ) , comment( std::move( other.comment ) )
+	{
+		other.arena = 0;
+	}
+
+	CompilationUnit::~CompilationUnit( )
 	{
+		if( arena )
+			arena -> Release( );
+	}
+
+	CompilationUnit& CompilationUnit::operator = ( const CompilationUnit& other )
+	{
+		codeblock = other.codeblock;
+		name = other.name;
+		comment = other.comment;
+		return *this;
+	}
+
+	CompilationUnit& CompilationUnit::operator = ( CompilationUnit&& other )
+	{
+		std::swap( arena , other.arena );
+		codeblock = std::move( other.codeblock );
+		name = std::move( other.name );
+		comment = std::move( other.comment );
+		return *this;
 	}
 
 	Comment& CompilationUnit::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
+	}
+
+	std::wstring CompilationUnit::Name( ) const
+	{
+		return name;
+	}
+
+	CodeArena& CompilationUnit::Arena( )
+	{
+		if( !arena )
+			arena = &CodeArena::Instantiate( );
+		return *arena;
+	}
+
+	CompilationUnit CompilationUnit::Clone( const std::wstring& file ) const
+	{
+		CompilationUnit copy( file );
+		{
+			CodeArena::Scope scope( copy.Arena( ) );
+			CloneScope clone;
+			copy.codeblock = codeblock;
+			copy.comment = comment;
+			clone.Complete( );
+		}
+		return copy;
 	}
 
 	CodeCollection& CompilationUnit::Declarations( )
@@ -23,16 +94,167 @@ namespace CPlusPlusCodeProvider
 
 	void CompilationUnit::write( ) const
 	{
-		std::wofstream os( name.c_str( ) );
+		std::ofstream os( name.c_str( ) );
 		write( os );
 	}
 
+	bool CompilationUnit::writeifchanged( ) const
+	{
+		OutputStream buffer;
+		write( buffer );
+		const std::string text = buffer.Buffer( ).Utf8( );
+
+		// The existing file is read back in the same mode write( ) produces it in, so line endings compare equal.
+		std::ifstream existing( name.c_str( ) );
+		if( existing )
+		{
+			char chunk[ 4096 ];
+			std::string::size_type offset = 0 , count;
+			bool same = true;
+			while( same && ( count = static_cast< std::string::size_type >( existing.read( chunk , sizeof( chunk ) ).gcount( ) ) ) != 0 )
+			{
+				same = offset + count <= text.size( ) && text.compare( offset , count , chunk , count ) == 0;
+				offset += count;
+			}
+			if( same && offset == text.size( ) )
+				return false;
+		}
+		existing.close( );
+
+		std::ofstream os( name.c_str( ) );
+		os.write( text.data( ) , text.size( ) );
+		return true;
+	}
+
+	void CompilationUnit::write( std::ostream& os ) const
+	{
+		OutputStream buffer;
+		write( buffer );
+		buffer.WriteUtf8To( os );
+	}
+
 	void CompilationUnit::write( std::wostream& os ) const
 	{
-		comment -> write( os , 0 );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , 0 );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
-		for( CodeCollection::const_iterator i = codeblock.begin( ) ; i != codeblock.end( ) ; ++i )
-			( *i ) -> write( os , 0 );
+		EmissionOrder order = DependencyGraph::Order( codeblock );
+		for( EmissionOrder::const_iterator i = order.begin( ) ; i != order.end( ) ; ++i )
+			if( i -> Forward )
+				DependencyGraph::Declare( *i -> Node , os , 0 );
+			else
+				i -> Node -> write( os , 0 );
+	}
+
+	void CompilationUnit::write( std::wostream& declos , std::wostream& defos , std::wostream& fwdos ) const
+	{
+		comment.write( declos , 0 );
+		if( !comment.IsEmpty( ) )
+			declos << L'\n';
+		EmissionOrder order = DependencyGraph::Order( codeblock );
+		for( EmissionOrder::const_iterator i = order.begin( ) ; i != order.end( ) ; ++i )
+			if( i -> Forward )
+				DependencyGraph::Declare( *i -> Node , declos , 0 );
+			else
+				i -> Node -> write( declos , defos , fwdos , 0 , 0 );
+	}
+
+	void CompilationUnit::fragments( const CodeCollection& declarations , vector< const Namespace* >& path , wostream& declos , vector< Fragment >& pieces ) const
+	{
+		const unsigned long tabs = static_cast< unsigned long >( path.size( ) );
+		EmissionOrder order = DependencyGraph::Order( declarations );
+		for( EmissionOrder::const_iterator i = order.begin( ) ; i != order.end( ) ; ++i )
+			if( i -> Forward )
+				DependencyGraph::Declare( *i -> Node , declos , tabs );
+			else if( i -> Node -> Kind( ) == NodeKind::Namespace )
+			{
+				const Namespace& scope = static_cast< const Namespace& >( *i -> Node );
+				scope.track( );
+				scope.writeheading( declos , tabs );
+				path.push_back( &scope );
+				fragments( *scope.codeblock , path , declos , pieces );
+				path.pop_back( );
+				declos << wstring( tabs , FormattingData::IndentationCharacter ) << L"}\n";
+			}
+			else
+			{
+				vector< wstring > definitions;
+				OutputStream rest;
+				{
+					DefinitionScope scope( definitions );
+					i -> Node -> write( declos , rest , tabs , tabs );
+				}
+				if( !rest.Empty( ) )
+					definitions.push_back( rest.str( ) );
+				for( vector< wstring >::iterator definition = definitions.begin( ) ; definition != definitions.end( ) ; ++definition )
+				{
+					pieces.push_back( Fragment( ) );
+					pieces.back( ).Path = path;
+					pieces.back( ).Text.swap( *definition );
+				}
+			}
+	}
+
+	void CompilationUnit::write( std::wostream& declos , const std::wstring& header , const std::vector< std::wostream* >& shards ) const
+	{
+		if( shards.empty( ) )
+			throw invalid_argument( "At least one stream is required for the definitions." );
+
+		comment.write( declos , 0 );
+		if( !comment.IsEmpty( ) )
+			declos << L'\n';
+		vector< const Namespace* > path;
+		vector< Fragment > pieces;
+		fragments( codeblock , path , declos , pieces );
+
+		// Largest first onto the least loaded shard keeps the shards within one fragment of each other.
+		typedef std::pair< std::size_t , std::size_t > Weight;
+		vector< Weight > sizes;
+		sizes.reserve( pieces.size( ) );
+		for( std::size_t i = 0 ; i < pieces.size( ) ; ++i )
+			sizes.push_back( Weight( pieces[ i ].Text.size( ) , i ) );
+		std::stable_sort( sizes.begin( ) , sizes.end( ) , std::greater< Weight >( ) );
+
+		std::priority_queue< Weight , vector< Weight > , std::greater< Weight > > loads;
+		for( std::size_t i = 0 ; i < shards.size( ) ; ++i )
+			loads.push( Weight( 0 , i ) );
+		vector< std::size_t > owner( pieces.size( ) );
+		for( vector< Weight >::const_iterator i = sizes.begin( ) ; i != sizes.end( ) ; ++i )
+		{
+			Weight lightest = loads.top( );
+			loads.pop( );
+			owner[ i -> second ] = lightest.second;
+			lightest.first += i -> first;
+			loads.push( lightest );
+		}
+
+		for( std::size_t shard = 0 ; shard < shards.size( ) ; ++shard )
+		{
+			wostream& os = *shards[ shard ];
+			os << L"#include \"" << header << L"\"\n";
+			vector< const Namespace* > open;
+			for( std::size_t i = 0 ; i < pieces.size( ) ; ++i )
+			{
+				if( owner[ i ] != shard )
+					continue;
+				const vector< const Namespace* >& wanted = pieces[ i ].Path;
+				std::size_t common = 0;
+				while( common < open.size( ) && common < wanted.size( ) && open[ common ] == wanted[ common ] )
+					++common;
+				while( open.size( ) > common )
+				{
+					open.pop_back( );
+					os << wstring( open.size( ) , FormattingData::IndentationCharacter ) << L"}\n";
+				}
+				for( ; open.size( ) < wanted.size( ) ; open.push_back( wanted[ open.size( ) ] ) )
+					wanted[ open.size( ) ] -> writedefinitionheading( os , static_cast< unsigned long >( open.size( ) ) );
+				os << pieces[ i ].Text;
+			}
+			while( !open.empty( ) )
+			{
+				open.pop_back( );
+				os << wstring( open.size( ) , FormattingData::IndentationCharacter ) << L"}\n";
+			}
+		}
 	}
 }
\ No newline at end of file
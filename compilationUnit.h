@@ -2,21 +2,48 @@
 #define COMPILATIONUNIT_HEADER
 
 #include <fstream>
+#include <vector>
+#include "cppcodeprovider.h"
 #include "collections.h"
 
 namespace CPlusPlusCodeProvider
 {
-	typedef TypedCollection< copying_pointer< CodeObject > > CodeCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > CodeCollection;
+
+	class Namespace;
 
 	/// <summary>
 	/// Provides an abstraction of a source file or a header.
 	/// </summary>
 	class CompilationUnit
 	{
+		friend class Snapshot;
+		friend class CodeDiff;
+		friend class SymbolTable;
+		CodeArena* arena;
 		CodeCollection codeblock;
 
 		std::wstring name;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
+
+		/// <summary>
+		/// Definition of one function together with the namespaces which enclose it.
+		/// </summary>
+		struct Fragment
+		{
+			std::vector< const Namespace* > Path;
+			std::wstring Text;
+		};
+
+		/// <summary>
+		/// Writes out the declarations of the given collection to the declaration stream and collects their definitions, one fragment per function, descending into namespaces.
+		/// </summary>
+		/// <parameter name="declarations" IsConst="true">Declarations to write out.</parameter>
+		/// <parameter name="path">Namespaces enclosing the declarations, outermost first.</parameter>
+		/// <parameter name="declos">Stream which receives the declarations.</parameter>
+		/// <parameter name="pieces">Collection which receives the definitions.</parameter>
+		/// <IsConstMember value="true"/>
+		void fragments( const CodeCollection& declarations , std::vector< const Namespace* >& path , std::wostream& declos , std::vector< Fragment >& pieces ) const;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this compilation unit.
@@ -30,6 +57,53 @@ namespace CPlusPlusCodeProvider
 		/// <parameter IsConst="true" name="file">Name of the file for this compilation unit.</parameter>
 		CompilationUnit( const std::wstring& file );
 
+		/// <summary>
+		/// Copy constructs a compilation unit from a given one.
+		/// </summary>
+		/// <parameter IsConst="true" name="other">Other compilation unit to copy.</parameter>
+		CompilationUnit( const CompilationUnit& other );
+
+		/// <summary>
+		/// Constructs a compilation unit by taking over the declarations and comments of a given one.
+		/// </summary>
+		/// <parameter name="other">Other compilation unit whose contents are taken over.</parameter>
+		CompilationUnit( CompilationUnit&& other );
+
+		/// <summary>
+		/// Replaces contents of this compilation unit with a copy of a given one.
+		/// </summary>
+		/// <parameter IsConst="true" name="other">Other compilation unit to copy.</parameter>
+		/// <returns>This object with contents replaced by the given one.</returns>
+		CompilationUnit& operator = ( const CompilationUnit& other );
+
+		/// <summary>
+		/// Replaces contents of this compilation unit by taking over those of a given one.
+		/// </summary>
+		/// <parameter name="other">Other compilation unit whose contents are taken over.</parameter>
+		/// <returns>This object with contents replaced by the given one.</returns>
+		CompilationUnit& operator = ( CompilationUnit&& other );
+
+		/// <summary>
+		/// Gives up this compilation unit's reference to its arena.
+		/// </summary>
+		~CompilationUnit( );
+
+		/// <summary>
+		/// Provides access to the arena owned by this compilation unit, creating it on first use.
+		/// Nodes instantiated while a CodeArena::Scope for it is alive are allocated from it and its memory is returned in one shot once this compilation unit and all those nodes are gone.
+		/// </summary>
+		/// <returns>A reference to the arena owned by this compilation unit.</returns>
+		CodeArena& Arena( );
+
+		/// <summary>
+		/// Deep copies this compilation unit and all its declarations into a new arena owned by the copy.
+		/// References between nodes of this compilation unit are redirected to their copies, those to nodes outside it are kept as they are.
+		/// </summary>
+		/// <parameter IsConst="true" name="file">Name of the file for the cloned compilation unit.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>The cloned compilation unit.</returns>
+		CompilationUnit Clone( const std::wstring& file ) const;
+
 		/// <summary>
 		/// Provides access to all the declarations in this compilation unit.
 		/// </summary>
@@ -44,17 +118,53 @@ namespace CPlusPlusCodeProvider
 		std::wstring Name( ) const;
 
 		/// <summary>
-		/// Writes out this compilation unit to the file whose name was given in the constructor.
+		/// Writes out this compilation unit to the file whose name was given in the constructor, encoded as UTF-8.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		void write( ) const;
 
+		/// <summary>
+		/// Renders this compilation unit in memory and writes it out to its file only if the file does not already hold exactly that content, leaving its timestamp alone otherwise.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if the file was written, false if it was already up to date.</returns>
+		bool writeifchanged( ) const;
+
 		/// <summary>
 		/// Writes out this compilation unit to the given stream.
 		/// </summary>
 		/// <parameter name="os">Stream to output this compilation unit to.</parameter>
 		/// <IsConstMember value="true"/>
 		void write( std::wostream& os ) const;
+
+		/// <summary>
+		/// Writes out this compilation unit split across a header, a source file and a forward declaration header such as a _fwd.h, all in one pass.
+		/// The forward declaration header receives declarations of the classes, unions and enumerations with a fixed underlying type defined at namespace scope, enclosed in their namespaces.
+		/// </summary>
+		/// <parameter name="declos">Stream which receives the declarations.</parameter>
+		/// <parameter name="defos">Stream which receives the definitions.</parameter>
+		/// <parameter name="fwdos">Stream which receives the forward declarations.</parameter>
+		/// <IsConstMember value="true"/>
+		void write( std::wostream& declos , std::wostream& defos , std::wostream& fwdos ) const;
+
+		/// <summary>
+		/// Writes out this compilation unit split across a header and several source files which can be compiled in parallel.
+		/// Each function definition, out-of-line member functions included, is handed to the source file with the least output so far, largest first, so the source files come out of similar size.
+		/// Every source file includes the header and reopens the namespaces its definitions belong to.
+		/// </summary>
+		/// <parameter name="declos">Stream which receives the declarations.</parameter>
+		/// <parameter name="header" IsConst="true">Name by which the source files include the header.</parameter>
+		/// <parameter name="shards" IsConst="true">Streams which receive the definitions.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <exception ref="std::invalid_argument">Thrown when no stream is given for the definitions.</exception>
+		void write( std::wostream& declos , const std::wstring& header , const std::vector< std::wostream* >& shards ) const;
+
+		/// <summary>
+		/// Writes out this compilation unit to the given narrow stream, encoded as UTF-8.
+		/// </summary>
+		/// <parameter name="os">Stream to output this compilation unit to.</parameter>
+		/// <IsConstMember value="true"/>
+		void write( std::ostream& os ) const;
 	};
 }
 
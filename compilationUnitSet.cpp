@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include "compilationunitset.h"
+#include "dependencygraph.h"
+#include "namespace.h"
+#include "output.h"
+#include "preprocessor.h"
+
+using std::vector;
+using std::wstring;
+
+namespace CPlusPlusCodeProvider
+{
+	namespace
+	{
+		/// <summary>
+		/// Tells where a type which other compilation units may refer to is defined.
+		/// </summary>
+		struct Definition
+		{
+			std::size_t unit;
+			const CodeObject* type;
+			std::size_t scope;
+		};
+
+		typedef std::unordered_map< const CodeObject* , Definition > DefinitionMap;
+
+		void define( const CodeCollection& declarations , std::size_t unit , std::size_t scope , vector< vector< wstring > >& scopes , DefinitionMap& definitions )
+		{
+			for( CodeCollection::const_iterator iter = declarations.begin( ) ; iter != declarations.end( ) ; ++iter )
+				switch( ( *iter ) -> Kind( ) )
+				{
+				case NodeKind::Namespace:
+					{
+						const Namespace& space = static_cast< const Namespace& >( **iter );
+						if( space.Name( ).empty( ) )
+							break;
+						scopes.push_back( scopes[ scope ] );
+						scopes.back( ).push_back( space.Name( ) );
+						define( space.Declarations( ) , unit , scopes.size( ) - 1 , scopes , definitions );
+					}
+					break;
+				case NodeKind::Union:
+				case NodeKind::Enumeration:
+				case NodeKind::UserDefinedType:
+					{
+						Definition definition = { unit , iter -> pointer( ) , scope };
+						vector< const CodeObject* > types;
+						DependencyGraph::Nested( **iter , types );
+						for( vector< const CodeObject* >::const_iterator type = types.begin( ) ; type != types.end( ) ; ++type )
+							definitions.insert( std::make_pair( *type , definition ) );
+					}
+					break;
+				default:
+					break;
+				}
+		}
+
+		void refer( const CodeCollection& declarations , TypeReferenceCollection& references )
+		{
+			for( CodeCollection::const_iterator iter = declarations.begin( ) ; iter != declarations.end( ) ; ++iter )
+				if( ( *iter ) -> Kind( ) == NodeKind::Namespace )
+					refer( static_cast< const Namespace& >( **iter ).Declarations( ) , references );
+				else
+					DependencyGraph::References( **iter , references );
+		}
+
+		wstring forward( const Definition& definition , const vector< vector< wstring > >& scopes )
+		{
+			const vector< wstring >& path = scopes[ definition.scope ];
+			OutputStream os;
+			OutputBuffer& buffer = os.Buffer( );
+			for( std::size_t i = 0 ; i < path.size( ) ; ++i )
+			{
+				const wstring tab( i , FormattingData::IndentationCharacter );
+				buffer.Append( tab ).Append( L"namespace " ).Append( path[ i ] ).Append( L'\n' ).Append( tab ).Append( L"{\n" );
+			}
+			DependencyGraph::Declare( *definition.type , os , static_cast< unsigned long >( path.size( ) ) );
+			for( std::size_t i = path.size( ) ; i-- > 0 ; )
+				buffer.Append( wstring( i , FormattingData::IndentationCharacter ) ).Append( L"}\n" );
+			return os.str( );
+		}
+
+		wstring includename( const wstring& path , const wstring& root )
+		{
+			wstring name = path , prefix = root;
+			std::replace( name.begin( ) , name.end( ) , L'\\' , L'/' );
+			std::replace( prefix.begin( ) , prefix.end( ) , L'\\' , L'/' );
+			if( !prefix.empty( ) && prefix.back( ) != L'/' )
+				prefix += L'/';
+			if( !prefix.empty( ) && name.compare( 0 , prefix.size( ) , prefix ) == 0 )
+				name.erase( 0 , prefix.size( ) );
+			return name;
+		}
+
+		bool replaced( const CodeObject& object , const std::unordered_set< wstring >& includes )
+		{
+			return object.Kind( ) == NodeKind::PreprocessorDirective && static_cast< const PreprocessorDirective& >( object ).Type( ) == PreprocessorDirective::Include && includes.count( static_cast< const PreprocessorDirective& >( object ).Directive( ) ) != 0;
+		}
+
+		void prepend( CodeCollection& declarations , const CodeCollection& generated , const std::unordered_set< wstring >& includes )
+		{
+			// Includes of units in the set are generated afresh, so those already present are dropped whether they are still needed or not.
+			CodeCollection kept;
+			kept.reserve( declarations.size( ) );
+			for( CodeCollection::const_iterator iter = declarations.begin( ) ; iter != declarations.end( ) ; ++iter )
+				if( !replaced( **iter , includes ) )
+					kept.push_back( *iter );
+
+			// Only directives and snippets are generated, so only those already present are hashed to skip them.
+			typedef std::unordered_multimap< unsigned long long , const CodeObject* > HashIndex;
+			HashIndex existing;
+			for( CodeCollection::const_iterator iter = kept.begin( ) ; iter != kept.end( ) ; ++iter )
+				if( ( *iter ) -> Kind( ) == NodeKind::PreprocessorDirective || ( *iter ) -> Kind( ) == NodeKind::CodeSnippet )
+					existing.insert( std::make_pair( ( *iter ) -> Hash( ) , iter -> pointer( ) ) );
+
+			CodeCollection result;
+			result.reserve( kept.size( ) + generated.size( ) );
+			CodeCollection::const_iterator iter = kept.begin( );
+			for( ; iter != kept.end( ) && ( *iter ) -> Kind( ) == NodeKind::PreprocessorDirective ; ++iter )
+				result.push_back( *iter );
+			for( CodeCollection::const_iterator added = generated.begin( ) ; added != generated.end( ) ; ++added )
+			{
+				bool present = false;
+				std::pair< HashIndex::const_iterator , HashIndex::const_iterator > range = existing.equal_range( ( *added ) -> Hash( ) );
+				for( HashIndex::const_iterator candidate = range.first ; !present && candidate != range.second ; ++candidate )
+					present = candidate -> second -> Equals( **added );
+				if( !present )
+					result.push_back( *added );
+			}
+			for( ; iter != kept.end( ) ; ++iter )
+				result.push_back( *iter );
+			declarations = std::move( result );
+		}
+	}
+
+	CompilationUnit& CompilationUnitSet::Add( CompilationUnit&& unit )
+	{
+		units.push_back( std::move( unit ) );
+		return units.back( );
+	}
+
+	CompilationUnit& CompilationUnitSet::Add( const CompilationUnit& unit )
+	{
+		units.push_back( unit );
+		return units.back( );
+	}
+
+	void CompilationUnitSet::Reserve( std::size_t count )
+	{
+		units.reserve( count );
+	}
+
+	std::size_t CompilationUnitSet::Size( ) const
+	{
+		return units.size( );
+	}
+
+	CompilationUnit& CompilationUnitSet::operator[ ]( std::size_t index )
+	{
+		return units[ index ];
+	}
+
+	void CompilationUnitSet::WriteAll( unsigned int threads ) const
+	{
+		run( threads , [ ]( const CompilationUnit& unit ) { unit.write( ); } );
+	}
+
+	WriteSummary CompilationUnitSet::UpdateAll( unsigned int threads ) const
+	{
+		std::atomic< std::size_t > written( 0 );
+		run( threads , [ & ]( const CompilationUnit& unit )
+		{
+			if( unit.writeifchanged( ) )
+				++written;
+		} );
+
+		WriteSummary summary;
+		summary.Written = written;
+		summary.Skipped = units.size( ) - summary.Written;
+		return summary;
+	}
+
+	void CompilationUnitSet::ResolveIncludes( const wstring& root )
+	{
+		vector< vector< wstring > > scopes( 1 );
+		DefinitionMap definitions;
+		vector< wstring > names;
+		names.reserve( units.size( ) );
+		std::unordered_set< wstring > includes;
+		for( std::size_t unit = 0 ; unit < units.size( ) ; ++unit )
+		{
+			define( units[ unit ].Declarations( ) , unit , 0 , scopes , definitions );
+			names.push_back( L'"' + includename( units[ unit ].Name( ) , root ) + L'"' );
+			includes.insert( names.back( ) );
+			includes.insert( L'"' + units[ unit ].Name( ) + L'"' );
+		}
+
+		TypeReferenceCollection references;
+		for( std::size_t unit = 0 ; unit < units.size( ) ; ++unit )
+		{
+			references.clear( );
+			refer( units[ unit ].Declarations( ) , references );
+			vector< unsigned char > included( units.size( ) );
+			vector< const Definition* > forwards;
+			std::unordered_set< const CodeObject* > declared;
+			for( TypeReferenceCollection::const_iterator iter = references.begin( ) ; iter != references.end( ) ; ++iter )
+			{
+				DefinitionMap::const_iterator definition = definitions.find( iter -> Type );
+				if( definition == definitions.end( ) || definition -> second.unit == unit )
+					continue;
+				// Naming a nested type needs the definition of the type enclosing it.
+				if( iter -> Complete || definition -> second.type != iter -> Type || iter -> Type -> Kind( ) == NodeKind::Enumeration )
+					included[ definition -> second.unit ] = 1;
+				else if( declared.insert( definition -> second.type ).second )
+					forwards.push_back( &definition -> second );
+			}
+
+			CodeCollection generated;
+			for( std::size_t other = 0 ; other < units.size( ) ; ++other )
+				if( included[ other ] )
+					generated.push_back( shared_pointer< CodeObject >( PreprocessorDirective::Instantiate( names[ other ] , PreprocessorDirective::Include ) ) );
+			for( vector< const Definition* >::const_iterator iter = forwards.begin( ) ; iter != forwards.end( ) ; ++iter )
+				if( !included[ ( *iter ) -> unit ] )
+					generated.push_back( shared_pointer< CodeObject >( CodeSnippet::Instantiate( forward( **iter , scopes ) ) ) );
+			prepend( units[ unit ].Declarations( ) , generated , includes );
+		}
+	}
+
+	void CompilationUnitSet::run( unsigned int threads , const std::function< void( const CompilationUnit& ) >& action ) const
+	{
+		if( threads == 0 )
+			threads = std::thread::hardware_concurrency( );
+		if( threads == 0 )
+			threads = 1;
+		if( threads > units.size( ) )
+			threads = static_cast< unsigned int >( units.size( ) );
+
+		std::atomic< std::size_t > next( 0 );
+		std::exception_ptr failure;
+		std::mutex failure_lock;
+
+		auto worker = [ & ]( )
+		{
+			for( std::size_t i = next++ ; i < units.size( ) ; i = next++ )
+				try
+				{
+					action( units[ i ] );
+				}
+				catch( ... )
+				{
+					std::lock_guard< std::mutex > lock( failure_lock );
+					if( !failure )
+						failure = std::current_exception( );
+				}
+		};
+
+		vector< std::thread > pool;
+		if( threads > 1 )
+		{
+			pool.reserve( threads - 1 );
+			try
+			{
+				for( unsigned int i = 1 ; i < threads ; ++i )
+					pool.push_back( std::thread( worker ) );
+			}
+			catch( ... )
+			{
+				// Destroying a joinable thread terminates, so the threads already started are drained and joined first.
+				next = units.size( );
+				for( vector< std::thread >::iterator iter = pool.begin( ) ; iter != pool.end( ) ; ++iter )
+					iter -> join( );
+				throw;
+			}
+		}
+		worker( );
+		for( vector< std::thread >::iterator iter = pool.begin( ) ; iter != pool.end( ) ; ++iter )
+			iter -> join( );
+
+		if( failure )
+			std::rethrow_exception( failure );
+	}
+}
\ No newline at end of file
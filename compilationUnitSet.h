@@ -0,0 +1,96 @@
+#ifndef COMPILATIONUNITSET_HEADER
+#define COMPILATIONUNITSET_HEADER
+
+#include <functional>
+#include <vector>
+#include "compilationunit.h"
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// Tells how many compilation units a batch wrote out and how many it left alone because their files were up to date.
+	/// </summary>
+	struct WriteSummary
+	{
+		std::size_t Written;
+		std::size_t Skipped;
+	};
+
+	/// <summary>
+	/// Provides a batch of independent compilation units which are rendered concurrently.
+	/// </summary>
+	class CompilationUnitSet
+	{
+		std::vector< CompilationUnit > units;
+
+		/// <summary>
+		/// Applies the given action to every compilation unit in this set, using up to the given number of threads.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		void run( unsigned int threads , const std::function< void( const CompilationUnit& ) >& action ) const;
+	public:
+		/// <summary>
+		/// Adds a compilation unit to this set by taking over its contents.
+		/// </summary>
+		/// <parameter name="unit">Compilation unit to add.</parameter>
+		/// <returns>A reference to the compilation unit now held by this set.</returns>
+		CompilationUnit& Add( CompilationUnit&& unit );
+
+		/// <summary>
+		/// Adds a copy of a compilation unit to this set.
+		/// </summary>
+		/// <parameter IsConst="true" name="unit">Compilation unit to add.</parameter>
+		/// <returns>A reference to the compilation unit now held by this set.</returns>
+		CompilationUnit& Add( const CompilationUnit& unit );
+
+		/// <summary>
+		/// Reserves space for the given number of compilation units.
+		/// </summary>
+		/// <parameter name="count">Number of compilation units to reserve space for.</parameter>
+		void Reserve( std::size_t count );
+
+		/// <summary>
+		/// Returns the number of compilation units in this set.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Number of compilation units in this set.</returns>
+		std::size_t Size( ) const;
+
+		/// <summary>
+		/// Provides access to the compilation unit at the given position.
+		/// </summary>
+		/// <parameter name="index">Position of the compilation unit.</parameter>
+		/// <returns>A reference to the compilation unit at the given position.</returns>
+		CompilationUnit& operator[ ]( std::size_t index );
+
+		/// <summary>
+		/// Writes out every compilation unit in this set to its file, using up to the given number of threads.
+		/// Rendering does not modify the code model, so units sharing nodes may be written concurrently as long as nobody modifies them meanwhile.
+		/// If writing any unit throws, the remaining units are still written and the first exception is rethrown afterwards.
+		/// </summary>
+		/// <parameter name="threads">Maximum number of threads to use; 0 uses one thread per hardware thread.</parameter>
+		/// <IsConstMember value="true"/>
+		void WriteAll( unsigned int threads = 0 ) const;
+
+		/// <summary>
+		/// Writes out only those compilation units whose files do not already hold their rendered content, using up to the given number of threads.
+		/// Unchanged files keep their timestamps, so builds depending on them are not triggered. Exceptions are handled as in WriteAll.
+		/// </summary>
+		/// <parameter name="threads">Maximum number of threads to use; 0 uses one thread per hardware thread.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>Number of compilation units written and skipped.</returns>
+		WriteSummary UpdateAll( unsigned int threads = 0 ) const;
+
+		/// <summary>
+		/// Adds to every compilation unit in this set the includes and forward declarations it needs for the types defined in the other ones.
+		/// A unit whose type is needed in full, as a base, a member held by value or an enclosing type, is included with its name in quotes. A type which is only referred to through pointers, references, parameters or return types is forward declared instead, unless its unit is included anyway.
+		/// They are placed after the preprocessor directives a unit starts with, those already present in a unit are not added again.
+		/// Includes of units in this set which a unit already has are dropped unless they are still needed, whether they name the unit by its file name or relative to the include root.
+		/// </summary>
+		/// <parameter IsConst="true" name="root">Directory the generated includes are relative to; file names outside of it are included as they are.</parameter>
+		/// <remarks>Types in unnamed namespaces are local to their unit. Enumerations cannot be forward declared, so their units are always included.</remarks>
+		void ResolveIncludes( const std::wstring& root = std::wstring( ) );
+	};
+}
+
+#endif
\ No newline at end of file
@@ -15,6 +15,11 @@ namespace CPlusPlusCodeProvider
 	{
 	}
 
+	void DeclaratorSpecifier::remap( const CloneScope& scope )
+	{
+		scope.Remap( type );
+	}
+
 	bool DeclaratorSpecifier::Static( ) const
 	{
 		return is_static;
@@ -25,6 +30,7 @@ namespace CPlusPlusCodeProvider
 		is_static = val;
 		if( val )
 			is_extern = false;
+		cache.Invalidate( );
 		return *this;
 	}
 
@@ -36,12 +42,14 @@ namespace CPlusPlusCodeProvider
 	DeclaratorSpecifier& DeclaratorSpecifier::Volatile( bool val )
 	{
 		is_volatile = val;
+		cache.Invalidate( );
 		return *this;
 	}
 
 	DeclaratorSpecifier& DeclaratorSpecifier::Constant( bool flag )
 	{
 		is_constant = flag;
+		cache.Invalidate( );
 		return *this;
 	}
 
@@ -60,6 +68,7 @@ namespace CPlusPlusCodeProvider
 		is_extern = val;
 		if( val )
 			is_static = false;
+		cache.Invalidate( );
 		return *this;
 	}
 
@@ -70,14 +79,27 @@ namespace CPlusPlusCodeProvider
 
 	void DeclaratorSpecifier::write( wostream& os ) const
 	{
+		cache.Track( );
 		if( is_constant )
 			os << "const ";
 		if( is_volatile )
 			os << "volatile ";
 		
-		const nestabletype* udt = dynamic_cast< nestabletype* >( type );
+		const nestabletype* udt = 0;
+		switch( type -> Kind( ) )
+		{
+		case NodeKind::Union:
+			udt = static_cast< const Union* >( type );
+			break;
+		case NodeKind::UserDefinedType:
+			udt = static_cast< const UserDefinedType* >( type );
+			break;
+		}
+		// Only the name of the type is written out, renaming it still has to discard renderings of the declaration.
+		type -> track( );
+		CodeObject::refer( *type );
 
-		if( udt && dynamic_cast< const Enumeration* >( udt ) == 0 )
+		if( udt )
 		{
 			udt -> writetemplateattributes( os );
 			os << type -> Name( ) << L' ';
@@ -90,10 +112,11 @@ namespace CPlusPlusCodeProvider
 	Declarator& Declarator::Name( const wstring& str )
 	{
 		name = str;
+		cache.Invalidate( );
 		return *this;
 	}
 
-	wstring Declarator::Name( ) const
+	const wstring& Declarator::Name( ) const
 	{
 		return name;
 	}
@@ -106,12 +129,14 @@ namespace CPlusPlusCodeProvider
 	Declarator& Declarator::Volatile( bool val )
 	{
 		is_volatile	= val && level;
+		cache.Invalidate( );
 		return *this;
 	}
 
 	Declarator& Declarator::Constant( bool flag )
 	{
 		is_constant = flag && level;
+		cache.Invalidate( );
 		return *this;
 	}
 
@@ -128,6 +153,7 @@ namespace CPlusPlusCodeProvider
 	Declarator& Declarator::Reference( bool val )
 	{
 		is_reference = val && !indices -> size( );
+		cache.Invalidate( );
 		return *this;
 	}
 
@@ -139,6 +165,7 @@ namespace CPlusPlusCodeProvider
 	Declarator& Declarator::IndirectionLevel( unsigned int val )
 	{
 		level = val;
+		cache.Invalidate( );
 		return *this;
 	}
 
@@ -156,7 +183,7 @@ namespace CPlusPlusCodeProvider
 		: name( other.name ) , is_reference( other.is_reference ) , is_constant( other.is_constant ) , is_volatile( other.is_volatile ) , level( other.level ) , indices( new IntegerCollection( *other.indices ) ) , has_initializer( other.has_initializer )
 	{
 		if( other.has_initializer )
-			initializer.reset( new copying_pointer< Expression >( static_cast< Expression* >( &( *other.initializer ) -> Duplicate( ) ) ) );
+			initializer.reset( new copying_pointer< Expression >( *other.initializer ) );
 	}
 
 	Declarator& Declarator::operator = ( const Declarator& other )
@@ -164,8 +191,8 @@ namespace CPlusPlusCodeProvider
 		if( this != &other )
 		{
 			name = other.name , is_reference = other.is_reference , is_constant = other.is_constant , is_volatile = other.is_volatile , level = other.level , indices.reset( new IntegerCollection( *other.indices ) ) , has_initializer = other.has_initializer;
-		if( other.has_initializer )
-			initializer.reset( new copying_pointer< Expression >( static_cast< Expression* >( &( *other.initializer ) -> Duplicate( ) ) ) );
+			initializer.reset( other.has_initializer ? new copying_pointer< Expression >( *other.initializer ) : 0 );
+			cache.Invalidate( );
 		}
 		return *this;
 	}
@@ -182,13 +209,20 @@ namespace CPlusPlusCodeProvider
 
 	Declarator& Declarator::Initializer( const copying_pointer< Expression >& expr )
 	{
-		initializer.reset( new copying_pointer< Expression >( static_cast< Expression* >( &expr -> Duplicate( ) ) ) );
+		initializer.reset( new copying_pointer< Expression >( expr ) );
 		has_initializer = true;
+		cache.Invalidate( );
 		return *this;
 	}
 
 	void Declarator::write( wostream& os ) const
 	{
+		write( os , true , has_initializer );
+	}
+
+	void Declarator::write( wostream& os , bool named , bool initialized ) const
+	{
+		cache.Track( );
 		os << wstring( level , L'*' );
 		if( is_reference )
 			os << L'&';
@@ -198,23 +232,26 @@ namespace CPlusPlusCodeProvider
 			os << L"const ";
 		if( is_volatile )
 			os << L"volatile ";
-		os << name;
-		if( indices -> size( ) )
+		if( named )
+			os << name;
+		const IntegerCollection& dimensions = *indices;
+		if( dimensions.size( ) )
 		{
-			IntegerCollection::const_iterator iter = indices -> begin( );
+			IntegerCollection::const_iterator iter = dimensions.begin( );
 			os << L" [ " << *iter << L" ]";
-			for( ++iter ; iter != indices -> end( ) ; ++iter )
+			for( ++iter ; iter != dimensions.end( ) ; ++iter )
 				os << L"[ " << *iter << L" ]";
 		}
-		if( has_initializer )
+		if( initialized && has_initializer )
 		{ 
+			const copying_pointer< Expression >& value = *initializer;
 			os << L" = ";
-			( *initializer ) -> write( os , 0 );
+			value -> write( os , 0 );
 		}
 	}
 
 	Declaration::Declaration( Type& specifier )
-		: type( specifier ) , comment( Comment::Instantiate( ) )
+		: type( specifier )
 	{
 	}
 
@@ -222,6 +259,11 @@ namespace CPlusPlusCodeProvider
 	{
 	}
 
+	void Declaration::remap( const CloneScope& scope )
+	{
+		type.remap( scope );
+	}
+
 	void Declaration::Assign( const Declaration& other , bool )
 	{
 		type = other.type;
@@ -229,7 +271,7 @@ namespace CPlusPlusCodeProvider
 
 	Comment& Declaration::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	const Comment& Declaration::Comment( ) const
@@ -237,6 +279,13 @@ namespace CPlusPlusCodeProvider
 		return *comment;
 	}
 
+	void Declaration::writecomment( wostream& os , unsigned long tabs ) const
+	{
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
+			os << L'\n';
+	}
+
 	DeclaratorSpecifier& Declaration::Specifier( )
 	{
 		return type;
@@ -249,8 +298,8 @@ namespace CPlusPlusCodeProvider
 
 	void Declaration::writetext( wostream& os , unsigned long tabs ) const
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n' << wstring( tabs , FormattingData::IndentationCharacter );
 		type.write( os );
 	}
@@ -265,12 +314,14 @@ namespace CPlusPlusCodeProvider
 		const VariableDeclaration& ref = cast< VariableDeclaration >( other );
 		Declaration::Assign( ref , true );
 		declarator = ref.declarator;
+		Invalidate( );
 		return *this;
 	}
 
 	VariableDeclaration::VariableDeclaration( Type& specifier , const wstring& variable )
 		: Declaration( specifier ) , declarator( variable )
 	{
+		tag( NodeKind::VariableDeclaration );
 	}
 
 	const Declarator& VariableDeclaration::Declarator( ) const
@@ -289,6 +340,13 @@ namespace CPlusPlusCodeProvider
 		declarator.write( os );
 	}
 
+	void VariableDeclaration::writeasreturntype( wostream& os ) const
+	{
+		track( );
+		Declaration::writetext( os , 0 );
+		declarator.write( os , false , declarator.has_initializer );
+	}
+
 	void VariableDeclaration::writetext( wostream& declos , wostream& , unsigned long , unsigned long deftabs ) const
 	{
 		throw FunctionNotImplementedException( "This function has not been implemented yet." );
@@ -300,25 +358,19 @@ namespace CPlusPlusCodeProvider
 
 	void VariableDeclaration::declaration( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , 0 );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		track( );
+		writecomment( os , 0 );
 		os << wstring( tabs , FormattingData::IndentationCharacter );
 		if( Specifier( ).Static( ) )
 			os << L"static ";
 		Specifier( ).write( os );
-		bool flag = declarator.has_initializer;
-		declarator.has_initializer = false;
-		declarator.write( os );
-		declarator.has_initializer = flag;
+		declarator.write( os , true , false );
 		os << L";";
 	}
 
 	void VariableDeclaration::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		os << wstring( tabs , FormattingData::IndentationCharacter );
 		if( Specifier( ).Static( ) )
 			os << L"static ";
@@ -339,6 +391,7 @@ namespace CPlusPlusCodeProvider
 		const VariableDeclarationList& ref = cast< VariableDeclarationList >( object );
 		Declaration::Assign( ref , true );
 		declarators.reset( new DeclaratorList( *ref.declarators ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -347,9 +400,15 @@ namespace CPlusPlusCodeProvider
 		return *declarators;
 	}
 
+	const DeclaratorList& VariableDeclarationList::Declarators( ) const
+	{
+		return *declarators;
+	}
+
 	VariableDeclarationList::VariableDeclarationList( Type& name )
 		: Declaration( name ) , declarators( new DeclaratorList )
 	{
+		tag( NodeKind::VariableDeclarationList );
 	}
 
 	VariableDeclarationList::VariableDeclarationList( const VariableDeclarationList& other )
@@ -364,16 +423,15 @@ namespace CPlusPlusCodeProvider
 
 	void VariableDeclarationList::writetext( wostream& os , unsigned long tabs ) const
 	{
-		if( declarators -> size( ) )
+		const DeclaratorList& list = *declarators;
+		if( list.size( ) )
 		{
-			Comment( ).write( os , tabs );
-			if( !Comment( ).IsEmpty( ) )
-				os << L'\n';
+			writecomment( os , tabs );
 			os << wstring( tabs , FormattingData::IndentationCharacter );
 			Specifier( ).write( os );
-			DeclaratorList::const_iterator iter = declarators -> begin( );
+			DeclaratorList::const_iterator iter = list.begin( );
 			iter -> write( os );
-			for( ++iter ; iter != declarators -> end( ) ; ++iter )
+			for( ++iter ; iter != list.end( ) ; ++iter )
 			{
 				os << L" , ";
 				iter -> write( os );
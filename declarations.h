@@ -11,8 +11,18 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class DeclaratorSpecifier
 	{
+		friend class Snapshot;
 		Type* type;
 		bool is_constant , is_volatile , is_static , is_extern;
+		RenderCache cache;
+
+		friend class Declaration;
+
+		/// <summary>
+		/// Redirects the type to its copy if it was cloned along with the owning declaration.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied the owning declaration.</parameter>
+		void remap( const CloneScope& scope );
 	public:
 		/// <summary>
 		/// Constructs a new declarator given it's type.
@@ -96,14 +106,25 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Declarator
 	{
-		std::wstring name;
+		friend class Snapshot;
+		Identifier name;
 		bool is_reference , is_constant , is_volatile;
-		mutable bool has_initializer;
+		bool has_initializer;
 		unsigned int level;
 		std::auto_ptr< IntegerCollection > indices;
 		std::auto_ptr< copying_pointer< Expression > > initializer;
+		RenderCache cache;
 
 		friend class VariableDeclaration;
+
+		/// <summary>
+		/// Outputs this declarator to the given stream, optionally leaving out its name and initializer.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <parameter name="os">Output stream which receives this declarator.</parameter>
+		/// <parameter name="named">True to write out the name of this declarator.</parameter>
+		/// <parameter name="initialized">True to write out the initializer of this declarator, if any.</parameter>
+		void write( std::wostream& os , bool named , bool initialized ) const;
 	public:
 		/// <summary>
 		/// Tells whether this declarator has an initializer expression associated with it or not.
@@ -133,8 +154,8 @@ namespace CPlusPlusCodeProvider
 		/// Gets name of the variable.
 		/// </summary>
 		/// <IsConstMember value="true"/>
-		/// <returns>Returns name of this variable.</returns>
-		std::wstring Name( ) const;
+		/// <returns>Returns name of this variable, which stays valid for the lifetime of the process.</returns>
+		const std::wstring& Name( ) const;
 
 		/// <summary>
 		/// Returns whether the variable is a reference or not.
@@ -223,8 +244,9 @@ namespace CPlusPlusCodeProvider
 
 	class Declaration : public CodeObject
 	{
+		friend class Snapshot;
 		DeclaratorSpecifier type;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this variable declaration.
@@ -253,6 +275,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A DeclaratorSpecifier for this declaration.</returns>
 		DeclaratorSpecifier& Specifier( );
 	protected:
+		/// <summary>
+		/// Redirects the declared type to its copy if it was cloned along with this declaration.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		Declaration( Type& specifier );
 		~Declaration( ) = 0;
 
@@ -265,6 +293,14 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this Declaration</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& os , unsigned long tabs ) const;
+
+		/// <summary>
+		/// Writes out the comment applied to this declaration followed by a line break, nothing is written if there is no comment.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for the comment.</parameter>
+		/// <IsConstMember value="true"/>
+		void writecomment( std::wostream& os , unsigned long tabs ) const;
 	};
 
 	/// <summary>
@@ -272,6 +308,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class VariableDeclaration : public Declaration
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		Declarator declarator;
 	public:
 		/// <summary>
@@ -313,6 +352,13 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		void writeasparameter( std::wostream& os ) const;
 
+		/// <summary>
+		/// Writes out this declaration as the return type of a function, that is, without the declarator's name.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <IsConstMember value="true"/>
+		void writeasreturntype( std::wostream& os ) const;
+
 		void declaration( std::wostream& os , unsigned long tabs ) const;
 	protected:
 		/// <summary>
@@ -346,6 +392,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class VariableDeclarationList : public Declaration
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::auto_ptr< DeclaratorList > declarators;
 	public:
 		/// <summary>
@@ -375,6 +424,12 @@ namespace CPlusPlusCodeProvider
 		/// </summary>
 		/// <returns>A DeclaratorList for this declaration.</returns>
 		DeclaratorList& Declarators( );
+		/// <summary>
+		/// Returns the list of declarators for this variable declaration.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A DeclaratorList for this declaration.</returns>
+		const DeclaratorList& Declarators( ) const;
 	protected:
 		/// <summary>
 		/// Constructs a new VariableDeclaration from its specifier.
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include "dependencygraph.h"
+#include "declarations.h"
+#include "functions.h"
+#include "types.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::size_t;
+	using std::vector;
+	using std::wostream;
+	using std::wstring;
+
+	namespace
+	{
+		const size_t unvisited = static_cast< size_t >( -1 );
+
+		template< typename T > bool defined( const T& member , bool separate )
+		{
+			if( member.Inline( ) && !member.Pure( ) )
+				return true;
+			return separate && member.ForceBody( );
+		}
+	}
+
+	DependencyGraph::DependencyGraph( )
+	{
+	}
+
+	void DependencyGraph::add( const CodeObject* declaration )
+	{
+		declarations.push_back( declaration );
+		if( declaration )
+			switch( declaration -> Kind( ) )
+			{
+			case NodeKind::Union:
+			case NodeKind::Enumeration:
+			case NodeKind::UserDefinedType:
+				{
+					positions.push_back( declarations.size( ) - 1 );
+					vector< const CodeObject* > types;
+					Nested( *declaration , types );
+					for( vector< const CodeObject* >::const_iterator iter = types.begin( ) ; iter != types.end( ) ; ++iter )
+						vertices.insert( std::make_pair( *iter , positions.size( ) - 1 ) );
+				}
+				break;
+			default:
+				break;
+			}
+	}
+
+	void DependencyGraph::references( const CodeObject* type , bool separate , TypeReferenceCollection& references )
+	{
+		switch( type -> Kind( ) )
+		{
+		case NodeKind::Union:
+			{
+				const Union& u = *static_cast< const Union* >( type );
+				for( MemberVariableCollection::const_iterator iter = u.membervariables -> begin( ) ; iter != u.membervariables -> end( ) ; ++iter )
+					DependencyGraph::references( *std::get< 0 >( *iter ) , !std::get< 0 >( *iter ) -> Specifier( ).Static( ) , references );
+				for( MemberFunctionCollection::const_iterator iter = u.memberfunctions -> begin( ) ; iter != u.memberfunctions -> end( ) ; ++iter )
+					DependencyGraph::references( static_cast< const Callable& >( **iter ) , separate || ( *iter ) -> Inline( ) , references );
+				for( MemberOperatorCollection::const_iterator iter = u.memberoperators -> begin( ) ; iter != u.memberoperators -> end( ) ; ++iter )
+					DependencyGraph::references( static_cast< const Callable& >( **iter ) , separate || ( *iter ) -> Inline( ) , references );
+			}
+			break;
+		case NodeKind::UserDefinedType:
+			{
+				const UserDefinedType& udt = *static_cast< const UserDefinedType* >( type );
+				for( BaseTypeCollection::const_iterator iter = udt.bases -> begin( ) ; iter != udt.bases -> end( ) ; ++iter )
+				{
+					TypeReference base = { &iter -> Type( ) , true };
+					references.push_back( base );
+				}
+				for( MemberVariableCollection::const_iterator iter = udt.membervariables -> begin( ) ; iter != udt.membervariables -> end( ) ; ++iter )
+					DependencyGraph::references( *std::get< 0 >( *iter ) , !std::get< 0 >( *iter ) -> Specifier( ).Static( ) , references );
+				for( ConstructorCollection::const_iterator iter = udt.constructors -> begin( ) ; iter != udt.constructors -> end( ) ; ++iter )
+					DependencyGraph::references( static_cast< const Callable& >( **iter ) , separate || ( *iter ) -> Inline( ) , references );
+				for( MemberFunctionCollection::const_iterator iter = udt.memberfunctions -> begin( ) ; iter != udt.memberfunctions -> end( ) ; ++iter )
+					DependencyGraph::references( static_cast< const Callable& >( **iter ) , defined( **iter , separate ) , references );
+				for( MemberOperatorCollection::const_iterator iter = udt.memberoperators -> begin( ) ; iter != udt.memberoperators -> end( ) ; ++iter )
+					DependencyGraph::references( static_cast< const Callable& >( **iter ) , defined( **iter , separate ) , references );
+				for( NestedTypeCollection::const_iterator iter = udt.memberuserdefinedtypes -> begin( ) ; iter != udt.memberuserdefinedtypes -> end( ) ; ++iter )
+					DependencyGraph::references( iter -> first.pointer( ) , separate , references );
+				for( MemberUnionCollection::const_iterator iter = udt.memberunions -> begin( ) ; iter != udt.memberunions -> end( ) ; ++iter )
+					DependencyGraph::references( iter -> first.pointer( ) , separate , references );
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	void DependencyGraph::references( const Callable& function , bool body , TypeReferenceCollection& references )
+	{
+		const ParameterCollection& parameters = *function.argumentlist;
+		for( ParameterCollection::const_iterator iter = parameters.begin( ) ; iter != parameters.end( ) ; ++iter )
+			DependencyGraph::references( **iter , body , references );
+		if( const copying_pointer< VariableDeclaration >* result = function.ReturnType( ) )
+			DependencyGraph::references( **result , body , references );
+	}
+
+	void DependencyGraph::references( const VariableDeclaration& variable , bool complete , TypeReferenceCollection& references )
+	{
+		const Declarator& declarator = variable.Declarator( );
+		TypeReference reference = { &variable.Specifier( ).Type( ) , complete && !declarator.Reference( ) && !declarator.IndirectionLevel( ) };
+		references.push_back( reference );
+	}
+
+	void DependencyGraph::depend( size_t vertex , const CodeObject* type , bool complete )
+	{
+		std::unordered_map< const CodeObject* , size_t >::const_iterator iter = vertices.find( type );
+		if( iter == vertices.end( ) || iter -> second == vertex )
+			return;
+		// Naming a nested type needs the definition of the type enclosing it, and an enumeration can not be declared ahead of its definition in general.
+		Edge edge = { iter -> second , complete || declarations[ positions[ iter -> second ] ] != type || type -> Kind( ) == NodeKind::Enumeration };
+		edges[ vertex ].push_back( edge );
+	}
+
+	void DependencyGraph::emit( size_t vertex , vector< unsigned char >& emitted , EmissionOrder& order ) const
+	{
+		// Types referred to before they are defined are declared ahead of the first reference.
+		for( vector< Edge >::const_iterator iter = edges[ vertex ].begin( ) ; iter != edges[ vertex ].end( ) ; ++iter )
+			if( !emitted[ iter -> target ] )
+			{
+				emitted[ iter -> target ] = 1;
+				Emission forward = { declarations[ positions[ iter -> target ] ] , positions[ iter -> target ] , true };
+				order.push_back( forward );
+			}
+		emitted[ vertex ] = 1;
+		Emission definition = { declarations[ positions[ vertex ] ] , positions[ vertex ] , false };
+		order.push_back( definition );
+	}
+
+	EmissionOrder DependencyGraph::order( )
+	{
+		size_t count = positions.size( );
+		edges.resize( count );
+		TypeReferenceCollection dependencies;
+		for( size_t vertex = 0 ; vertex < count ; ++vertex )
+		{
+			dependencies.clear( );
+			references( declarations[ positions[ vertex ] ] , false , dependencies );
+			for( TypeReferenceCollection::const_iterator iter = dependencies.begin( ) ; iter != dependencies.end( ) ; ++iter )
+				depend( vertex , iter -> Type , iter -> Complete );
+		}
+
+		// Tarjan's algorithm over the definitions types need completes each type after those whose definitions it needs, references which only need declarations are left to forward declarations.
+		// A cycle found this way is of types which need each other's definitions.
+		vector< size_t > index( count , unvisited ) , low( count ) , stack , component;
+		vector< unsigned char > onstack( count ) , emitted( count );
+		vector< std::pair< size_t , size_t > > calls;
+		EmissionOrder types;
+		size_t counter = 0;
+		for( size_t root = 0 ; root < count ; ++root )
+		{
+			if( index[ root ] != unvisited )
+				continue;
+			index[ root ] = low[ root ] = counter++;
+			stack.push_back( root );
+			onstack[ root ] = 1;
+			calls.push_back( std::make_pair( root , 0 ) );
+			while( !calls.empty( ) )
+			{
+				size_t vertex = calls.back( ).first;
+				if( calls.back( ).second < edges[ vertex ].size( ) )
+				{
+					const Edge& edge = edges[ vertex ][ calls.back( ).second++ ];
+					if( !edge.complete )
+						continue;
+					size_t target = edge.target;
+					if( index[ target ] == unvisited )
+					{
+						index[ target ] = low[ target ] = counter++;
+						stack.push_back( target );
+						onstack[ target ] = 1;
+						calls.push_back( std::make_pair( target , 0 ) );
+					}
+					else if( onstack[ target ] )
+						low[ vertex ] = std::min( low[ vertex ] , index[ target ] );
+					continue;
+				}
+				calls.pop_back( );
+				if( !calls.empty( ) )
+					low[ calls.back( ).first ] = std::min( low[ calls.back( ).first ] , low[ vertex ] );
+				if( low[ vertex ] != index[ vertex ] )
+					continue;
+				component.clear( );
+				size_t member;
+				do
+				{
+					member = stack.back( );
+					stack.pop_back( );
+					onstack[ member ] = 0;
+					component.push_back( member );
+				}
+				while( member != vertex );
+				// No order gives types which need each other's definitions what they need, so they keep the order of the collection and the compiler reports the incomplete types.
+				std::sort( component.begin( ) , component.end( ) );
+				for( vector< size_t >::const_iterator iter = component.begin( ) ; iter != component.end( ) ; ++iter )
+					emit( *iter , emitted , types );
+			}
+		}
+
+		// Types take the positions of types in the collection, each preceded by the forward declarations it needs.
+		EmissionOrder result;
+		result.reserve( declarations.size( ) + types.size( ) - count );
+		EmissionOrder::const_iterator next = types.begin( );
+		vector< size_t >::const_iterator slot = positions.begin( );
+		for( size_t position = 0 ; position < declarations.size( ) ; ++position )
+			if( slot != positions.end( ) && *slot == position )
+			{
+				++slot;
+				while( next -> Forward )
+					result.push_back( *next++ );
+				result.push_back( *next++ );
+			}
+			else
+			{
+				Emission declaration = { declarations[ position ] , position , false };
+				result.push_back( declaration );
+			}
+		return result;
+	}
+
+	void DependencyGraph::Declare( const CodeObject& type , wostream& os , unsigned long tabs )
+	{
+		switch( type.Kind( ) )
+		{
+		case NodeKind::Union:
+			static_cast< const Union& >( type ).declaration( os , tabs );
+			break;
+		case NodeKind::UserDefinedType:
+			static_cast< const UserDefinedType& >( type ).declaration( os , tabs );
+			break;
+		default:
+			break;
+		}
+	}
+
+	void DependencyGraph::Nested( const CodeObject& type , vector< const CodeObject* >& types )
+	{
+		types.push_back( &type );
+		if( type.Kind( ) != NodeKind::UserDefinedType )
+			return;
+		const UserDefinedType& udt = static_cast< const UserDefinedType& >( type );
+		for( NestedTypeCollection::const_iterator iter = udt.memberuserdefinedtypes -> begin( ) ; iter != udt.memberuserdefinedtypes -> end( ) ; ++iter )
+			Nested( *iter -> first , types );
+		for( MemberUnionCollection::const_iterator iter = udt.memberunions -> begin( ) ; iter != udt.memberunions -> end( ) ; ++iter )
+			Nested( *iter -> first , types );
+		for( MemberEnumerationCollection::const_iterator iter = udt.memberenumerations -> begin( ) ; iter != udt.memberenumerations -> end( ) ; ++iter )
+			Nested( *iter -> first , types );
+	}
+
+	void DependencyGraph::References( const CodeObject& declaration , TypeReferenceCollection& references )
+	{
+		switch( declaration.Kind( ) )
+		{
+		case NodeKind::Union:
+		case NodeKind::UserDefinedType:
+			DependencyGraph::references( &declaration , true , references );
+			break;
+		case NodeKind::Function:
+		case NodeKind::Operator:
+			DependencyGraph::references( static_cast< const Callable& >( static_cast< const Function& >( declaration ) ) , true , references );
+			break;
+		case NodeKind::VariableDeclaration:
+			{
+				const VariableDeclaration& variable = static_cast< const VariableDeclaration& >( declaration );
+				DependencyGraph::references( variable , !variable.Specifier( ).Extern( ) , references );
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
\ No newline at end of file
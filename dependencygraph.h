@@ -0,0 +1,177 @@
+#ifndef DEPENDENCYGRAPH_HEADER
+#define DEPENDENCYGRAPH_HEADER
+
+#include <cstddef>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "cppcodeprovider.h"
+#include "collections.h"
+
+namespace CPlusPlusCodeProvider
+{
+	class Callable;
+	class UserDefinedType;
+	class VariableDeclaration;
+
+	/// <summary>
+	/// Describes one step in writing out a collection of declarations, either a declaration itself or a forward declaration of a type.
+	/// </summary>
+	struct Emission
+	{
+		/// <summary>
+		/// Declaration to write out.
+		/// </summary>
+		const CodeObject* Node;
+		/// <summary>
+		/// Position of the declaration in its collection.
+		/// </summary>
+		std::size_t Position;
+		/// <summary>
+		/// True if only a forward declaration of the type has to be written out at this point, its definition follows later.
+		/// </summary>
+		bool Forward;
+	};
+
+	typedef std::vector< Emission > EmissionOrder;
+
+	/// <summary>
+	/// Describes a type which a declaration refers to.
+	/// </summary>
+	struct TypeReference
+	{
+		/// <summary>
+		/// Type referred to.
+		/// </summary>
+		const CodeObject* Type;
+		/// <summary>
+		/// True if the definition of the type is needed, false if a declaration suffices.
+		/// </summary>
+		bool Complete;
+	};
+
+	typedef std::vector< TypeReference > TypeReferenceCollection;
+
+	/// <summary>
+	/// Orders a collection of declarations so that every type is defined after the types it depends upon.
+	/// A type needs the definitions of its bases, of the types of its non-static member variables held by value and of the types its member functions written inside it take or return by value, and at least the declarations of the types it refers to otherwise, through pointers, references, static members, parameters and return types.
+	/// Dependencies of nested types count as those of their outermost type, declarations which are not types keep their positions and types fill the positions of types in the collection.
+	/// </summary>
+	/// <remarks>Ordering takes time linear in the number of types and dependencies. Only the definitions a type needs move types ahead of it, types which are already in order keep their positions and a type referred to before it is defined is declared ahead of the reference. Types which need each other's definitions, which no order satisfies, keep the order of the collection.</remarks>
+	class DependencyGraph
+	{
+		/// <summary>
+		/// A dependency of one type upon another.
+		/// </summary>
+		struct Edge
+		{
+			std::size_t target;
+			bool complete;
+		};
+
+		std::vector< const CodeObject* > declarations;
+		std::vector< std::size_t > positions;
+		std::unordered_map< const CodeObject* , std::size_t > vertices;
+		std::vector< std::vector< Edge > > edges;
+
+		DependencyGraph( );
+		DependencyGraph( const DependencyGraph& );
+		DependencyGraph& operator = ( const DependencyGraph& );
+
+		static const CodeObject* node( const shared_pointer< CodeObject >& declaration )
+		{
+			return declaration.pointer( );
+		}
+
+		template< typename T > static const CodeObject* node( const std::pair< copying_pointer< T > , AccessRestrictions >& member )
+		{
+			return member.first.pointer( );
+		}
+
+		/// <summary>
+		/// Adds the declaration at the next position, as a vertex if it is a type.
+		/// </summary>
+		/// <parameter name="declaration" IsConst="true">Declaration to add, may be null.</parameter>
+		void add( const CodeObject* declaration );
+		/// <summary>
+		/// Adds the types referred to by a type and the types nested in it.
+		/// </summary>
+		/// <parameter name="type" IsConst="true">Type whose references are added.</parameter>
+		/// <parameter name="separate">True if the bodies of member functions written out of the type need the definitions of their types as well.</parameter>
+		/// <parameter name="references">List which receives the references.</parameter>
+		static void references( const CodeObject* type , bool separate , TypeReferenceCollection& references );
+		/// <summary>
+		/// Adds the types referred to by a function's parameters and return type.
+		/// </summary>
+		/// <parameter name="function" IsConst="true">Function whose references are added.</parameter>
+		/// <parameter name="body">True if the function is written out with its body, in which case the types it takes and returns by value are needed in full.</parameter>
+		/// <parameter name="references">List which receives the references.</parameter>
+		static void references( const Callable& function , bool body , TypeReferenceCollection& references );
+		/// <summary>
+		/// Adds the type of a variable declaration.
+		/// </summary>
+		/// <parameter name="variable" IsConst="true">Declaration of the variable.</parameter>
+		/// <parameter name="complete">True if the type is needed in full unless the variable is a pointer or a reference.</parameter>
+		/// <parameter name="references">List which receives the references.</parameter>
+		static void references( const VariableDeclaration& variable , bool complete , TypeReferenceCollection& references );
+		/// <summary>
+		/// Adds a dependency upon the given type to the given vertex if it is one of the types being ordered.
+		/// </summary>
+		/// <parameter name="vertex">Vertex which depends upon the type.</parameter>
+		/// <parameter name="type" IsConst="true">Type depended upon.</parameter>
+		/// <parameter name="complete">True if the definition of the type is needed, false if a declaration suffices.</parameter>
+		void depend( std::size_t vertex , const CodeObject* type , bool complete );
+		/// <summary>
+		/// Adds the definition of a type to the given list, preceded by forward declarations of the types it refers to which have not been declared or defined yet.
+		/// </summary>
+		/// <parameter name="vertex">Vertex of the type.</parameter>
+		/// <parameter name="emitted">Marks the vertices which have been declared or defined so far.</parameter>
+		/// <parameter name="order">List which receives the emissions.</parameter>
+		void emit( std::size_t vertex , std::vector< unsigned char >& emitted , EmissionOrder& order ) const;
+		/// <summary>
+		/// Returns the order in which the declarations added so far have to be written out.
+		/// </summary>
+		/// <returns>Emissions for all the declarations.</returns>
+		EmissionOrder order( );
+	public:
+		/// <summary>
+		/// Returns the order in which a collection of declarations has to be written out.
+		/// </summary>
+		/// <parameter name="collection" IsConst="true">Declarations to order, either those of a namespace or the nested types of a type.</parameter>
+		/// <returns>Emissions for all the declarations in the collection, each of which is defined exactly once.</returns>
+		template< typename T > static EmissionOrder Order( const TypedCollection< T >& collection )
+		{
+			DependencyGraph graph;
+			for( typename TypedCollection< T >::const_iterator iter = collection.begin( ) ; iter != collection.end( ) ; ++iter )
+				graph.add( node( *iter ) );
+			return graph.order( );
+		}
+
+		/// <summary>
+		/// Writes out a forward declaration of the given type.
+		/// </summary>
+		/// <parameter name="type" IsConst="true">Type to declare, either a class or a union.</parameter>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for the declaration.</parameter>
+		static void Declare( const CodeObject& type , std::wostream& os , unsigned long tabs );
+
+		/// <summary>
+		/// Lists the given type and all the types nested in it, at any depth.
+		/// </summary>
+		/// <parameter name="type" IsConst="true">Type to start from.</parameter>
+		/// <parameter name="types">List which receives the types.</parameter>
+		static void Nested( const CodeObject& type , std::vector< const CodeObject* >& types );
+
+		/// <summary>
+		/// Lists the types a declaration refers to and whether their definitions are needed, following the same rules used for ordering.
+		/// Types, free functions and variables are understood, a variable held by value needs the definition of its type unless it is extern.
+		/// Unlike ordering, the bodies written into the definition stream are accounted for, so free functions and member functions defined out of their class need the types they take and return by value in full.
+		/// </summary>
+		/// <parameter name="declaration" IsConst="true">Declaration whose references are listed.</parameter>
+		/// <parameter name="references">List which receives the references, a type may appear more than once.</parameter>
+		static void References( const CodeObject& declaration , TypeReferenceCollection& references );
+	};
+}
+
+#endif
\ No newline at end of file
@@ -28,17 +28,20 @@ namespace CPlusPlusCodeProvider
 	ScopeResolutionExpression::ScopeResolutionExpression( const wstring& first )
 		 : left( first )
 	{
+		tag( NodeKind::ScopeResolutionExpression );
 	}
 
 	ScopeResolutionExpression::ScopeResolutionExpression( const wstring& first , const copying_pointer< ScopeResolutionExpression >& second )
 		 : right( second ) , left( first )
 	{
+		tag( NodeKind::ScopeResolutionExpression );
 	}
 
 	ScopeResolutionExpression& ScopeResolutionExpression::Assign( const CodeObject& object )
 	{
 		const ScopeResolutionExpression& ref = cast< ScopeResolutionExpression >( object );
 		left = ref.left , right = ref.right;
+		Invalidate( );
 		return *this;
 	}
 
@@ -58,6 +61,7 @@ namespace CPlusPlusCodeProvider
 	{
 		const BinaryExpression& ref = cast< BinaryExpression >( object );
 		left.release( ) , left = ref.left , right.release( ) , right = ref.right;
+		Invalidate( );
 		return *this;
 	}
 
@@ -69,11 +73,13 @@ namespace CPlusPlusCodeProvider
 	BinaryExpression::BinaryExpression( const copying_pointer< Expression >& a , const copying_pointer< Expression >& b , int type )
 		 : left( a ) , right( b ) , t( type )
 	{
+		tag( NodeKind::BinaryExpression );
 	}
 
 	BinaryExpression::BinaryExpression( const copying_pointer< Expression >& a , const copying_pointer< Expression >& b , const wstring& str , CompilerCapabilities::Capability capability )
 		 : left( a ) , right( b ) , name( validate( str , capability ) )
 	{
+		tag( NodeKind::BinaryExpression );
 	}
 
 	wstring BinaryExpression::validate( const wstring& str , CompilerCapabilities::Capability capability )
@@ -218,6 +224,7 @@ namespace CPlusPlusCodeProvider
 		const PrefixExpression& ref = cast< PrefixExpression >( object );
 		UnaryExpression::Assign( ref );
 		t = ref.t;
+		Invalidate( );
 		return *this;
 	}
 
@@ -229,11 +236,13 @@ namespace CPlusPlusCodeProvider
 	PrefixExpression::PrefixExpression( const copying_pointer< Expression >& expression , int type )
 		 : UnaryExpression( expression ) , t( type )
 	{
+		tag( NodeKind::PrefixExpression );
 	}
 
 	PrefixExpression::PrefixExpression( const copying_pointer< Expression >& expression , const wstring& type , CompilerCapabilities::Capability capability )
 		 : UnaryExpression( expression ) , name( validate( type , capability ) )
 	{
+		tag( NodeKind::PrefixExpression );
 	}
 
 	wstring PrefixExpression::validate( const wstring& str , CompilerCapabilities::Capability capability )
@@ -293,6 +302,7 @@ namespace CPlusPlusCodeProvider
 		const PostfixExpression& ref = cast< PostfixExpression >( object );
 		UnaryExpression::Assign( ref );
 		t = ref.t;
+		Invalidate( );
 		return *this;
 	}
 
@@ -304,6 +314,7 @@ namespace CPlusPlusCodeProvider
 	PostfixExpression::PostfixExpression( const copying_pointer< Expression >& expression , int type )
 		 : UnaryExpression( expression ) , t( type )
 	{
+		tag( NodeKind::PostfixExpression );
 	}
 
 	void PostfixExpression::writetext( wostream& os , unsigned long ) const
@@ -327,6 +338,7 @@ namespace CPlusPlusCodeProvider
 	{
 		const Cast& ref = cast< Cast >( object );
 		target = ref.target , expression = ref.expression;
+		Invalidate( );
 		return *this;
 	}
 
@@ -335,9 +347,15 @@ namespace CPlusPlusCodeProvider
 		return *new Cast( *this );
 	}
 
+	void Cast::remap( const CloneScope& scope )
+	{
+		scope.Remap( expression );
+	}
+
 	Cast::Cast( const wstring& targettype , const Expression& expr , CastType cast )
 		 : target( targettype ) , expression( &expr ) , type( cast )
 	{
+		tag( NodeKind::Cast );
 	}
 
 	Cast::CastType Cast::Casttype( ) const
@@ -393,12 +411,14 @@ namespace CPlusPlusCodeProvider
 	ArgumentReference::ArgumentReference( const VariableDeclaration& arg )
 		 : argument( &arg )
 	{
+		tag( NodeKind::ArgumentReference );
 	}
 
 	ArgumentReference& ArgumentReference::Assign( const CodeObject& object )
 	{
 		const ArgumentReference& ref = cast< ArgumentReference >( object );
 		argument = ref.argument;
+		Invalidate( );
 		return *this;
 	}
 
@@ -407,15 +427,22 @@ namespace CPlusPlusCodeProvider
 		return *new ArgumentReference( *this );
 	}
 
+	void ArgumentReference::remap( const CloneScope& scope )
+	{
+		scope.Remap( argument );
+	}
+
 	void ArgumentReference::writetext( wostream& os , unsigned long ) const
 	{
 		os << argument -> Declarator( ).Name( );
+		refer( *argument );
 	}
 
 	ConditionalExpression& ConditionalExpression::Assign( const CodeObject& object )
 	{
 		const ConditionalExpression& ref = cast< ConditionalExpression >( object );
 		test = ref.test , correct = ref.correct , incorrect = ref.incorrect;
+		Invalidate( );
 		return *this;
 	}
 
@@ -427,6 +454,7 @@ namespace CPlusPlusCodeProvider
 	ConditionalExpression::ConditionalExpression( const Expression& expression , const Expression& True , const Expression& False )
 		 : test( &expression ) , correct( &True ) , incorrect( &False )
 	{
+		tag( NodeKind::ConditionalExpression );
 	}
 
 	void ConditionalExpression::writetext( wostream& os , unsigned long tabs ) const
@@ -442,9 +470,9 @@ namespace CPlusPlusCodeProvider
 	CallExpression& CallExpression::Assign( const CodeObject& object )
 	{
 		const CallExpression& ref = cast< CallExpression >( object );
-		if( ref.target.get( ) )
-			target.reset( new copying_pointer< Expression >( static_cast< Expression* >( &( *ref.target ) -> Duplicate( ) ) ) );
-		method = ref.method , arguments.reset( new ExpressionCollection( *ref.arguments ) );
+		target.reset( ref.target.get( ) ? new copying_pointer< Expression >( *ref.target ) : 0 );
+		method = ref.method , is_pointer = ref.is_pointer , arguments.reset( new ExpressionCollection( *ref.arguments ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -453,19 +481,27 @@ namespace CPlusPlusCodeProvider
 		return *new CallExpression( *this );
 	}
 
+	void CallExpression::remap( const CloneScope& scope )
+	{
+		scope.Remap( method );
+	}
+
 	CallExpression::CallExpression( const CallExpression& other )
-		 : target( other.target.get( ) ? new copying_pointer< Expression >( *other.target ) : 0 ) , method( other.method ) , arguments( new ExpressionCollection( *other.arguments ) )
+		 : target( other.target.get( ) ? new copying_pointer< Expression >( *other.target ) : 0 ) , method( other.method ) , is_pointer( other.is_pointer ) , arguments( new ExpressionCollection( *other.arguments ) )
 	{
+		tag( other.Kind( ) );
 	}
 
 	CallExpression::CallExpression( const copying_pointer< Expression >& expr , const MemberFunction& func , bool pointer )
-		: target( expr.pointer( ) ? new copying_pointer< Expression >( static_cast< Expression* >( &expr -> Duplicate( ) ) ) : throw NullPointerException( "A member function must be invoked through a target object." ) ) , method( &func ) , is_pointer( pointer ) , arguments( new ExpressionCollection )
+		: target( expr.pointer( ) ? new copying_pointer< Expression >( expr ) : throw NullPointerException( "A member function must be invoked through a target object." ) ) , method( &func ) , is_pointer( pointer ) , arguments( new ExpressionCollection )
 	{
+		tag( NodeKind::CallExpression );
 	}
 
 	CallExpression::CallExpression( const copying_pointer< Expression >& expr , const Function& func )
-		: target( expr.pointer( ) ? new copying_pointer< Expression >( static_cast< Expression* >( &expr -> Duplicate( ) ) ) : 0 ) , method( &func ) , arguments( new ExpressionCollection )
+		: target( expr.pointer( ) ? new copying_pointer< Expression >( expr ) : 0 ) , method( &func ) , is_pointer( false ) , arguments( new ExpressionCollection )
 	{
+		tag( NodeKind::CallExpression );
 	}
 
 	const Function& CallExpression::Method( ) const
@@ -480,10 +516,10 @@ namespace CPlusPlusCodeProvider
 
 	void CallExpression::writetext( wostream& os , unsigned long tabs ) const
 	{
-		if( dynamic_cast< const MemberFunction* >( method ) == 0 )
+		if( method -> Kind( ) != NodeKind::MemberFunction )
 		{
-			if( target.get( ) )
-				( *target ) -> write( os , tabs );
+			if( const copying_pointer< Expression >* callee = target.get( ) )
+				( *callee ) -> write( os , tabs );
 			else
 				os << wstring( tabs , FormattingData::IndentationCharacter );
 		}
@@ -493,11 +529,13 @@ namespace CPlusPlusCodeProvider
 			os << is_pointer ? L" -> " : L".";
 		}
 		os << method -> Name( ) << L"( ";
+		refer( *method );
 		if( arguments.get( ) && arguments -> size( ) != 0 )
 		{
-			ExpressionCollection::const_iterator i = arguments -> begin( );
+			const ExpressionCollection& list = *arguments;
+			ExpressionCollection::const_iterator i = list.begin( );
 			( *i ) -> write( os , 0 );
-			for( ++i ; i != arguments -> end( ) ; ++i )
+			for( ++i ; i != list.end( ) ; ++i )
 			{
 				os << L" , ";
 				( *i ) -> write( os , 0 );
@@ -511,6 +549,7 @@ namespace CPlusPlusCodeProvider
 	{
 		const VariableReference& ref = cast< VariableReference >( object );
 		reference = ref.reference;
+		Invalidate( );
 		return *this;
 	}
 
@@ -519,14 +558,21 @@ namespace CPlusPlusCodeProvider
 		return *new VariableReference( *this );
 	}
 
+	void VariableReference::remap( const CloneScope& scope )
+	{
+		scope.Remap( reference );
+	}
+
 	VariableReference::VariableReference( )
 		 : reference( 0 )
 	{
+		tag( NodeKind::VariableReference );
 	}
 
 	VariableReference::VariableReference( const VariableDeclaration& variable )
 		 : reference( &variable )
 	{
+		tag( NodeKind::VariableReference );
 	}
 
 	bool VariableReference::Empty( ) const
@@ -537,12 +583,14 @@ namespace CPlusPlusCodeProvider
 	void VariableReference::writetext( wostream& os , unsigned long ) const
 	{
 		os << reference -> Declarator( ).Name( );
+		refer( *reference );
 	}
 
 	MethodReference& MethodReference::Assign( const CodeObject& object )
 	{
 		const MethodReference& ref = cast< MethodReference >( object );
 		method = ref.method;
+		Invalidate( );
 		return *this;
 	}
 
@@ -551,14 +599,21 @@ namespace CPlusPlusCodeProvider
 		return *new MethodReference( *this );
 	}
 
+	void MethodReference::remap( const CloneScope& scope )
+	{
+		scope.Remap( method );
+	}
+
 	MethodReference::MethodReference( const Function& func )
 		 : method( &func )
 	{
+		tag( NodeKind::MethodReference );
 	}
 
 	void MethodReference::writetext( wostream& os , unsigned long ) const
 	{
 		os << method -> Name( );
+		refer( *method );
 	}
 
 	NewExpression& NewExpression::Assign( const CodeObject& object )
@@ -569,6 +624,7 @@ namespace CPlusPlusCodeProvider
 		level = ref.level;
 		is_pointer = ref.is_pointer , is_array = ref.is_array;
 		size.release( ) , size.reset( new copying_pointer< Expression >( *ref.size ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -577,14 +633,21 @@ namespace CPlusPlusCodeProvider
 		return *new NewExpression( *this );
 	}
 
+	void NewExpression::remap( const CloneScope& scope )
+	{
+		scope.Remap( type );
+	}
+
 	NewExpression::NewExpression( const NewExpression& other )
 		: type( other.type ) , arguments( new ExpressionCollection( *other.arguments ) ) , level( other.level ) , is_pointer( other.is_pointer ) , size( other.size.get( ) ? new copying_pointer< Expression >( *other.size ) : 0 ) , is_array( other.is_array )
 	{
+		tag( other.Kind( ) );
 	}
 
 	NewExpression::NewExpression( const Type& t , ExpressionCollection& args )
 		 : type( &t ) , arguments( new ExpressionCollection( args ) ) , level( 0 ) , is_array( false ) , is_pointer( false )
 	{
+		tag( NodeKind::NewExpression );
 	}
 
 	bool NewExpression::Array( ) const
@@ -595,6 +658,7 @@ namespace CPlusPlusCodeProvider
 	NewExpression& NewExpression::Array( bool flag )
 	{
 		is_array = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -606,6 +670,7 @@ namespace CPlusPlusCodeProvider
 	NewExpression& NewExpression::IndirectionLevel( unsigned int n )
 	{
 		level = n;
+		Invalidate( );
 		return *this;
 	}
 
@@ -617,26 +682,30 @@ namespace CPlusPlusCodeProvider
 	NewExpression& NewExpression::Pointer( bool val )
 	{
 		is_pointer = val;
+		Invalidate( );
 		return *this;
 	}
 
 	void NewExpression::writetext( wostream& os , unsigned long tabs ) const
 	{
 		os << wstring( tabs , FormattingData::IndentationCharacter ) << L"new " << type -> Name( );
+		refer( *type );
 		if( Pointer( ) )
 			os << wstring( IndirectionLevel( ) , L'*' );
 		if( is_array )
 		{
+			const copying_pointer< Expression >& length = *size;
 			os << L" [ ";
-			( *size ) -> write( os , 0 );
+			length -> write( os , 0 );
 			os << L" ] ";
 		}
 		else if( arguments -> size( ) )
 		{
+			const ExpressionCollection& list = *arguments;
 			os << L"( ";
-			ExpressionCollection::const_iterator i = arguments -> begin( );
+			ExpressionCollection::const_iterator i = list.begin( );
 			( *i ) -> write( os , 0 );
-			for( ++i ; i != arguments -> end( ) ; ++i )
+			for( ++i ; i != list.end( ) ; ++i )
 			{
 				os << L" , ";
 				( *i ) -> write( os , 0 );
@@ -648,12 +717,14 @@ namespace CPlusPlusCodeProvider
 	ParenthesizedExpression::ParenthesizedExpression( const Expression& expression )
 		 : source( &expression )
 	{
+		tag( NodeKind::ParenthesizedExpression );
 	}
 
 	ParenthesizedExpression& ParenthesizedExpression::Assign( const CodeObject& object )
 	{
 		const ParenthesizedExpression& ref = cast< ParenthesizedExpression >( object );
 		source = ref.source;
+		Invalidate( );
 		return *this;
 	}
 
@@ -662,6 +733,11 @@ namespace CPlusPlusCodeProvider
 		return *new ParenthesizedExpression( *this );
 	}
 
+	void ParenthesizedExpression::remap( const CloneScope& scope )
+	{
+		scope.Remap( source );
+	}
+
 	void ParenthesizedExpression::writetext( wostream& os , unsigned long ) const
 	{
 		os << L"( ";
@@ -674,6 +750,7 @@ namespace CPlusPlusCodeProvider
 		const DeleteExpression& ref = cast< DeleteExpression >( object );
 		type.release( ) , type = ref.type;
 		is_array = ref.is_array;
+		Invalidate( );
 		return *this;
 	}
 
@@ -685,6 +762,7 @@ namespace CPlusPlusCodeProvider
 	DeleteExpression::DeleteExpression( const copying_pointer< Expression >& expr )
 		 : type( expr ) , is_array( false )
 	{
+		tag( NodeKind::DeleteExpression );
 	}
 
 	bool DeleteExpression::Array( ) const
@@ -695,6 +773,7 @@ namespace CPlusPlusCodeProvider
 	DeleteExpression& DeleteExpression::Array( bool flag )
 	{
 		is_array = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -715,6 +794,7 @@ namespace CPlusPlusCodeProvider
 	{
 		const ThrowExpression& ref = cast< ThrowExpression >( object );
 		tothrow.release( ) , tothrow = ref.tothrow;
+		Invalidate( );
 		return *this;
 	}
 
@@ -726,6 +806,7 @@ namespace CPlusPlusCodeProvider
 	ThrowExpression::ThrowExpression( const copying_pointer< Expression >& expr )
 		 : tothrow( expr )
 	{
+		tag( NodeKind::ThrowExpression );
 	}
 
 	void ThrowExpression::writetext( wostream& os , unsigned long tabs ) const
@@ -739,6 +820,7 @@ namespace CPlusPlusCodeProvider
 	PrimitiveExpression::PrimitiveExpression( const wstring& str )
 		: expression( str )
 	{
+		tag( NodeKind::PrimitiveExpression );
 	}
 
 	PrimitiveExpression& PrimitiveExpression::Duplicate( ) const
@@ -749,6 +831,7 @@ namespace CPlusPlusCodeProvider
 	PrimitiveExpression& PrimitiveExpression::Assign( const CodeObject& object )
 	{
 		expression = cast< PrimitiveExpression >( object ).expression;
+		Invalidate( );
 		return *this;
 	}
 
@@ -760,11 +843,13 @@ namespace CPlusPlusCodeProvider
 	LambdaCapture::LambdaCapture( int captureMode )
 		: captureType( captureMode ) , VariableReference( )
 	{
+		tag( NodeKind::LambdaCapture );
 	}
 
 	LambdaCapture::LambdaCapture( copying_pointer< VariableDeclaration >& ref , int captureMode )
 		: captureType( captureMode ) , VariableReference( *ref )
 	{
+		tag( NodeKind::LambdaCapture );
 	}
 
 	LambdaCapture& LambdaCapture::Duplicate( ) const
@@ -778,6 +863,7 @@ namespace CPlusPlusCodeProvider
 		VariableReference::Assign( ref );
 		captureType = ref.captureType;
 
+		Invalidate( );
 		return *this;
 	}
 
@@ -795,17 +881,20 @@ namespace CPlusPlusCodeProvider
 	LambdaExpression::LambdaExpression( )
 		: Callable( L"" ) , statements( new CodeCollection( ) ) , is_mutable( false ) , captures( new CaptureCollection( ) )
 	{
+		tag( NodeKind::LambdaExpression );
 	}
 
 	LambdaExpression::LambdaExpression( copying_pointer< VariableDeclaration >& returns )
 		: Callable( L"" , returns ) , statements( new CodeCollection( ) ) , is_mutable( false ) , captures( new CaptureCollection( ) )
 	{
+		tag( NodeKind::LambdaExpression );
 	}
 	
 	//incomplete
 	LambdaExpression::LambdaExpression( const LambdaExpression& other )
 		: Callable( other ) , statements( new CodeCollection( *other.statements ) ) , is_mutable( other.is_mutable ) , captures( new CaptureCollection( *other.captures ) )
 	{
+		tag( other.Kind( ) );
 	}
 
 	LambdaExpression& LambdaExpression::Duplicate( ) const
@@ -822,6 +911,7 @@ namespace CPlusPlusCodeProvider
 
 		is_mutable = ref.is_mutable;
 
+		Invalidate( );
 		return *this;
 	}
 
@@ -833,6 +923,7 @@ namespace CPlusPlusCodeProvider
 	LambdaExpression& LambdaExpression::Mutable( bool flag )
 	{
 		is_mutable = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -852,8 +943,9 @@ namespace CPlusPlusCodeProvider
 		os << L'\n' << tab << L'{' << L'\n';
 		if( statements.get( ) )
 		{
+			const CodeCollection& body = *statements;
 			++tabs;
-			for( CodeCollection::const_iterator i = statements -> begin( ) ; i != statements -> end( ) ; ++i )
+			for( CodeCollection::const_iterator i = body.begin( ) ; i != body.end( ) ; ++i )
 			{
 				( **i ).write( os , tabs );
 				os << L'\n';
@@ -865,21 +957,21 @@ namespace CPlusPlusCodeProvider
 
 	void LambdaExpression::writereturntype( wostream& os ) const
 	{
-		if( ReturnType( ) )
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
 		{
 			os << L" -> ";
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
+			( *result ) -> writeasreturntype( os );
 		}
 	}
 
 	void LambdaExpression::writecapturelist( wostream& os , unsigned long tabs ) const
 	{
 		wstring tab( tabs , FormattingData::IndentationCharacter );
-		CaptureCollection::const_iterator i = captures -> begin( );
+		const CaptureCollection& list = *captures;
+		CaptureCollection::const_iterator i = list.begin( );
 		os << L" [ ";
 		( *i ) -> write( os , tabs );
-		for( ++i ; i != captures -> end( ) ; ++i )
+		for( ++i ; i != list.end( ) ; ++i )
 		{
 			os << L" , ";
 			( *i ) -> write( os , tabs );
@@ -889,9 +981,7 @@ namespace CPlusPlusCodeProvider
 
 	void LambdaExpression::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 
 		writecapturelist( os , tabs );
 		writeparameters( os );
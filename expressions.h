@@ -11,6 +11,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class UnaryExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > source;
 	public:
 		/// <summary>
@@ -44,6 +47,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ScopeResolutionExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::wstring left;
 		copying_pointer< ScopeResolutionExpression > right;
 	public:
@@ -107,6 +113,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class BinaryExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > left , right;
 		std::wstring name;
 		std::wstring validate( const std::wstring& , CompilerCapabilities::Capability capability );
@@ -317,6 +326,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class PrefixExpression : public UnaryExpression
 	{
+		friend class Snapshot;
 		std::wstring name;
 		std::wstring validate( const std::wstring& , CompilerCapabilities::Capability capability );
 		int t;
@@ -430,6 +440,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class PostfixExpression : public UnaryExpression
 	{
+		friend class Snapshot;
 		int t;
 	public:
 		/// <summary>
@@ -499,6 +510,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ArgumentReference : public Expression
 	{
+		friend class Snapshot;
 		const VariableDeclaration* argument;
 	public:
 		/// <summary>
@@ -524,6 +536,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>This object with contents replaced by the given one.</returns>
 		ArgumentReference& Assign( const CodeObject& object );
 	protected:
+		/// <summary>
+		/// Redirects the referenced argument to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a new ArgumentReference that references the given variable.
 		/// </summary>
@@ -544,6 +562,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Cast : public Expression
 	{
+		friend class Snapshot;
 		std::wstring target;
 		const Expression* expression;
 	public:
@@ -618,6 +637,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>Cast's type.</returns>
 		CastType Casttype( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the expression being cast to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Creates a new Cast object.
 		/// </summary>
@@ -642,6 +667,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ConditionalExpression : public Expression
 	{
+		friend class Snapshot;
 		const Expression *test , *correct , *incorrect;
 	public:
 		/// <summary>
@@ -710,6 +736,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class VariableReference : public Expression
 	{
+		friend class Snapshot;
 		const VariableDeclaration* reference;
 	public:
 		/// <summary>
@@ -735,6 +762,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>This object with contents replaced by the given one.</returns>
 		VariableReference& Assign( const CodeObject& object );
 	protected:
+		/// <summary>
+		/// Redirects the referenced variable to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Creates a new VariableReference object.
 		/// </summary>
@@ -766,6 +799,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class CallExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::auto_ptr< copying_pointer< Expression > > target;
 		const Function* method;
 		std::auto_ptr< ExpressionCollection > arguments;
@@ -826,6 +862,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A reference to the function that is called.</returns>
 		const Function& Method( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the called function to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a CallExpression object from another one.
 		/// </summary>
@@ -860,6 +902,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class MethodReference : public Expression
 	{
+		friend class Snapshot;
 		const Function* method;
 	public:
 		/// <summary>
@@ -885,6 +928,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>This object with contents replaced by the given one.</returns>
 		MethodReference& Assign( const CodeObject& object );
 	protected:
+		/// <summary>
+		/// Redirects the referenced function to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a new MethodReference object.
 		/// </summary>
@@ -905,6 +954,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class NewExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		const Type* type;
 		std::auto_ptr< ExpressionCollection > arguments;
 		unsigned int level;
@@ -987,6 +1039,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A reference to this object.</returns>
 		NewExpression& Size( copying_pointer< Expression >* size );
 	protected:
+		/// <summary>
+		/// Redirects the allocated type to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		NewExpression( const NewExpression& );
 		/// <summary>
 		/// Constructs a new NewExpression given a type and its constructor's arguments.
@@ -1009,6 +1067,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ParenthesizedExpression : public Expression
 	{
+		friend class Snapshot;
 		const Expression* source;
 	public:
 		/// <summary>
@@ -1034,6 +1093,12 @@ namespace CPlusPlusCodeProvider
 		/// <returns>This object with contents replaced by the given one.</returns>
 		ParenthesizedExpression& Assign( const CodeObject& object );
 	protected:
+		/// <summary>
+		/// Redirects the enclosed expression to its copy if it was cloned along with this expression.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a new ParenthesizedExpression given another expression.
 		/// </summary>
@@ -1054,6 +1119,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class DeleteExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > type;
 		bool is_array;
 	public:
@@ -1120,6 +1188,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ThrowExpression : public Expression
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > tothrow;
 	public:
 		/// <summary>
@@ -1172,6 +1243,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class PrimitiveExpression : public Expression
 	{
+		friend class Snapshot;
 		std::wstring expression;
 	public:
 		static const copying_pointer< PrimitiveExpression > emptyexpression;
@@ -1227,6 +1299,7 @@ namespace CPlusPlusCodeProvider
 
 	class LambdaCapture : public VariableReference
 	{
+		friend class Snapshot;
 		int captureType;
 	public:
 		/// <summary>
@@ -1265,12 +1338,15 @@ namespace CPlusPlusCodeProvider
 	};
 
 	typedef TypedCollection< copying_pointer< VariableDeclaration > > ParameterCollection;
-	typedef TypedCollection< copying_pointer< CodeObject > > CodeCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > CodeCollection;
 	typedef TypedCollection< copying_pointer< LambdaCapture > > CaptureCollection;
 	typedef TypedCollection< std::wstring > StringCollection;
 
 	class LambdaExpression : public Expression , public Callable
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::auto_ptr< CodeCollection > statements;
 
 		std::auto_ptr< CaptureCollection > captures;
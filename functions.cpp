@@ -3,6 +3,7 @@
 #include "statements.h"
 #include "declarations.h"
 #include "collections.h"
+#include "output.h"
 
 namespace CPlusPlusCodeProvider
 {
@@ -22,6 +23,7 @@ namespace CPlusPlusCodeProvider
 	Function& Function::Assign( const CodeObject& object )
 	{
 		Assign( cast< Function >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -32,18 +34,21 @@ namespace CPlusPlusCodeProvider
 
 	//incomplete
 	Function::Function( const Function& other )
-		: Callable( other ) , is_inline( other.is_inline ) , catchclauses( new CatchClauseCollection( *other.catchclauses ) ) , template_parameters( new TemplateParameterCollection( *other.template_parameters ) ) , statements( new StatementCollection( *other.statements ) ) , separate( other.separate )
+		: Callable( other ) , is_inline( other.is_inline ) , catchclauses( new CatchClauseCollection( *other.catchclauses ) ) , template_parameters( new TemplateParameterCollection( *other.template_parameters ) ) , statements( new StatementCollection( *other.statements ) )
 	{
+		tag( other.Kind( ) );
 	}
 
 	Function::Function( const wstring& name_ , CompilerCapabilities::Capability capabilities )
-		 : Callable( name_ ) , catchclauses( new CatchClauseCollection( ) ) , template_parameters( new TemplateParameterCollection( ) ) , is_inline( false ) , statements( new StatementCollection( ) ) , capability( capabilities ) , separate( true )
+		 : Callable( name_ ) , catchclauses( new CatchClauseCollection( ) ) , template_parameters( new TemplateParameterCollection( ) ) , is_inline( false ) , statements( new StatementCollection( ) ) , capability( capabilities )
 	{
+		tag( NodeKind::Function );
 	}
 
 	Function::Function( const wstring& name_ , copying_pointer< VariableDeclaration >& type , CompilerCapabilities::Capability capabilities )
-		 : Callable( name_ , type ) , catchclauses( new CatchClauseCollection( ) ) , template_parameters( new TemplateParameterCollection( ) ) , is_inline( false ) , statements( new StatementCollection( ) ) , capability( capabilities ) , separate( true )
+		 : Callable( name_ , type ) , catchclauses( new CatchClauseCollection( ) ) , template_parameters( new TemplateParameterCollection( ) ) , is_inline( false ) , statements( new StatementCollection( ) ) , capability( capabilities )
 	{
+		tag( NodeKind::Function );
 	}
 
 	CodeCollection& Function::Statements( ) const
@@ -69,11 +74,13 @@ namespace CPlusPlusCodeProvider
 	Function& Function::Inline( bool val )
 	{
 		is_inline = val;
+		Invalidate( );
 		return *this;
 	}
 
 	void Function::declaration( wostream& os , unsigned long tabs ) const
 	{
+		track( );
 		writedeclaration( os , tabs );
 	}
 
@@ -90,7 +97,8 @@ namespace CPlusPlusCodeProvider
 	void Function::writetext( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
 	{
 		writedeclaration( declos , decltabs );
-		write( defos , deftabs );
+		if( !DefinitionScope::Collect( *this , deftabs ) )
+			write( defos , deftabs );
 	}
 
 	void Function::writedeclaration( wostream& os , unsigned long tabs ) const
@@ -98,11 +106,8 @@ namespace CPlusPlusCodeProvider
 		writetemplateattributes( os , tabs );
 		if( Inline( ) )
 			os << L"inline ";
-		if( ReturnType( ) )
-		{
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
-		}
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
+			( *result ) -> writeasreturntype( os );
 		else
 			os << L"void ";
 		os << Name( );
@@ -118,9 +123,10 @@ namespace CPlusPlusCodeProvider
 			os << wstring( tabs , FormattingData::IndentationCharacter ) << L"template< ";
 			if( template_parameters -> size( ) > 0 )
 			{
-				CPlusPlusCodeProvider::TemplateParameterCollection::const_iterator i = template_parameters -> begin( );
+				const CPlusPlusCodeProvider::TemplateParameterCollection& parameters = *template_parameters;
+				CPlusPlusCodeProvider::TemplateParameterCollection::const_iterator i = parameters.begin( );
 				( *i ) -> write( os , 0 );
-				for( ++i ; i != template_parameters -> end( ) ; ++i )
+				for( ++i ; i != parameters.end( ) ; ++i )
 				{
 					os << L" , ";
 					( *i ) -> write( os , 0 );
@@ -132,49 +138,53 @@ namespace CPlusPlusCodeProvider
 
 	void Function::writebody( wostream& os , unsigned long tabs ) const
 	{
+		OutputBuffer* buffer = OutputBuffer::Of( os );
+		if( !buffer )
+		{
+			OutputStream body;
+			writebody( body , tabs );
+			body.WriteTo( os );
+			return;
+		}
 		wstring tab( tabs , FormattingData::IndentationCharacter );
-		os << L'\n' << tab << L'{' << L'\n';
+		buffer -> Append( L'\n' ).Append( tab ).Append( L"{\n" );
 		if( !FunctionTryBlock( ) && catchclauses -> size( ) )
-			os << tab << wstring( 1 , FormattingData::IndentationCharacter ) << L"try" << L'\n' << tab
-			<< wstring( 1 , FormattingData::IndentationCharacter ) << L'{' << L'\n';
+			buffer -> Append( tab ).Append( FormattingData::IndentationCharacter ).Append( L"try\n" ).Append( tab ).Append( FormattingData::IndentationCharacter ).Append( L"{\n" );
 		if( statements.get( ) )
 		{
+			const CodeCollection& body = *statements;
 			++tabs;
-			for( CodeCollection::const_iterator i = statements -> begin( ) ; i != statements -> end( ) ; ++i )
+			for( CodeCollection::const_iterator i = body.begin( ) ; i != body.end( ) ; ++i )
 			{
 				( **i ).write( os , tabs );
-				os << L'\n';
+				buffer -> Append( L'\n' );
 			}
 			--tabs;
 		}
 		if( !FunctionTryBlock( ) && catchclauses -> size( ) )
 		{
-			os << tab << wstring( 1 , FormattingData::IndentationCharacter ) << L"}\n";
+			buffer -> Append( tab ).Append( FormattingData::IndentationCharacter ).Append( L"}\n" );
 			writecatchclauses( os , tabs + 1 );
 		}
-		os << tab << L"}\n";
+		buffer -> Append( tab ).Append( L"}\n" );
 	}
 
 	void Function::writecatchclauses( wostream& os , unsigned long tabs ) const
 	{
-		for( CatchClauseCollection::const_iterator i = CatchClauses( ).begin( ) ; i != CatchClauses( ).end( ) ; ++i )
+		const CatchClauseCollection& clauses = CatchClauses( );
+		for( CatchClauseCollection::const_iterator i = clauses.begin( ) ; i != clauses.end( ) ; ++i )
 			( *i ) -> write( os , tabs );
 	}
 
 	void Function::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		os << wstring( tabs , FormattingData::IndentationCharacter );
 		writetemplateattributes( os , 0 );
 		if( is_inline )
 			os << L"inline ";
-		if( ReturnType( ) )
-		{
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
-		}
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
+			( *result ) -> writeasreturntype( os );
 		else
 			os << L"void ";
 		os << Name( );
@@ -187,10 +197,22 @@ namespace CPlusPlusCodeProvider
 			writecatchclauses( os , tabs );
 	}
 
+	void Function::writedefinition( wostream& os , unsigned long tabs , const RenderContext& ) const
+	{
+		Function::writetext( os , tabs );
+	}
+
+	void Function::writeinclass( wostream& os , unsigned long tabs , const RenderContext& context ) const
+	{
+		track( );
+		writedefinition( os , tabs , context );
+	}
+
 	Operator& Operator::Assign( const CodeObject& object )
 	{
 		const Operator& ref =  cast< Operator >( object );
 		t = ref.t;
+		Invalidate( );
 		return *this;
 	}
 
@@ -200,21 +222,31 @@ namespace CPlusPlusCodeProvider
 	}
 
 	Operator::Operator( const wstring& name , OperatorType ty , CompilerCapabilities::Capability capability )
-		 : Function( name , capability ) , t( ty )
+		 : Function( name , capability ) , t( ty ) , spelled( 0 )
 	{
+		tag( NodeKind::Operator );
+		Name( );
 	}
 
 	Operator::Operator( const wstring& name , OperatorType ty , copying_pointer< VariableDeclaration >& returns , CompilerCapabilities::Capability capability )
-		 : Function( name , returns , capability ) , t( ty )
+		 : Function( name , returns , capability ) , t( ty ) , spelled( 0 )
 	{
+		tag( NodeKind::Operator );
+		Name( );
 	}
 
-	wstring Operator::Name( ) const
+	const wstring& Operator::Name( ) const
 	{
-		std::wstring str( L"operator " );
-		str += Function::Name( );
-		str += L' ';
-		return str;
+		const wstring& function = Function::Name( );
+		if( spelled != &function )
+		{
+			std::wstring str( L"operator " );
+			str += function;
+			str += L' ';
+			spelling = Identifier( str );
+			spelled = &function;
+		}
+		return spelling;
 	}
 
 	Operator::OperatorType Operator::validate( OperatorType t , size_t size ) const
@@ -251,6 +283,7 @@ namespace CPlusPlusCodeProvider
 		is_constant = ref.is_constant;
 		is_volatile = ref.is_volatile;
 		access = ref.access;
+		Invalidate( );
 		return *this;
 	}
 
@@ -259,14 +292,21 @@ namespace CPlusPlusCodeProvider
 		return *new MemberFunction( *this );
 	}
 
+	void MemberFunction::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+	}
+
 	MemberFunction::MemberFunction( const nestabletype& object , const wstring& name , AccessRestrictions restrictions , CompilerCapabilities::Capability capability )
 		 : enclosingtype( &object ) , Function( name , capability ) , access( restrictions ) , is_constant( false ) , is_pure( false ) , is_static( false ) , is_virtual( false ) , is_volatile( false )
 	{
+		tag( NodeKind::MemberFunction );
 	}
 
 	MemberFunction::MemberFunction( const nestabletype& object , const wstring& name , copying_pointer< VariableDeclaration >& returns , AccessRestrictions restrictions , CompilerCapabilities::Capability capability )
 		 : enclosingtype( &object ) , Function( name , returns , capability ) , access( restrictions ) , is_constant( false ) , is_pure( false ) , is_static( false ) , is_virtual( false ) , is_volatile( false )
 	{
+		tag( NodeKind::MemberFunction );
 	}
 
 	const nestabletype& MemberFunction::EnclosingType( ) const
@@ -284,6 +324,7 @@ namespace CPlusPlusCodeProvider
 		is_constant = val;
 		if( val )
 			is_static = false;
+		Invalidate( );
 		return *this;
 	}
 
@@ -300,6 +341,7 @@ namespace CPlusPlusCodeProvider
 			TemplateParameters( ).clear( );
 			is_static = false;
 		}
+		Invalidate( );
 		return *this;
 	}
 
@@ -317,6 +359,7 @@ namespace CPlusPlusCodeProvider
 			is_static = false;
 			is_virtual = true;
 		}
+		Invalidate( );
 		return *this;
 	}
 
@@ -330,6 +373,7 @@ namespace CPlusPlusCodeProvider
 		is_static = val;
 		if( val )
 			is_virtual = is_volatile = is_constant = false;
+		Invalidate( );
 		return *this;
 	}
 
@@ -343,6 +387,7 @@ namespace CPlusPlusCodeProvider
 		is_volatile = val;
 		if( val )
 			is_static = false;
+		Invalidate( );
 		return *this;
 	}
 	
@@ -354,6 +399,7 @@ namespace CPlusPlusCodeProvider
 	MemberFunction& MemberFunction::ForceBody( bool flag )
 	{
 		force_body = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -367,11 +413,8 @@ namespace CPlusPlusCodeProvider
 				os << L"static ";
 			else if( Virtual( ) )
 				os << L"virtual ";
-		if( ReturnType( ) )
-		{
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
-		}
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
+			( *result ) -> writeasreturntype( os );
 		else
 			os << L"void ";
 		os << Name( );
@@ -387,10 +430,15 @@ namespace CPlusPlusCodeProvider
 	}
 
 	void MemberFunction::writetext( wostream& os , unsigned long tabs ) const
+	{
+		writedefinition( os , tabs , RenderContext( ) );
+	}
+
+	void MemberFunction::writedefinition( wostream& os , unsigned long tabs , const RenderContext& context ) const
 	{
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab;
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writetemplateattributes( os );
 		writetemplateattributes( os , 0 );
 		if( Inline( ) )
@@ -398,14 +446,11 @@ namespace CPlusPlusCodeProvider
 		if( !Template( ) )
 			if( Static( ) )
 				os << L"static ";
-		if( ReturnType( ) )
-		{
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
-		}
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
+			( *result ) -> writeasreturntype( os );
 		else
 			os << L"void ";
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writeelaboratedname( os );
 		os << Name( );
 		writeparameters( os );
@@ -431,6 +476,7 @@ namespace CPlusPlusCodeProvider
 		const MemberOperator& ref = cast< MemberOperator >( object );
 		Operator::Assign( ref );
 		enclosingtype = ref.enclosingtype , is_virtual = ref.is_virtual , is_const = ref.is_const , is_volatile = ref.is_volatile , access = ref.access;
+		Invalidate( );
 		return *this;
 	}
 
@@ -439,14 +485,21 @@ namespace CPlusPlusCodeProvider
 		return *new MemberOperator( *this );
 	}
 
+	void MemberOperator::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+	}
+
 	MemberOperator::MemberOperator( const nestabletype& object , const wstring& name , OperatorType t , AccessRestrictions restrictions , CompilerCapabilities::Capability capability )
 		 : Operator( name , t , capability ) , enclosingtype( &object ) , access( restrictions ) , is_const( false ) , is_virtual( false ) , is_volatile( false ) , is_pure( false )
 	{
+		tag( NodeKind::MemberOperator );
 	}
 
 	MemberOperator::MemberOperator( const nestabletype& object , const wstring& name , OperatorType t , copying_pointer< VariableDeclaration >& returns , AccessRestrictions restrictions , CompilerCapabilities::Capability capability )
 		 : Operator( name , t , returns , capability ) , enclosingtype( &object ) , access( restrictions ) , is_const( false ) , is_virtual( false ) , is_volatile( false ) , is_pure( false )
 	{
+		tag( NodeKind::MemberOperator );
 	}
 
 	bool MemberOperator::Virtual( ) const
@@ -457,12 +510,14 @@ namespace CPlusPlusCodeProvider
 	MemberOperator& MemberOperator::Virtual( bool val )
 	{
 		is_virtual = val;
+		Invalidate( );
 		return *this;
 	}
 
 	MemberOperator& MemberOperator::Pure( bool flag )
 	{
 		is_pure = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -479,6 +534,7 @@ namespace CPlusPlusCodeProvider
 	MemberOperator& MemberOperator::Constant( bool val )
 	{
 		is_const = val;
+		Invalidate( );
 		return *this;
 	}
 
@@ -490,6 +546,7 @@ namespace CPlusPlusCodeProvider
 	MemberOperator& MemberOperator::Volatile( bool val )
 	{
 		is_volatile = val;
+		Invalidate( );
 		return *this;
 	}
 	
@@ -501,6 +558,7 @@ namespace CPlusPlusCodeProvider
 	MemberOperator& MemberOperator::ForceBody( bool flag )
 	{
 		force_body = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -513,11 +571,8 @@ namespace CPlusPlusCodeProvider
 			os << L"virtual ";
 		if( Inline( ) )
 			os << L"inline ";
-		if( ReturnType( ) )
-		{
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
-		}
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
+			( *result ) -> writeasreturntype( os );
 		else
 			os << L"void ";
 		os << Operator::Name( );
@@ -534,12 +589,15 @@ namespace CPlusPlusCodeProvider
 
 	void MemberOperator::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writedefinition( os , tabs , RenderContext( ) );
+	}
+
+	void MemberOperator::writedefinition( wostream& os , unsigned long tabs , const RenderContext& context ) const
+	{
+		writecomment( os , tabs );
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab;
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writetemplateattributes( os );
 		if( !Virtual( ) )
 			writetemplateattributes( os , tabs );
@@ -547,14 +605,11 @@ namespace CPlusPlusCodeProvider
 			os << L"virtual ";
 		if( Inline( ) )
 			os << L"inline ";
-		if( ReturnType( ) )
-		{
-			( *ReturnType( ) ) -> Declarator( ).Name( L"" );
-			( *ReturnType( ) ) -> writeasparameter( os );
-		}
+		if( const copying_pointer< VariableDeclaration >* result = ReturnType( ) )
+			( *result ) -> writeasreturntype( os );
 		else
 			os << L"void ";
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writeelaboratedname( os );
 		os << Operator::Name( );
 		writeparameters( os );
@@ -576,6 +631,7 @@ namespace CPlusPlusCodeProvider
 		Function::Assign( ref , true );
 		is_explicit = ref.is_explicit , enclosingtype = ref.enclosingtype , access = ref.access;
 		initializer_list.reset( new ParameterCollection( *ref.initializer_list ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -584,6 +640,11 @@ namespace CPlusPlusCodeProvider
 		return *new Constructor( *this );
 	}
 
+	void Constructor::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+	}
+
 	Constructor::Constructor( const Constructor& other )
 		 : enclosingtype( other.enclosingtype ) , Function( other ) , is_explicit( other.is_explicit ) , access( other.access ) , initializer_list( new ParameterCollection( *other.initializer_list ) )
 	{
@@ -592,6 +653,7 @@ namespace CPlusPlusCodeProvider
 	Constructor::Constructor( const UserDefinedType& object , AccessRestrictions restrictions , bool exp , CompilerCapabilities::Capability capability )
 		 : enclosingtype( &object ) , Function( object.Name( ) , capability ) , is_explicit( exp ) , access( restrictions ) , initializer_list( new ParameterCollection( ) )
 	{
+		tag( NodeKind::Constructor );
 	}
 
 	copying_pointer< VariableDeclaration >* Constructor::ReturnType( ) const
@@ -607,12 +669,14 @@ namespace CPlusPlusCodeProvider
 	Constructor& Constructor::Access( AccessRestrictions a )
 	{
 		access = a; 
+		Invalidate( );
 		return *this;
 	}
 
 	Constructor& Constructor::Explicit( bool val )
 	{
 		is_explicit = val;
+		Invalidate( );
 		return *this;
 	}
 
@@ -626,7 +690,7 @@ namespace CPlusPlusCodeProvider
 		return *initializer_list;
 	}
 
-	wstring Constructor::Name( ) const
+	const wstring& Constructor::Name( ) const
 	{
 		return enclosingtype -> Name( );
 	}
@@ -636,9 +700,10 @@ namespace CPlusPlusCodeProvider
 		if( initializer_list -> size( ) == 0 )
 			return;
 		os << wstring( tabs , FormattingData::IndentationCharacter ) << L": ";
-		ParameterCollection::const_iterator i = initializer_list -> begin( );
+		const ParameterCollection& initializers = *initializer_list;
+		ParameterCollection::const_iterator i = initializers.begin( );
 		( *i ) -> write( os , 0 );
-		for( ++i ; i != initializer_list -> end( ) ; ++i )
+		for( ++i ; i != initializers.end( ) ; ++i )
 		{
 			os << L" , ";
 			( *i ) -> write( os , 0 );
@@ -658,17 +723,22 @@ namespace CPlusPlusCodeProvider
 	}
 
 	void Constructor::writetext( wostream& os , unsigned long tabs ) const
+	{
+		writedefinition( os , tabs , RenderContext( ) );
+	}
+
+	void Constructor::writedefinition( wostream& os , unsigned long tabs , const RenderContext& context ) const
 	{
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab;
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writetemplateattributes( os );
 		writetemplateattributes( os , 0 );
 		if( Explicit( ) )
 			os << L"explicit ";
 		if( Inline( ) )
 			os << L"inline ";
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writeelaboratedname( os );
 		os << Constructor::Name( );
 		writeparameters( os );
@@ -687,6 +757,7 @@ namespace CPlusPlusCodeProvider
 		const Destructor& ref = cast< Destructor >( object );
 		Function::Assign( ref , true );
 		enclosingtype = ref.enclosingtype , is_virtual = ref.is_virtual , access = ref.access;
+		Invalidate( );
 		return *this;
 	}
 
@@ -695,9 +766,16 @@ namespace CPlusPlusCodeProvider
 		return *new Destructor( *this );
 	}
 
+	void Destructor::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+	}
+
 	Destructor::Destructor( const UserDefinedType& object , AccessRestrictions restrictions , CompilerCapabilities::Capability capability )
-		 : enclosingtype( &object ) , Function( object.Name( ) , capability ) , access( restrictions ) , is_virtual( false ) , is_pure( false )
+		 : enclosingtype( &object ) , Function( object.Name( ) , capability ) , access( restrictions ) , is_virtual( false ) , is_pure( false ) , spelled( 0 )
 	{
+		tag( NodeKind::Destructor );
+		Name( );
 	}
 
 	copying_pointer< VariableDeclaration >* Destructor::ReturnType( ) const
@@ -705,9 +783,15 @@ namespace CPlusPlusCodeProvider
 		return 0;
 	}
 
-	wstring Destructor::Name( ) const
+	const wstring& Destructor::Name( ) const
 	{
-		return L'~' + enclosingtype -> Name( );
+		const wstring& type = enclosingtype -> Name( );
+		if( spelled != &type )
+		{
+			spelling = Identifier( L'~' + type );
+			spelled = &type;
+		}
+		return spelling;
 	}
 
 	bool Destructor::Pure( ) const
@@ -720,6 +804,7 @@ namespace CPlusPlusCodeProvider
 		is_pure = flag;
 		if( is_pure )
 			is_virtual = true;
+		Invalidate( );
 		return *this;
 	}
 
@@ -731,6 +816,7 @@ namespace CPlusPlusCodeProvider
 	Destructor& Destructor::Virtual( bool flag )
 	{
 		is_virtual = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -752,16 +838,21 @@ namespace CPlusPlusCodeProvider
 	}
 
 	void Destructor::writetext( wostream& os , unsigned long tabs ) const
+	{
+		writedefinition( os , tabs , RenderContext( ) );
+	}
+
+	void Destructor::writedefinition( wostream& os , unsigned long tabs , const RenderContext& context ) const
 	{
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab;
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writetemplateattributes( os );
 		if( Inline( ) )
 			os << L"inline ";
 		if( Virtual( ) )
 			os << L"virtual ";
-		if( separate )
+		if( context.Separate( ) )
 			enclosingtype -> writeelaboratedname( os );
 		os << Destructor::Name( ) << L"( )";
 		writeexceptionspecs( os );
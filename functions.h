@@ -2,6 +2,7 @@
 #define FUNCTIONS_HEADER
 
 #include "cppcodeprovider.h"
+#include "rendercontext.h"
 
 namespace CPlusPlusCodeProvider
 {
@@ -14,15 +15,18 @@ namespace CPlusPlusCodeProvider
 	typedef TypedCollection< copying_pointer< Type > > TypeCollection;
 	typedef TypedCollection< copying_pointer< TemplateParameter > > TemplateParameterCollection;
 	typedef TypedCollection< copying_pointer< VariableDeclaration > > ParameterCollection;
-	typedef TypedCollection< copying_pointer< CodeObject > > CodeCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > CodeCollection;
 
 	/// <summary>
 	/// Represents a free standing function in code graph.
 	/// </summary>
 	class Function : public CodeObject , public Callable
 	{
+		friend class NodeChildren;
 		friend class UserDefinedType;
 		friend class Union;
+		friend class Snapshot;
+		friend class SymbolTable;
 
 		std::auto_ptr< CodeCollection > statements;
 
@@ -83,8 +87,6 @@ namespace CPlusPlusCodeProvider
 
 		void declaration( std::wostream& os , unsigned long tabs ) const;
 	protected:
-		mutable bool separate;
-
 		Function( const std::wstring& , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 		Function( const std::wstring& , copying_pointer< VariableDeclaration >& , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 		Function( const Function& );
@@ -101,6 +103,23 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		virtual void writedeclaration( std::wostream& , unsigned long ) const;
 
+		/// <summary>
+		/// Writes out this function's definition, either inside the body of its enclosing type or separately, qualified with the enclosing type's name.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this Function.</parameter>
+		/// <parameter IsConst="true" name="context">Context of the rendering pass; its Separate flag is false if the definition appears inside the body of the enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		virtual void writedefinition( std::wostream& os , unsigned long tabs , const RenderContext& context ) const;
+		/// <summary>
+		/// Writes out this function's definition inside the body of its enclosing type.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this Function.</parameter>
+		/// <parameter IsConst="true" name="context">Context used for members of the enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		void writeinclass( std::wostream& os , unsigned long tabs , const RenderContext& context ) const;
+
 		/// <summary>
 		/// Writes out the contents to the provided stream.
 		/// </summary>
@@ -125,6 +144,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class MemberFunction : public Function
 	{
+		friend class Snapshot;
 		const nestabletype* enclosingtype;
 		bool is_virtual , is_static , is_constant , is_volatile , is_pure , force_body;
 		AccessRestrictions access;
@@ -175,6 +195,12 @@ namespace CPlusPlusCodeProvider
 
 		const nestabletype& EnclosingType( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type to its copy if it was cloned along with this member function.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		MemberFunction( const nestabletype& , const std::wstring& , AccessRestrictions , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 		MemberFunction( const nestabletype& , const std::wstring& , copying_pointer< VariableDeclaration >& , AccessRestrictions , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 
@@ -187,6 +213,14 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this MemberFunction</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Writes out this MemberFunction's definition, either inside the body of its enclosing type or separately, qualified with the enclosing type's name.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this MemberFunction.</parameter>
+		/// <parameter IsConst="true" name="context">Context of the rendering pass; its Separate flag is false if the definition appears inside the body of the enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		void writedefinition( std::wostream& os , unsigned long tabs , const RenderContext& context ) const;
 	};
 
 	class UserDefinedType;
@@ -195,6 +229,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Constructor : public Function
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		bool is_explicit;
 		std::auto_ptr< ParameterCollection > initializer_list;
 		const UserDefinedType* enclosingtype;
@@ -222,7 +259,7 @@ namespace CPlusPlusCodeProvider
 		Constructor& Duplicate( ) const;
 
 		/// <IsConstMember value="true"/>
-		std::wstring Name( ) const;
+		const std::wstring& Name( ) const;
 
 		Constructor& Explicit( bool );
 		/// <IsConstMember value="true"/>
@@ -235,6 +272,12 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		ParameterCollection& InitializerList( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type to its copy if it was cloned along with this constructor.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		Constructor( const Constructor& );
 		Constructor( const UserDefinedType& , AccessRestrictions , bool = false , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 
@@ -247,6 +290,14 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this Constructor</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Writes out this Constructor's definition, either inside the body of its enclosing type or separately, qualified with the enclosing type's name.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this Constructor.</parameter>
+		/// <parameter IsConst="true" name="context">Context of the rendering pass; its Separate flag is false if the definition appears inside the body of the enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		void writedefinition( std::wostream& os , unsigned long tabs , const RenderContext& context ) const;
 	private:
 		/// <IsConstMember value="true"/>
 		void writeinitializerlist( std::wostream& , unsigned long ) const;
@@ -257,9 +308,16 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Destructor : public Function
 	{
+		friend class Snapshot;
 		const UserDefinedType* enclosingtype;
 		bool is_virtual , is_pure;
 		AccessRestrictions access;
+
+		/// <summary>
+		/// Interned spelling of this destructor's name, along with the name of the enclosing type it was spelled from so that it is spelled again only after that type is renamed.
+		/// </summary>
+		mutable Identifier spelling;
+		mutable const std::wstring* spelled;
 	public:
 		static copying_pointer< Destructor > Instantiate( const UserDefinedType& type , AccessRestrictions restrictions = Public , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications )
 		{
@@ -283,7 +341,7 @@ namespace CPlusPlusCodeProvider
 		Destructor& Duplicate( ) const;
 
 		/// <IsConstMember value="true"/>
-		std::wstring Name( ) const;
+		const std::wstring& Name( ) const;
 
 		/// <IsConstMember value="true"/>
 		bool Pure( ) const;
@@ -294,6 +352,12 @@ namespace CPlusPlusCodeProvider
 
 		AccessRestrictions Access( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type to its copy if it was cloned along with this destructor.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		Destructor( const UserDefinedType& , AccessRestrictions , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 
 		/// <IsConstMember value="true"/>
@@ -305,6 +369,14 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this Destructor</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Writes out this Destructor's definition, either inside the body of its enclosing type or separately, qualified with the enclosing type's name.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this Destructor.</parameter>
+		/// <parameter IsConst="true" name="context">Context of the rendering pass; its Separate flag is false if the definition appears inside the body of the enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		void writedefinition( std::wostream& os , unsigned long tabs , const RenderContext& context ) const;
 	};
 
 	/// <summary>
@@ -312,6 +384,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Operator : public Function
 	{
+		friend class Snapshot;
 	public:
 		enum OperatorType
 		{
@@ -349,7 +422,7 @@ namespace CPlusPlusCodeProvider
 		OperatorType OpType( ) const;
 
 		/// <IsConstMember value="true"/>
-		std::wstring Name( ) const;
+		const std::wstring& Name( ) const;
 	protected:
 		Operator( const std::wstring& , OperatorType , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 		Operator( const std::wstring& , OperatorType , copying_pointer< VariableDeclaration >& , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
@@ -358,6 +431,12 @@ namespace CPlusPlusCodeProvider
 		OperatorType validate( OperatorType , size_t ) const;
 
 		OperatorType t;
+
+		/// <summary>
+		/// Interned spelling of this operator's name, along with the function name it was spelled from so that it is spelled again only after a rename.
+		/// </summary>
+		mutable Identifier spelling;
+		mutable const std::wstring* spelled;
 	};
 
 	/// <summary>
@@ -365,6 +444,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class MemberOperator : public Operator
 	{
+		friend class Snapshot;
 		const nestabletype* enclosingtype;
 		bool is_virtual , is_const , is_pure , is_volatile , force_body;
 		AccessRestrictions access;
@@ -411,6 +491,12 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		AccessRestrictions Access( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type to its copy if it was cloned along with this operator.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		MemberOperator( const nestabletype& , const std::wstring& , OperatorType , AccessRestrictions , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 		MemberOperator( const nestabletype& , const std::wstring& , OperatorType , copying_pointer< VariableDeclaration >& , AccessRestrictions , CompilerCapabilities::Capability capabilities = CompilerCapabilities::FunctionTryBlocks | CompilerCapabilities::ExceptionSpecifications );
 
@@ -423,6 +509,14 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this MemberOperator</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Writes out this MemberOperator's definition, either inside the body of its enclosing type or separately, qualified with the enclosing type's name.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this MemberOperator.</parameter>
+		/// <parameter IsConst="true" name="context">Context of the rendering pass; its Separate flag is false if the definition appears inside the body of the enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		void writedefinition( std::wostream& os , unsigned long tabs , const RenderContext& context ) const;
 	private:
 		OperatorType T;
 	};
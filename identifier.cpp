@@ -0,0 +1,73 @@
+#include <mutex>
+#include <ostream>
+#include <unordered_set>
+#include "identifier.h"
+
+using std::wstring;
+using std::wostream;
+
+namespace CPlusPlusCodeProvider
+{
+	namespace
+	{
+		/// <summary>
+		/// Storage shared by all identifiers, elements of an unordered_set never move so handles into it stay valid.
+		/// </summary>
+		struct Pool
+		{
+			std::mutex lock;
+			std::unordered_set< wstring > names;
+			const wstring* empty;
+
+			Pool( )
+				: empty( &*names.insert( wstring( ) ).first )
+			{
+			}
+
+			const wstring* intern( const wstring& name )
+			{
+				if( name.empty( ) )
+					return empty;
+				std::lock_guard< std::mutex > guard( lock );
+				return &*names.insert( name ).first;
+			}
+		};
+
+		// The pool is never destroyed, so identifiers held by static objects remain valid during shutdown.
+		Pool& pool( )
+		{
+			static Pool* instance = new Pool( );
+			return *instance;
+		}
+
+		// Constructs the pool during static initialization, before any thread other than the main one can reach it.
+		Pool& initialized = pool( );
+	}
+
+	Identifier::Identifier( )
+		: text( pool( ).empty )
+	{
+	}
+
+	Identifier::Identifier( const wstring& name )
+		: text( pool( ).intern( name ) )
+	{
+	}
+
+	Identifier::Identifier( const wchar_t* name )
+		: text( pool( ).intern( name ) )
+	{
+	}
+
+	std::size_t Identifier::PoolSize( )
+	{
+		Pool& instance = pool( );
+		std::lock_guard< std::mutex > guard( instance.lock );
+		return instance.names.size( );
+	}
+
+	wostream& operator << ( wostream& os , const Identifier& identifier )
+	{
+		return os << identifier.Text( );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef IDENTIFIER_HEADER
+#define IDENTIFIER_HEADER
+
+#include <iosfwd>
+#include <string>
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// A handle to a name stored once in a process wide, thread-safe pool.
+	/// Identifiers with the same text share storage, so copying one copies a pointer and comparing two compares pointers.
+	/// Pooled names live until the process exits.
+	/// </summary>
+	class Identifier
+	{
+		const std::wstring* text;
+	public:
+		/// <summary>
+		/// Constructs an empty identifier.
+		/// </summary>
+		Identifier( );
+
+		/// <summary>
+		/// Constructs an identifier for the given name, adding it to the pool if it is not there already.
+		/// </summary>
+		/// <parameter IsConst="true" name="name">Name to look up.</parameter>
+		Identifier( const std::wstring& name );
+
+		/// <summary>
+		/// Constructs an identifier for the given name, adding it to the pool if it is not there already.
+		/// </summary>
+		/// <parameter IsConst="true" name="name">Null terminated name to look up.</parameter>
+		Identifier( const wchar_t* name );
+
+		/// <summary>
+		/// Provides access to the pooled text of this identifier.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A reference to the text, which stays valid for the lifetime of the process.</returns>
+		const std::wstring& Text( ) const
+		{
+			return *text;
+		}
+
+		/// <summary>
+		/// Provides access to the pooled text of this identifier.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A reference to the text, which stays valid for the lifetime of the process.</returns>
+		operator const std::wstring&( ) const
+		{
+			return *text;
+		}
+
+		/// <summary>
+		/// Tells whether this identifier is empty.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if the text of this identifier is empty.</returns>
+		bool Empty( ) const
+		{
+			return text -> empty( );
+		}
+
+		/// <summary>
+		/// Compares two identifiers, which are equal only if they share storage.
+		/// </summary>
+		/// <parameter IsConst="true" name="other">Identifier to compare with.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if both identifiers have the same text.</returns>
+		bool operator == ( const Identifier& other ) const
+		{
+			return text == other.text;
+		}
+
+		/// <summary>
+		/// Compares two identifiers, which are equal only if they share storage.
+		/// </summary>
+		/// <parameter IsConst="true" name="other">Identifier to compare with.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if the identifiers have different text.</returns>
+		bool operator != ( const Identifier& other ) const
+		{
+			return text != other.text;
+		}
+
+		/// <summary>
+		/// Returns the number of distinct names in the pool.
+		/// </summary>
+		/// <returns>Number of names stored so far.</returns>
+		static std::size_t PoolSize( );
+	};
+
+	/// <summary>
+	/// Compares the text of an identifier with a string without adding the string to the pool.
+	/// </summary>
+	inline bool operator == ( const Identifier& identifier , const std::wstring& str )
+	{
+		return identifier.Text( ) == str;
+	}
+
+	/// <summary>
+	/// Compares the text of an identifier with a string without adding the string to the pool.
+	/// </summary>
+	inline bool operator == ( const std::wstring& str , const Identifier& identifier )
+	{
+		return identifier.Text( ) == str;
+	}
+
+	/// <summary>
+	/// Compares the text of an identifier with a string without adding the string to the pool.
+	/// </summary>
+	inline bool operator == ( const Identifier& identifier , const wchar_t* str )
+	{
+		return identifier.Text( ) == str;
+	}
+
+	/// <summary>
+	/// Writes out the text of an identifier.
+	/// </summary>
+	std::wostream& operator << ( std::wostream& os , const Identifier& identifier );
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef LAZYCOLLECTION_HEADER
+#define LAZYCOLLECTION_HEADER
+
+#include <memory>
+#include "rendercache.h"
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// Owns a collection of type C which is allocated only when it is first mutated, until then it reads as the shared C::empty.
+	/// Renderings which read the shared empty collection depend on this object, so that allocating it later discards them.
+	/// </summary>
+	/// <requirements>C must be copyable and provide a static const C named empty.</requirements>
+	template< typename C > class LazyCollection
+	{
+		std::auto_ptr< C > collection;
+		RenderCache cache;
+	public:
+		/// <summary>
+		/// Constructs a LazyCollection without allocating anything.
+		/// </summary>
+		LazyCollection( )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a copy of another LazyCollection, nothing is allocated if the other one is empty.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other LazyCollection to copy.</parameter>
+		LazyCollection( const LazyCollection& other )
+			: collection( other.collection.get( ) && other.collection -> size( ) ? new C( *other.collection ) : 0 )
+		{
+		}
+
+		/// <summary>
+		/// Replaces contents of this LazyCollection with a copy of another one, nothing is allocated if the other one is empty.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other LazyCollection to copy.</parameter>
+		/// <returns>A reference to this object.</returns>
+		LazyCollection& operator = ( const LazyCollection& other )
+		{
+			if( this != &other )
+			{
+				if( collection.get( ) )
+					*collection = *other;
+				else if( other -> size( ) )
+				{
+					collection.reset( new C( *other ) );
+					cache.Invalidate( );
+				}
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// Gives read access to the collection without allocating it.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>The owned collection, or C::empty if nothing has been allocated yet.</returns>
+		const C& operator * ( ) const
+		{
+			if( collection.get( ) )
+				return *collection;
+			cache.Track( );
+			return C::empty;
+		}
+
+		/// <summary>
+		/// Gives read access to the collection without allocating it.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>The owned collection, or C::empty if nothing has been allocated yet.</returns>
+		const C* operator -> ( ) const
+		{
+			return &**this;
+		}
+
+		/// <summary>
+		/// Gives write access to the collection, allocating it on first use.
+		/// </summary>
+		/// <returns>The owned collection.</returns>
+		C& Acquire( )
+		{
+			if( !collection.get( ) )
+			{
+				collection.reset( new C( ) );
+				cache.Invalidate( );
+			}
+			return *collection;
+		}
+
+		/// <summary>
+		/// Tells whether the collection has been allocated.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>true if a collection has been allocated, false otherwise.</returns>
+		bool Allocated( ) const
+		{
+			return collection.get( ) != 0;
+		}
+	};
+}
+
+#endif
\ No newline at end of file
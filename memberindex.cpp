@@ -0,0 +1,84 @@
+#include "memberindex.h"
+#include "declarations.h"
+#include "functions.h"
+#include "namespace.h"
+#include "typedefinition.h"
+#include "types.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::wstring;
+	using std::vector;
+
+	MemberIndex::MemberIndex( )
+		: generation( 0 )
+	{
+	}
+
+	void MemberIndex::add( const CodeObject* node , vector< const CodeObject* >* added )
+	{
+		if( !node )
+			return;
+		if( added )
+			added -> push_back( node );
+		switch( node -> Kind( ) )
+		{
+		case NodeKind::Namespace:
+			members.insert( std::make_pair( static_cast< const Namespace* >( node ) -> Name( ) , node ) );
+			break;
+		case NodeKind::Typedefinition:
+			{
+				const StringCollection& synonyms = static_cast< const Typedefinition* >( node ) -> Synonyms( );
+				for( StringCollection::const_iterator iter = synonyms.begin( ) ; iter != synonyms.end( ) ; ++iter )
+					members.insert( std::make_pair( static_cast< const wstring& >( *iter ) , node ) );
+			}
+			break;
+		case NodeKind::VariableDeclaration:
+			members.insert( std::make_pair( static_cast< const VariableDeclaration* >( node ) -> Declarator( ).Name( ) , node ) );
+			break;
+		case NodeKind::VariableDeclarationList:
+			{
+				const DeclaratorList& declarators = static_cast< const VariableDeclarationList* >( node ) -> Declarators( );
+				for( DeclaratorList::const_iterator iter = declarators.begin( ) ; iter != declarators.end( ) ; ++iter )
+					members.insert( std::make_pair( iter -> Name( ) , node ) );
+			}
+			break;
+		case NodeKind::Function:
+		case NodeKind::MemberFunction:
+		case NodeKind::Constructor:
+		case NodeKind::Destructor:
+		case NodeKind::Operator:
+		case NodeKind::MemberOperator:
+			members.insert( std::make_pair( static_cast< const Function* >( node ) -> Name( ) , node ) );
+			break;
+		case NodeKind::NontypeParameter:
+		case NodeKind::TypedParameter:
+		case NodeKind::TemplateTemplateParameter:
+		case NodeKind::Union:
+		case NodeKind::Enumeration:
+		case NodeKind::UserDefinedType:
+			members.insert( std::make_pair( static_cast< const Type* >( node ) -> Name( ) , node ) );
+			break;
+		}
+	}
+
+	void MemberIndex::Clear( )
+	{
+		members.clear( );
+		watermarks.clear( );
+		++generation;
+	}
+
+	unsigned long MemberIndex::Generation( ) const
+	{
+		return generation;
+	}
+
+	void MemberIndex::Find( const wstring& name , vector< const CodeObject* >& found ) const
+	{
+		typedef std::unordered_multimap< wstring , const CodeObject* >::const_iterator iterator;
+		std::pair< iterator , iterator > range = members.equal_range( name );
+		for( iterator iter = range.first ; iter != range.second ; ++iter )
+			found.push_back( iter -> second );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#ifndef MEMBERINDEX_HEADER
+#define MEMBERINDEX_HEADER
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "cppcodeprovider.h"
+#include "collections.h"
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// Maps names to the members of a type or the declarations of a namespace, so that they are found without scanning every collection they may be in.
+	/// The index is brought up to date whenever it is searched by adding the elements appended to each collection since, which keeps building a scope while looking up its members linear in the number of members.
+	/// </summary>
+	/// <remarks>A collection whose elements were removed or replaced since it was indexed is detected through its revision and indexed again. A member renamed after it was indexed, or an element replaced through an iterator obtained before the last update, is still found under its old name until the index is cleared.</remarks>
+	class MemberIndex
+	{
+		/// <summary>
+		/// Remembers which collection was indexed in a slot, at which revision and how many of its elements.
+		/// </summary>
+		struct Watermark
+		{
+			const void* collection;
+			unsigned long long revision;
+			std::size_t indexed;
+		};
+
+		std::unordered_multimap< std::wstring , const CodeObject* > members;
+		std::vector< Watermark > watermarks;
+		unsigned long generation;
+
+		/// <summary>
+		/// Adds the given node under every name it declares, nodes which declare no name are left out.
+		/// </summary>
+		void add( const CodeObject* node , std::vector< const CodeObject* >* added );
+
+		template< typename T > void add( const copying_pointer< T >& node , std::vector< const CodeObject* >* added )
+		{
+			add( node.pointer( ) , added );
+		}
+
+		template< typename T > void add( const shared_pointer< T >& node , std::vector< const CodeObject* >* added )
+		{
+			add( node.pointer( ) , added );
+		}
+
+		template< typename T > void add( const std::pair< T , AccessRestrictions >& member , std::vector< const CodeObject* >* added )
+		{
+			add( member.first , added );
+		}
+
+		template< typename T > void add( const std::tuple< T , AccessRestrictions , bool >& member , std::vector< const CodeObject* >* added )
+		{
+			add( std::get< 0 >( member ) , added );
+		}
+	public:
+		/// <summary>
+		/// Constructs an empty MemberIndex.
+		/// </summary>
+		MemberIndex( );
+
+		/// <summary>
+		/// Adds the elements appended to a collection since it was last indexed in the given slot.
+		/// </summary>
+		/// <parameter name="slot">Position of the collection among those covered by this index, the same collection must always use the same slot.</parameter>
+		/// <parameter name="collection" IsConst="true">Collection to index.</parameter>
+		/// <parameter name="added">List which receives the nodes added to the index, if given.</parameter>
+		/// <returns>True if the index is up to date with the collection, false if the collection was replaced or changed other than by appending, in which case the index has to be cleared and built again.</returns>
+		template< typename T > bool Update( std::size_t slot , const TypedCollection< T >& collection , std::vector< const CodeObject* >* added = 0 )
+		{
+			if( watermarks.size( ) <= slot )
+			{
+				Watermark fresh = { 0 , 0 , 0 };
+				watermarks.resize( slot + 1 , fresh );
+			}
+			Watermark& mark = watermarks[ slot ];
+			if( collection.size( ) < mark.indexed || ( mark.indexed && ( mark.collection != &collection || mark.revision != collection.revision( ) ) ) )
+				return false;
+			for( typename TypedCollection< T >::const_iterator iter = collection.begin( ) + mark.indexed ; iter != collection.end( ) ; ++iter )
+				add( *iter , added );
+			mark.collection = &collection;
+			mark.revision = collection.revision( );
+			mark.indexed = collection.size( );
+			return true;
+		}
+
+		/// <summary>
+		/// Forgets every indexed member.
+		/// </summary>
+		void Clear( );
+
+		/// <summary>
+		/// Returns a number which changes whenever this index is cleared, so that holders of what was found in it can tell it is being built again.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Number of times this index has been cleared.</returns>
+		unsigned long Generation( ) const;
+
+		/// <summary>
+		/// Appends the members indexed under the given name, in no particular order.
+		/// </summary>
+		/// <parameter name="name" IsConst="true">Name to look up.</parameter>
+		/// <parameter name="found">List which receives the members.</parameter>
+		/// <IsConstMember value="true"/>
+		void Find( const std::wstring& name , std::vector< const CodeObject* >& found ) const;
+	};
+}
+
+#endif
\ No newline at end of file
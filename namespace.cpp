@@ -1,5 +1,8 @@
 #include "namespace.h"
 #include "collections.h"
+#include "dependencygraph.h"
+#include "memberindex.h"
+#include "output.h"
 
 namespace CPlusPlusCodeProvider
 {
@@ -12,22 +15,65 @@ namespace CPlusPlusCodeProvider
 		const Namespace& ref = cast< Namespace >( object );
 		codeblock.reset( new CodeCollection( *ref.codeblock ) );
 		name = ref.name;
+		if( index.get( ) )
+			index -> Clear( );
+		Invalidate( );
 		return *this;
 	}
 
 	Comment& Namespace::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	Namespace::Namespace( const wstring& str )
-		 : name( str ) , codeblock( new CodeCollection( ) ) , comment( Comment::Instantiate( ) )
+		 : arena( 0 ) , name( str ) , codeblock( new CodeCollection( ) )
 	{
+		tag( NodeKind::Namespace );
 	}
 
 	Namespace::Namespace( const Namespace& other )
-		 : name( other.name ) , codeblock( new CodeCollection( *other.codeblock ) ) , comment( other.comment )
+		 : arena( 0 ) , name( other.name ) , codeblock( new CodeCollection( *other.codeblock ) ) , comment( other.comment ) , index( other.index.get( ) ? new MemberIndex : 0 )
 	{
+		tag( other.Kind( ) );
+	}
+
+	Namespace::~Namespace( )
+	{
+		if( arena )
+			arena -> Release( );
+	}
+
+	copying_pointer< Namespace > Namespace::Clone( ) const
+	{
+		CodeArena& target = CodeArena::Instantiate( );
+		try
+		{
+			CodeArena::Scope scope( target );
+			CloneScope clone;
+			copying_pointer< Namespace > copy( Duplicate( ) );
+			CloneScope::Copied( *this , *copy );
+			clone.Complete( );
+			copy -> arena = &target;
+			return copy;
+		}
+		catch( ... )
+		{
+			target.Release( );
+			throw;
+		}
+	}
+
+	CodeArena& Namespace::Arena( )
+	{
+		if( !arena )
+			arena = &CodeArena::Instantiate( );
+		return *arena;
+	}
+
+	const wstring& Namespace::Name( ) const
+	{
+		return name;
 	}
 
 	Namespace& Namespace::Duplicate( ) const
@@ -40,45 +86,131 @@ namespace CPlusPlusCodeProvider
 		return *codeblock;
 	}
 
-	void Namespace::writetext( wostream& os , unsigned long tabs ) const
+	bool Namespace::Indexed( ) const
+	{
+		return index.get( ) != 0;
+	}
+
+	Namespace& Namespace::Indexed( bool flag )
+	{
+		if( !flag )
+			index.reset( );
+		else if( !index.get( ) )
+			index.reset( new MemberIndex );
+		return *this;
+	}
+
+	void Namespace::Find( const wstring& name , std::vector< const CodeObject* >& members ) const
+	{
+		if( index.get( ) )
+		{
+			if( !index -> Update( 0 , *codeblock ) )
+			{
+				index -> Clear( );
+				index -> Update( 0 , *codeblock );
+			}
+			index -> Find( name , members );
+		}
+		else
+		{
+			MemberIndex scan;
+			scan.Update( 0 , *codeblock );
+			scan.Find( name , members );
+		}
+	}
+
+	void Namespace::writeheading( wostream& os , unsigned long tabs ) const
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab << L"namespace";
-		if( name.length( ) )
+		if( !name.Empty( ) )
 			os << L' ' << name;
 		os << L'\n' << tab << L'{' << L'\n';
+	}
+
+	void Namespace::writedefinitionheading( wostream& os , unsigned long tabs ) const
+	{
+		wstring tab( tabs , FormattingData::IndentationCharacter );
+		os << tab << L"namespace";
+		if( !name.Empty( ) )
+			os << L' ' << name;
+		os << FormattingData::IndentationCharacter << tab << L"{\n";
+	}
+
+	EmissionOrder Namespace::emissionorder( ) const
+	{
+		EmissionOrder order;
+		if( !cachedorder( order ) )
+		{
+			order = DependencyGraph::Order( *codeblock );
+			cacheorder( order );
+		}
+		return order;
+	}
+
+	void Namespace::writetext( wostream& os , unsigned long tabs ) const
+	{
+		wstring tab( tabs , FormattingData::IndentationCharacter );
+		writeheading( os , tabs );
 		++tabs;
-		for( CodeCollection::const_iterator i = codeblock -> begin( ) ; i != codeblock -> end( ) ; ++i )
-			( **i ).write( os , tabs );
+		EmissionOrder order = emissionorder( );
+		for( EmissionOrder::const_iterator i = order.begin( ) ; i != order.end( ) ; ++i )
+			if( i -> Forward )
+				DependencyGraph::Declare( *i -> Node , os , tabs );
+			else
+				i -> Node -> write( os , tabs );
 		--tabs;
 		os << tab << L"}\n";
 	}
 
 	void Namespace::writetext( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
 	{
-		comment -> write( declos , decltabs );
-		if( !comment -> IsEmpty( ) )
-			declos << L'\n';
 		wstring tab( decltabs , FormattingData::IndentationCharacter ) , deftab( decltabs , FormattingData::IndentationCharacter );
-		declos << tab << L"namespace";
-		defos << deftab << L"namespace";
-		if( name.length( ) )
-		{
-			declos << L' ' << name;
-			defos << L' ' << name;
-		}
-		declos << L'\n' << tab << L'{' << L'\n';
-		defos << FormattingData::IndentationCharacter  << deftab << L"{\n";
+		writeheading( declos , decltabs );
+		writedefinitionheading( defos , decltabs );
 		++decltabs;
 		++deftabs;
-		for( CodeCollection::const_iterator i = codeblock -> begin( ) ; i != codeblock -> end( ) ; ++i )
-			( **i ).write( declos , defos , decltabs , deftabs );
+		EmissionOrder order = emissionorder( );
+		for( EmissionOrder::const_iterator i = order.begin( ) ; i != order.end( ) ; ++i )
+			if( i -> Forward )
+				DependencyGraph::Declare( *i -> Node , declos , decltabs );
+			else
+				i -> Node -> write( declos , defos , decltabs , deftabs );
 		--decltabs;
 		--deftabs;
 		declos << tab << L"}\n";
 		defos << deftab << L"}\n";
 	}
+
+	void Namespace::writetext( wostream& declos , wostream& defos , wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		OutputStream forwards;
+		wstring tab( decltabs , FormattingData::IndentationCharacter ) , deftab( decltabs , FormattingData::IndentationCharacter );
+		writeheading( declos , decltabs );
+		writedefinitionheading( defos , decltabs );
+		++decltabs;
+		++deftabs;
+		EmissionOrder order = emissionorder( );
+		for( EmissionOrder::const_iterator i = order.begin( ) ; i != order.end( ) ; ++i )
+			if( i -> Forward )
+				DependencyGraph::Declare( *i -> Node , declos , decltabs );
+			else
+				i -> Node -> write( declos , defos , forwards , decltabs , deftabs );
+		--decltabs;
+		--deftabs;
+		declos << tab << L"}\n";
+		defos << deftab << L"}\n";
+		if( !forwards.Empty( ) )
+		{
+			fwdos << tab << L"namespace";
+			if( !name.Empty( ) )
+				fwdos << L' ' << name;
+			fwdos << L'\n' << tab << L"{\n";
+			forwards.WriteTo( fwdos );
+			fwdos << tab << L"}\n";
+		}
+	}
 }
\ No newline at end of file
@@ -2,21 +2,31 @@
 #define NAMESPACE_HEADER
 
 #include <memory>
+#include <vector>
 #include "cppcodeprovider.h"
 
 namespace CPlusPlusCodeProvider
 {
-	typedef TypedCollection< copying_pointer< CodeObject > > CodeCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > CodeCollection;
+
+	class MemberIndex;
 
 	/// <summary>
 	/// Provides services that allow you to use a namespace in code-graph.
 	/// </summary>
 	class Namespace : public CodeObject
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+		friend class SymbolTable;
+		friend class CompilationUnit;
+
+		CodeArena* arena;
 		std::auto_ptr< CodeCollection > codeblock;
 
-		std::wstring name;
-		copying_pointer< Comment > comment;
+		Identifier name;
+		LazyComment comment;
+		mutable std::auto_ptr< MemberIndex > index;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this namespace.
@@ -46,6 +56,25 @@ namespace CPlusPlusCodeProvider
 		/// <parameter IsConst="true" name="object">Given object to assign to.</parameter>
 		/// <returns>This object with contents replaced by the given one.</returns>
 		Namespace& Assign( const CodeObject& object );
+		/// <summary>
+		/// Deep copies this namespace and everything declared in it into a new arena owned by the copy.
+		/// References between nodes of this namespace are redirected to their copies, those to nodes outside it are kept as they are.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A proxy object that behaves like the cloned Namespace.</returns>
+		copying_pointer< Namespace > Clone( ) const;
+
+		/// <summary>
+		/// Gives up this namespace's reference to its arena.
+		/// </summary>
+		~Namespace( );
+
+		/// <summary>
+		/// Provides access to the arena owned by this namespace, creating it on first use.
+		/// Nodes instantiated while a CodeArena::Scope for it is alive are allocated from it and its memory is returned in one shot once this namespace and all those nodes are gone.
+		/// </summary>
+		/// <returns>A reference to the arena owned by this namespace.</returns>
+		CodeArena& Arena( );
 
 		/// <summary>
 		/// Provides access to name of this namespace.
@@ -60,6 +89,27 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		/// <returns>A CodeCollection containing all the declarations.</returns>
 		CodeCollection& Declarations( ) const;
+
+		/// <summary>
+		/// Gets a value which tells if declarations in this namespace are found through a name index.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if this namespace keeps a declaration index.</returns>
+		bool Indexed( ) const;
+		/// <summary>
+		/// Turns the declaration name index of this namespace on or off.
+		/// </summary>
+		/// <parameter name="flag">True to keep an index, which costs memory for every declaration but makes Find take constant time.</parameter>
+		/// <returns>A reference to this object so that other operations can be cascaded.</returns>
+		Namespace& Indexed( bool flag );
+		/// <summary>
+		/// Finds the declarations in this namespace with the given name, overloads included. Without an index every declaration is scanned.
+		/// </summary>
+		/// <parameter name="name" IsConst="true">Name of the declarations.</parameter>
+		/// <parameter name="members">List which receives the declarations, in no particular order.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <remarks>Find updates the index with declarations added since it was last called, so it must not be called on the same namespace from several threads at once.</remarks>
+		void Find( const std::wstring& name , std::vector< const CodeObject* >& members ) const;
 	protected:
 		/// <summary>
 		/// Writes out the contents to the provided stream.
@@ -76,7 +126,37 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this Namespace.</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
+		/// <summary>
+		/// Writes out this object split across the two streams along with the forward declarations of the types in it, which are enclosed in this namespace only if there are any.
+		/// </summary>
+		/// <parameter name="declas">Declaration output stream.</parameter>
+		/// <parameter name="defos">Definition output stream.</parameter>
+		/// <parameter name="fwdos">Forward declaration output stream.</parameter>
+		/// <parameter name="tabs">Indentation for this Namespace.</parameter>
+		/// <IsConstMember value="true"/>
+		void writetext( std::wostream& declos , std::wostream& defos , std::wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const;
 	private:
+		/// <summary>
+		/// Writes out the comment, name and opening brace of this namespace to the declaration stream.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this Namespace.</parameter>
+		/// <IsConstMember value="true"/>
+		void writeheading( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Writes out the name and opening brace of this namespace to the definition stream.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for this Namespace.</parameter>
+		/// <IsConstMember value="true"/>
+		void writedefinitionheading( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Returns the order in which the declarations of this namespace are written out, which is only computed again once something written out as part of it changes.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Emissions for all the declarations of this namespace.</returns>
+		std::vector< Emission > emissionorder( ) const;
+
 		/// <summary>
 		/// Constructs a new Namespace object given it's name.
 		/// </summary>
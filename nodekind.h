@@ -0,0 +1,473 @@
+#ifndef NODEKIND_HEADER
+#define NODEKIND_HEADER
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// Tags which identify the concrete type of a node in code-graph, so that nodes can be told apart by a switch instead of through RTTI.
+	/// Tags follow a pre-order walk of the class hierarchy, every class and the classes derived from it occupy one contiguous range.
+	/// </summary>
+	struct NodeKind
+	{
+		enum Kind
+		{
+			Comment ,
+			CodeSnippet ,
+			Namespace ,
+			Typedefinition ,
+			PreprocessorDirective ,
+			MacroTestDirective ,
+			VariableDeclaration ,
+			VariableDeclarationList ,
+			Function ,
+			MemberFunction ,
+			Constructor ,
+			Destructor ,
+			Operator ,
+			MemberOperator ,
+			TypedefinedType ,
+			NontypeParameter ,
+			TypedParameter ,
+			TemplateTemplateParameter ,
+			BasicType ,
+			Union ,
+			Enumeration ,
+			UserDefinedType ,
+			FunctionPtr ,
+			MemFun ,
+			PointerToMember ,
+			PrefixExpression ,
+			PostfixExpression ,
+			ScopeResolutionExpression ,
+			BinaryExpression ,
+			ArgumentReference ,
+			Cast ,
+			ConditionalExpression ,
+			VariableReference ,
+			LambdaCapture ,
+			CallExpression ,
+			MethodReference ,
+			NewExpression ,
+			ParenthesizedExpression ,
+			DeleteExpression ,
+			ThrowExpression ,
+			PrimitiveExpression ,
+			LambdaExpression ,
+			UsingStatement ,
+			ExpressionStatement ,
+			JumpStatement ,
+			LabelStatement ,
+			StatementBlock ,
+			CatchClause ,
+			Case ,
+			TryCatchClause ,
+			ConditionClause ,
+			ForLoop ,
+			WhileLoop ,
+			DoWhileLoop ,
+			SwitchStatement ,
+			/// <summary>
+			/// Number of kinds, also carried by a node whose constructor has not tagged it yet.
+			/// </summary>
+			Count
+		};
+	};
+
+	class CodeObject;
+	class Comment;
+	class CodeSnippet;
+	class Namespace;
+	class Typedefinition;
+	class PreprocessorDirective;
+	class MacroTestDirective;
+	class Declaration;
+	class VariableDeclaration;
+	class VariableDeclarationList;
+	class Function;
+	class MemberFunction;
+	class Constructor;
+	class Destructor;
+	class Operator;
+	class MemberOperator;
+	class Type;
+	class TypedefinedType;
+	class TemplateParameter;
+	class NontypeParameter;
+	class TypedParameter;
+	class TemplateTemplateParameter;
+	class BasicType;
+	class Union;
+	class Enumeration;
+	class UserDefinedType;
+	class FunctionPtr;
+	class MemFun;
+	class PointerToMember;
+	class Expression;
+	class UnaryExpression;
+	class PrefixExpression;
+	class PostfixExpression;
+	class ScopeResolutionExpression;
+	class BinaryExpression;
+	class ArgumentReference;
+	class Cast;
+	class ConditionalExpression;
+	class VariableReference;
+	class LambdaCapture;
+	class CallExpression;
+	class MethodReference;
+	class NewExpression;
+	class ParenthesizedExpression;
+	class DeleteExpression;
+	class ThrowExpression;
+	class PrimitiveExpression;
+	class LambdaExpression;
+	class Statement;
+	class UsingStatement;
+	class ExpressionStatement;
+	class JumpStatement;
+	class LabelStatement;
+	class StatementBlock;
+	class CatchClause;
+	class Case;
+	class TryCatchClause;
+	class ConditionClause;
+	class IterationClause;
+	class ForLoop;
+	class WhileLoop;
+	class DoWhileLoop;
+	class SwitchStatement;
+
+	/// <summary>
+	/// Range of kinds carried by nodes of type T and the types derived from it.
+	/// </summary>
+	/// <requirements>T must be CodeObject or a type derived from it.</requirements>
+	template< typename T > struct NodeKindRange;
+
+	template< > struct NodeKindRange< CodeObject >
+	{
+		static const NodeKind::Kind First = NodeKind::Comment , Last = NodeKind::SwitchStatement;
+	};
+
+	template< > struct NodeKindRange< Comment >
+	{
+		static const NodeKind::Kind First = NodeKind::Comment , Last = NodeKind::Comment;
+	};
+
+	template< > struct NodeKindRange< CodeSnippet >
+	{
+		static const NodeKind::Kind First = NodeKind::CodeSnippet , Last = NodeKind::CodeSnippet;
+	};
+
+	template< > struct NodeKindRange< Namespace >
+	{
+		static const NodeKind::Kind First = NodeKind::Namespace , Last = NodeKind::Namespace;
+	};
+
+	template< > struct NodeKindRange< Typedefinition >
+	{
+		static const NodeKind::Kind First = NodeKind::Typedefinition , Last = NodeKind::Typedefinition;
+	};
+
+	template< > struct NodeKindRange< PreprocessorDirective >
+	{
+		static const NodeKind::Kind First = NodeKind::PreprocessorDirective , Last = NodeKind::MacroTestDirective;
+	};
+
+	template< > struct NodeKindRange< MacroTestDirective >
+	{
+		static const NodeKind::Kind First = NodeKind::MacroTestDirective , Last = NodeKind::MacroTestDirective;
+	};
+
+	template< > struct NodeKindRange< Declaration >
+	{
+		static const NodeKind::Kind First = NodeKind::VariableDeclaration , Last = NodeKind::VariableDeclarationList;
+	};
+
+	template< > struct NodeKindRange< VariableDeclaration >
+	{
+		static const NodeKind::Kind First = NodeKind::VariableDeclaration , Last = NodeKind::VariableDeclaration;
+	};
+
+	template< > struct NodeKindRange< VariableDeclarationList >
+	{
+		static const NodeKind::Kind First = NodeKind::VariableDeclarationList , Last = NodeKind::VariableDeclarationList;
+	};
+
+	template< > struct NodeKindRange< Function >
+	{
+		static const NodeKind::Kind First = NodeKind::Function , Last = NodeKind::MemberOperator;
+	};
+
+	template< > struct NodeKindRange< MemberFunction >
+	{
+		static const NodeKind::Kind First = NodeKind::MemberFunction , Last = NodeKind::MemberFunction;
+	};
+
+	template< > struct NodeKindRange< Constructor >
+	{
+		static const NodeKind::Kind First = NodeKind::Constructor , Last = NodeKind::Constructor;
+	};
+
+	template< > struct NodeKindRange< Destructor >
+	{
+		static const NodeKind::Kind First = NodeKind::Destructor , Last = NodeKind::Destructor;
+	};
+
+	template< > struct NodeKindRange< Operator >
+	{
+		static const NodeKind::Kind First = NodeKind::Operator , Last = NodeKind::MemberOperator;
+	};
+
+	template< > struct NodeKindRange< MemberOperator >
+	{
+		static const NodeKind::Kind First = NodeKind::MemberOperator , Last = NodeKind::MemberOperator;
+	};
+
+	template< > struct NodeKindRange< Type >
+	{
+		static const NodeKind::Kind First = NodeKind::TypedefinedType , Last = NodeKind::PointerToMember;
+	};
+
+	template< > struct NodeKindRange< TypedefinedType >
+	{
+		static const NodeKind::Kind First = NodeKind::TypedefinedType , Last = NodeKind::TypedefinedType;
+	};
+
+	template< > struct NodeKindRange< TemplateParameter >
+	{
+		static const NodeKind::Kind First = NodeKind::NontypeParameter , Last = NodeKind::TemplateTemplateParameter;
+	};
+
+	template< > struct NodeKindRange< NontypeParameter >
+	{
+		static const NodeKind::Kind First = NodeKind::NontypeParameter , Last = NodeKind::NontypeParameter;
+	};
+
+	template< > struct NodeKindRange< TypedParameter >
+	{
+		static const NodeKind::Kind First = NodeKind::TypedParameter , Last = NodeKind::TypedParameter;
+	};
+
+	template< > struct NodeKindRange< TemplateTemplateParameter >
+	{
+		static const NodeKind::Kind First = NodeKind::TemplateTemplateParameter , Last = NodeKind::TemplateTemplateParameter;
+	};
+
+	template< > struct NodeKindRange< BasicType >
+	{
+		static const NodeKind::Kind First = NodeKind::BasicType , Last = NodeKind::BasicType;
+	};
+
+	template< > struct NodeKindRange< Union >
+	{
+		static const NodeKind::Kind First = NodeKind::Union , Last = NodeKind::Union;
+	};
+
+	template< > struct NodeKindRange< Enumeration >
+	{
+		static const NodeKind::Kind First = NodeKind::Enumeration , Last = NodeKind::Enumeration;
+	};
+
+	template< > struct NodeKindRange< UserDefinedType >
+	{
+		static const NodeKind::Kind First = NodeKind::UserDefinedType , Last = NodeKind::UserDefinedType;
+	};
+
+	template< > struct NodeKindRange< FunctionPtr >
+	{
+		static const NodeKind::Kind First = NodeKind::FunctionPtr , Last = NodeKind::MemFun;
+	};
+
+	template< > struct NodeKindRange< MemFun >
+	{
+		static const NodeKind::Kind First = NodeKind::MemFun , Last = NodeKind::MemFun;
+	};
+
+	template< > struct NodeKindRange< PointerToMember >
+	{
+		static const NodeKind::Kind First = NodeKind::PointerToMember , Last = NodeKind::PointerToMember;
+	};
+
+	template< > struct NodeKindRange< Expression >
+	{
+		static const NodeKind::Kind First = NodeKind::PrefixExpression , Last = NodeKind::LambdaExpression;
+	};
+
+	template< > struct NodeKindRange< UnaryExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::PrefixExpression , Last = NodeKind::PostfixExpression;
+	};
+
+	template< > struct NodeKindRange< PrefixExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::PrefixExpression , Last = NodeKind::PrefixExpression;
+	};
+
+	template< > struct NodeKindRange< PostfixExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::PostfixExpression , Last = NodeKind::PostfixExpression;
+	};
+
+	template< > struct NodeKindRange< ScopeResolutionExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::ScopeResolutionExpression , Last = NodeKind::ScopeResolutionExpression;
+	};
+
+	template< > struct NodeKindRange< BinaryExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::BinaryExpression , Last = NodeKind::BinaryExpression;
+	};
+
+	template< > struct NodeKindRange< ArgumentReference >
+	{
+		static const NodeKind::Kind First = NodeKind::ArgumentReference , Last = NodeKind::ArgumentReference;
+	};
+
+	template< > struct NodeKindRange< Cast >
+	{
+		static const NodeKind::Kind First = NodeKind::Cast , Last = NodeKind::Cast;
+	};
+
+	template< > struct NodeKindRange< ConditionalExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::ConditionalExpression , Last = NodeKind::ConditionalExpression;
+	};
+
+	template< > struct NodeKindRange< VariableReference >
+	{
+		static const NodeKind::Kind First = NodeKind::VariableReference , Last = NodeKind::LambdaCapture;
+	};
+
+	template< > struct NodeKindRange< LambdaCapture >
+	{
+		static const NodeKind::Kind First = NodeKind::LambdaCapture , Last = NodeKind::LambdaCapture;
+	};
+
+	template< > struct NodeKindRange< CallExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::CallExpression , Last = NodeKind::CallExpression;
+	};
+
+	template< > struct NodeKindRange< MethodReference >
+	{
+		static const NodeKind::Kind First = NodeKind::MethodReference , Last = NodeKind::MethodReference;
+	};
+
+	template< > struct NodeKindRange< NewExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::NewExpression , Last = NodeKind::NewExpression;
+	};
+
+	template< > struct NodeKindRange< ParenthesizedExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::ParenthesizedExpression , Last = NodeKind::ParenthesizedExpression;
+	};
+
+	template< > struct NodeKindRange< DeleteExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::DeleteExpression , Last = NodeKind::DeleteExpression;
+	};
+
+	template< > struct NodeKindRange< ThrowExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::ThrowExpression , Last = NodeKind::ThrowExpression;
+	};
+
+	template< > struct NodeKindRange< PrimitiveExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::PrimitiveExpression , Last = NodeKind::PrimitiveExpression;
+	};
+
+	template< > struct NodeKindRange< LambdaExpression >
+	{
+		static const NodeKind::Kind First = NodeKind::LambdaExpression , Last = NodeKind::LambdaExpression;
+	};
+
+	template< > struct NodeKindRange< Statement >
+	{
+		static const NodeKind::Kind First = NodeKind::UsingStatement , Last = NodeKind::SwitchStatement;
+	};
+
+	template< > struct NodeKindRange< UsingStatement >
+	{
+		static const NodeKind::Kind First = NodeKind::UsingStatement , Last = NodeKind::UsingStatement;
+	};
+
+	template< > struct NodeKindRange< ExpressionStatement >
+	{
+		static const NodeKind::Kind First = NodeKind::ExpressionStatement , Last = NodeKind::ExpressionStatement;
+	};
+
+	template< > struct NodeKindRange< JumpStatement >
+	{
+		static const NodeKind::Kind First = NodeKind::JumpStatement , Last = NodeKind::JumpStatement;
+	};
+
+	template< > struct NodeKindRange< LabelStatement >
+	{
+		static const NodeKind::Kind First = NodeKind::LabelStatement , Last = NodeKind::LabelStatement;
+	};
+
+	template< > struct NodeKindRange< StatementBlock >
+	{
+		static const NodeKind::Kind First = NodeKind::StatementBlock , Last = NodeKind::DoWhileLoop;
+	};
+
+	template< > struct NodeKindRange< CatchClause >
+	{
+		static const NodeKind::Kind First = NodeKind::CatchClause , Last = NodeKind::CatchClause;
+	};
+
+	template< > struct NodeKindRange< Case >
+	{
+		static const NodeKind::Kind First = NodeKind::Case , Last = NodeKind::Case;
+	};
+
+	template< > struct NodeKindRange< TryCatchClause >
+	{
+		static const NodeKind::Kind First = NodeKind::TryCatchClause , Last = NodeKind::TryCatchClause;
+	};
+
+	template< > struct NodeKindRange< ConditionClause >
+	{
+		static const NodeKind::Kind First = NodeKind::ConditionClause , Last = NodeKind::ConditionClause;
+	};
+
+	template< > struct NodeKindRange< IterationClause >
+	{
+		static const NodeKind::Kind First = NodeKind::ForLoop , Last = NodeKind::DoWhileLoop;
+	};
+
+	template< > struct NodeKindRange< ForLoop >
+	{
+		static const NodeKind::Kind First = NodeKind::ForLoop , Last = NodeKind::ForLoop;
+	};
+
+	template< > struct NodeKindRange< WhileLoop >
+	{
+		static const NodeKind::Kind First = NodeKind::WhileLoop , Last = NodeKind::WhileLoop;
+	};
+
+	template< > struct NodeKindRange< DoWhileLoop >
+	{
+		static const NodeKind::Kind First = NodeKind::DoWhileLoop , Last = NodeKind::DoWhileLoop;
+	};
+
+	template< > struct NodeKindRange< SwitchStatement >
+	{
+		static const NodeKind::Kind First = NodeKind::SwitchStatement , Last = NodeKind::SwitchStatement;
+	};
+
+	/// <summary>
+	/// Tells whether a node carrying the given kind is of type T or of a type derived from it.
+	/// </summary>
+	/// <parameter name="kind">Kind carried by the node.</parameter>
+	/// <returns>True if the node is a T, otherwise, false.</returns>
+	/// <requirements>T must be CodeObject or a type derived from it.</requirements>
+	template< typename T > bool IsKindOf( NodeKind::Kind kind )
+	{
+		return kind >= NodeKindRange< T >::First && kind <= NodeKindRange< T >::Last;
+	}
+}
+
+#endif
\ No newline at end of file
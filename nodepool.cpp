@@ -0,0 +1,37 @@
+#include "nodepool.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::lock_guard;
+	using std::mutex;
+
+	NodePool::NodePool( )
+	{
+	}
+
+	NodePool::~NodePool( )
+	{
+		for( auto iter = nodes.begin( ) ; iter != nodes.end( ) ; ++iter )
+			delete iter -> second;
+	}
+
+	CodeObject& NodePool::intern( const CodeObject& node )
+	{
+		unsigned long long hash = node.Hash( );
+		lock_guard< mutex > guard( lock );
+		auto range = nodes.equal_range( hash );
+		for( auto iter = range.first ; iter != range.second ; ++iter )
+			if( iter -> second -> Equals( node ) )
+				return *iter -> second;
+		CodeObject& copy = node.Duplicate( );
+		copy.interned = true;
+		nodes.insert( std::make_pair( hash , &copy ) );
+		return copy;
+	}
+
+	std::size_t NodePool::Size( ) const
+	{
+		lock_guard< mutex > guard( lock );
+		return nodes.size( );
+	}
+}
\ No newline at end of file
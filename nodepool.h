@@ -0,0 +1,83 @@
+#ifndef NODEPOOL_HEADER
+#define NODEPOOL_HEADER
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include "cppcodeprovider.h"
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// A hash-consing factory which keeps one immutable copy of every distinct object given to it, so memory scales with the number of distinct subtrees rather than their occurrences.
+	/// Objects are matched by structural hash and Equals, the pooled copy is marked interned and shared by every copying_pointer which holds it instead of being copied.
+	/// The pool hands its objects out through copying_pointers to constant objects, which can only read them. Once moved into a graph, holders that modify a pooled object get a private copy first, objects that only refer to it, such as declarations referring to their type, must not modify it.
+	/// </summary>
+	/// <remarks>The pool owns its objects and must outlive every graph which holds or refers to them. Lookups are synchronized, so one pool may be shared by several threads.</remarks>
+	class NodePool
+	{
+		std::unordered_multimap< unsigned long long , CodeObject* > nodes;
+		mutable std::mutex lock;
+
+		NodePool( const NodePool& );
+		NodePool& operator = ( const NodePool& );
+
+		/// <summary>
+		/// Finds the pooled object equal to the given one, adding an interned copy of it if there is none.
+		/// </summary>
+		/// <parameter name="node" IsConst="true">Object to look up.</parameter>
+		/// <returns>A reference to the pooled object.</returns>
+		CodeObject& intern( const CodeObject& node );
+	public:
+		/// <summary>
+		/// Constructs an empty pool.
+		/// </summary>
+		NodePool( );
+		/// <summary>
+		/// Deletes every pooled object.
+		/// </summary>
+		~NodePool( );
+
+		/// <summary>
+		/// Returns a copying_pointer to the pooled object equal to the given one, copies of it share the pooled object.
+		/// </summary>
+		/// <parameter name="node" IsConst="true">Object to look up, it is copied into the pool if no equal object is pooled yet.</parameter>
+		/// <returns>A copying_pointer holding the pooled object, through which it can only be read.</returns>
+		/// <remarks>Moving the result into a copying_pointer to a non-constant object keeps sharing the pooled object, but any non-constant access through that pointer, even one which only reads it, replaces the object with a private copy first.</remarks>
+		template< typename T > copying_pointer< const T > Intern( const T& node )
+		{
+			copying_pointer< const T > pooled;
+			pooled = &static_cast< const T& >( intern( node ) );
+			return pooled;
+		}
+
+		/// <summary>
+		/// Returns a copying_pointer to the pooled object equal to the one held by given pointer, copies of it share the pooled object.
+		/// </summary>
+		/// <parameter name="node" IsConst="true">Pointer to the object to look up, must not be null.</parameter>
+		/// <returns>A copying_pointer holding the pooled object, through which it can only be read.</returns>
+		template< typename T > copying_pointer< const T > Intern( const copying_pointer< T >& node )
+		{
+			return Intern( *node );
+		}
+
+		/// <summary>
+		/// Returns the pooled object equal to the given one, for use where objects are referred to rather than owned such as the type of a declaration.
+		/// </summary>
+		/// <parameter name="node" IsConst="true">Object to look up, it is copied into the pool if no equal object is pooled yet.</parameter>
+		/// <returns>A reference to the pooled object, which must not be modified.</returns>
+		template< typename T > T& Canonical( const T& node )
+		{
+			return static_cast< T& >( intern( node ) );
+		}
+
+		/// <summary>
+		/// Returns the number of distinct objects in this pool.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Number of pooled objects.</returns>
+		std::size_t Size( ) const;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "output.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::wstring;
+	using std::wostream;
+
+	OutputBuffer::OutputBuffer( )
+	{
+	}
+
+	OutputBuffer& OutputBuffer::Append( const wchar_t* text , std::size_t count )
+	{
+		data.insert( data.end( ) , text , text + count );
+		return *this;
+	}
+
+	OutputBuffer& OutputBuffer::Append( const wstring& text )
+	{
+		return Append( text.data( ) , text.size( ) );
+	}
+
+	OutputBuffer& OutputBuffer::Append( const wchar_t* text )
+	{
+		return Append( text , std::char_traits< wchar_t >::length( text ) );
+	}
+
+	OutputBuffer& OutputBuffer::Append( wchar_t c )
+	{
+		data.push_back( c );
+		return *this;
+	}
+
+	void OutputBuffer::Reserve( std::size_t count )
+	{
+		data.reserve( count );
+	}
+
+	void OutputBuffer::Clear( )
+	{
+		data.clear( );
+	}
+
+	std::size_t OutputBuffer::Size( ) const
+	{
+		return data.size( );
+	}
+
+	bool OutputBuffer::Empty( ) const
+	{
+		return data.empty( );
+	}
+
+	const wchar_t* OutputBuffer::Data( ) const
+	{
+		return data.empty( ) ? L"" : &data[ 0 ];
+	}
+
+	wstring OutputBuffer::Text( ) const
+	{
+		return wstring( Data( ) , Size( ) );
+	}
+
+	void OutputBuffer::WriteTo( wostream& os ) const
+	{
+		if( data.size( ) )
+			os.write( &data[ 0 ] , data.size( ) );
+	}
+
+	std::string OutputBuffer::Utf8( ) const
+	{
+		std::string encoded;
+		encoded.reserve( data.size( ) + data.size( ) / 8 );
+		for( std::size_t i = 0 ; i < data.size( ) ; ++i )
+		{
+			unsigned long c = static_cast< unsigned long >( data[ i ] );
+			if( sizeof( wchar_t ) == 2 && c >= 0xD800 && c < 0xDC00 && i + 1 < data.size( ) )
+			{
+				unsigned long low = static_cast< unsigned long >( data[ i + 1 ] );
+				if( low >= 0xDC00 && low < 0xE000 )
+				{
+					c = 0x10000 + ( ( c - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+					++i;
+				}
+			}
+			if( c < 0x80 )
+				encoded.push_back( static_cast< char >( c ) );
+			else if( c < 0x800 )
+			{
+				encoded.push_back( static_cast< char >( 0xC0 | ( c >> 6 ) ) );
+				encoded.push_back( static_cast< char >( 0x80 | ( c & 0x3F ) ) );
+			}
+			else if( c < 0x10000 )
+			{
+				encoded.push_back( static_cast< char >( 0xE0 | ( c >> 12 ) ) );
+				encoded.push_back( static_cast< char >( 0x80 | ( ( c >> 6 ) & 0x3F ) ) );
+				encoded.push_back( static_cast< char >( 0x80 | ( c & 0x3F ) ) );
+			}
+			else
+			{
+				encoded.push_back( static_cast< char >( 0xF0 | ( c >> 18 ) ) );
+				encoded.push_back( static_cast< char >( 0x80 | ( ( c >> 12 ) & 0x3F ) ) );
+				encoded.push_back( static_cast< char >( 0x80 | ( ( c >> 6 ) & 0x3F ) ) );
+				encoded.push_back( static_cast< char >( 0x80 | ( c & 0x3F ) ) );
+			}
+		}
+		return encoded;
+	}
+
+	void OutputBuffer::WriteUtf8To( std::ostream& os ) const
+	{
+		const std::string encoded = Utf8( );
+		os.write( encoded.data( ) , encoded.size( ) );
+	}
+
+	OutputBuffer* OutputBuffer::Of( wostream& os )
+	{
+		return dynamic_cast< OutputBuffer* >( os.rdbuf( ) );
+	}
+
+	OutputBuffer::int_type OutputBuffer::overflow( int_type c )
+	{
+		if( traits_type::eq_int_type( c , traits_type::eof( ) ) )
+			return traits_type::not_eof( c );
+		data.push_back( traits_type::to_char_type( c ) );
+		return c;
+	}
+
+	std::streamsize OutputBuffer::xsputn( const wchar_t* text , std::streamsize count )
+	{
+		Append( text , static_cast< std::size_t >( count ) );
+		return count;
+	}
+
+	OutputStream::OutputStream( )
+		: std::wostream( 0 )
+	{
+		rdbuf( &buffer );
+	}
+
+	OutputBuffer& OutputStream::Buffer( )
+	{
+		return buffer;
+	}
+
+	const OutputBuffer& OutputStream::Buffer( ) const
+	{
+		return buffer;
+	}
+
+	bool OutputStream::Empty( ) const
+	{
+		return buffer.Empty( );
+	}
+
+	void OutputStream::WriteTo( wostream& os ) const
+	{
+		buffer.WriteTo( os );
+	}
+
+	void OutputStream::WriteUtf8To( std::ostream& os ) const
+	{
+		buffer.WriteUtf8To( os );
+	}
+
+	wstring OutputStream::str( ) const
+	{
+		return buffer.Text( );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#ifndef OUTPUT_HEADER
+#define OUTPUT_HEADER
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// An append-only growable character buffer which code-graph constructs render into.
+	/// Text handed to it goes straight into contiguous storage without formatting or locale lookups.
+	/// </summary>
+	class OutputBuffer : public std::wstreambuf
+	{
+		std::vector< wchar_t > data;
+
+		OutputBuffer( const OutputBuffer& );
+		OutputBuffer& operator = ( const OutputBuffer& );
+	public:
+		/// <summary>
+		/// Constructs an empty OutputBuffer.
+		/// </summary>
+		OutputBuffer( );
+
+		/// <summary>
+		/// Appends a sequence of characters to the end of this buffer.
+		/// </summary>
+		/// <parameter name="text" IsConst="true">First character to append.</parameter>
+		/// <parameter name="count">Number of characters to append.</parameter>
+		/// <returns>A reference to this object.</returns>
+		OutputBuffer& Append( const wchar_t* text , std::size_t count );
+
+		/// <summary>
+		/// Appends a string to the end of this buffer.
+		/// </summary>
+		/// <parameter name="text" IsConst="true">String to append.</parameter>
+		/// <returns>A reference to this object.</returns>
+		OutputBuffer& Append( const std::wstring& text );
+
+		/// <summary>
+		/// Appends a null terminated string to the end of this buffer.
+		/// </summary>
+		/// <parameter name="text" IsConst="true">String to append.</parameter>
+		/// <returns>A reference to this object.</returns>
+		OutputBuffer& Append( const wchar_t* text );
+
+		/// <summary>
+		/// Appends a single character to the end of this buffer.
+		/// </summary>
+		/// <parameter name="c">Character to append.</parameter>
+		/// <returns>A reference to this object.</returns>
+		OutputBuffer& Append( wchar_t c );
+
+		/// <summary>
+		/// Makes room for at least the given number of characters.
+		/// </summary>
+		/// <parameter name="count">Number of characters to make room for.</parameter>
+		void Reserve( std::size_t count );
+
+		/// <summary>
+		/// Discards the contents of this buffer, keeping its storage for reuse.
+		/// </summary>
+		void Clear( );
+
+		/// <summary>
+		/// Returns the number of characters in this buffer.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Number of characters appended since construction or the last Clear.</returns>
+		std::size_t Size( ) const;
+
+		/// <summary>
+		/// Tells whether anything has been written to this buffer.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if this buffer contains no characters, otherwise, false.</returns>
+		bool Empty( ) const;
+
+		/// <summary>
+		/// Provides access to the contents of this buffer, which are not null terminated.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A pointer to the first character, only valid until the next modification.</returns>
+		const wchar_t* Data( ) const;
+
+		/// <summary>
+		/// Returns a copy of the contents of this buffer.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A string containing all the characters in this buffer.</returns>
+		std::wstring Text( ) const;
+
+		/// <summary>
+		/// Writes out the contents of this buffer to the given stream in one go.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <IsConstMember value="true"/>
+		void WriteTo( std::wostream& os ) const;
+
+		/// <summary>
+		/// Writes out the contents of this buffer to the given narrow stream encoded as UTF-8, without going through a locale or codecvt facet.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the encoded output.</parameter>
+		/// <IsConstMember value="true"/>
+		void WriteUtf8To( std::ostream& os ) const;
+
+		/// <summary>
+		/// Returns the contents of this buffer encoded as UTF-8.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A narrow string holding the encoded contents.</returns>
+		std::string Utf8( ) const;
+
+		/// <summary>
+		/// Finds the OutputBuffer a stream renders into, so writers can append to it directly.
+		/// Appending to it and writing through the stream may be mixed, since this buffer keeps no pending characters.
+		/// </summary>
+		/// <parameter name="os">Stream to look at.</parameter>
+		/// <returns>The buffer of the given stream, or null if it does not render into an OutputBuffer.</returns>
+		static OutputBuffer* Of( std::wostream& os );
+	protected:
+		/// <summary>
+		/// Appends a single character, called by the stream for unbuffered character output.
+		/// </summary>
+		/// <parameter name="c">Character to append.</parameter>
+		/// <returns>The given character, or eof if c was eof.</returns>
+		int_type overflow( int_type c );
+
+		/// <summary>
+		/// Appends a sequence of characters, called by the stream for string output.
+		/// </summary>
+		/// <parameter name="text" IsConst="true">First character to append.</parameter>
+		/// <parameter name="count">Number of characters to append.</parameter>
+		/// <returns>Number of characters appended.</returns>
+		std::streamsize xsputn( const wchar_t* text , std::streamsize count );
+	};
+
+	/// <summary>
+	/// A std::wostream which renders into an OutputBuffer, so existing writers can use the buffer through their stream parameter.
+	/// </summary>
+	class OutputStream : public std::wostream
+	{
+		OutputBuffer buffer;
+
+		OutputStream( const OutputStream& );
+		OutputStream& operator = ( const OutputStream& );
+	public:
+		/// <summary>
+		/// Constructs an OutputStream over an empty buffer.
+		/// </summary>
+		OutputStream( );
+
+		/// <summary>
+		/// Provides access to the underlying buffer.
+		/// </summary>
+		/// <returns>A reference to the buffer this stream renders into.</returns>
+		OutputBuffer& Buffer( );
+
+		/// <summary>
+		/// Provides access to the underlying buffer.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A constant reference to the buffer this stream renders into.</returns>
+		const OutputBuffer& Buffer( ) const;
+
+		/// <summary>
+		/// Tells whether anything has been written to this stream.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if nothing has been written, otherwise, false.</returns>
+		bool Empty( ) const;
+
+		/// <summary>
+		/// Writes out everything rendered into this stream to the given stream in one go.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <IsConstMember value="true"/>
+		void WriteTo( std::wostream& os ) const;
+
+		/// <summary>
+		/// Writes out everything rendered into this stream to the given narrow stream encoded as UTF-8.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the encoded output.</parameter>
+		/// <IsConstMember value="true"/>
+		void WriteUtf8To( std::ostream& os ) const;
+
+		/// <summary>
+		/// Returns a copy of everything rendered into this stream.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A string containing the rendered text.</returns>
+		std::wstring str( ) const;
+	};
+}
+
+#endif
\ No newline at end of file
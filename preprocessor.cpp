@@ -10,6 +10,7 @@ namespace CPlusPlusCodeProvider
 	PreprocessorDirective& PreprocessorDirective::Assign( const CodeObject& object )
 	{
 		Assign( cast< PreprocessorDirective >( object ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -26,12 +27,13 @@ namespace CPlusPlusCodeProvider
 
 	Comment& PreprocessorDirective::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	PreprocessorDirective::PreprocessorDirective( const wstring& str , DirectiveType directivetype )
-		: directive( str ) , type( directivetype ) , comment( Comment::Instantiate( ) )
+		: directive( str ) , type( directivetype )
 	{
+		tag( NodeKind::PreprocessorDirective );
 	}
 
 	const wstring& PreprocessorDirective::Directive( ) const
@@ -52,6 +54,7 @@ namespace CPlusPlusCodeProvider
 	PreprocessorDirective& PreprocessorDirective::MultiLine( bool val )
 	{
 		multiline = val;
+		Invalidate( );
 		return *this;
 	}
 
@@ -62,8 +65,8 @@ namespace CPlusPlusCodeProvider
 
 	void PreprocessorDirective::writetext( wostream& os , unsigned long tabs ) const
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		switch( type )
 		{
@@ -95,6 +98,7 @@ namespace CPlusPlusCodeProvider
 		const MacroTestDirective& ref = cast< MacroTestDirective >( object );
 		PreprocessorDirective::Assign( ref );
 		*codeblock = *ref.codeblock;
+		Invalidate( );
 		return *this;
 	}
 
@@ -106,11 +110,13 @@ namespace CPlusPlusCodeProvider
 	MacroTestDirective::MacroTestDirective( const MacroTestDirective& other )
 		: codeblock( new CompilationUnit( *other.codeblock ) ) , PreprocessorDirective( other.Directive( ) )
 	{
+		tag( other.Kind( ) );
 	}
 
 	MacroTestDirective::MacroTestDirective( const wstring& directive )
 		: PreprocessorDirective( directive )
 	{
+		tag( NodeKind::MacroTestDirective );
 	}
 
 	CodeCollection& MacroTestDirective::Declarations( ) const
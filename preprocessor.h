@@ -11,9 +11,10 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class PreprocessorDirective : public CodeObject
 	{
+		friend class Snapshot;
 		std::wstring directive;//The preprocessor directive
 		bool multiline;//Used to tell if the directive spans multiple lines.
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this preprocessor directive.
@@ -134,13 +135,16 @@ namespace CPlusPlusCodeProvider
 	};
 
 	class CompilationUnit;
-	typedef TypedCollection< copying_pointer< CodeObject > > CodeCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > CodeCollection;
 
 	/// <summary>
 	/// Represents one of #if, #ifdef or #ifndef directives in code graph.
 	/// </summary>
 	class MacroTestDirective : public PreprocessorDirective
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::auto_ptr< CompilationUnit > codeblock;
 	public:
 		/// <summary>
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include "rendercache.h"
+#include "dependencygraph.h"
+
+using std::wstring;
+using std::wostream;
+
+namespace CPlusPlusCodeProvider
+{
+	struct RenderCache::State
+	{
+		typedef std::unordered_map< const State* , std::weak_ptr< State > > DependentMap;
+
+		/// <summary>
+		/// Renderings and the order of declarations of the owning construct, allocated only while renderings are stored.
+		/// </summary>
+		struct Memo
+		{
+			std::map< unsigned long , wstring > single;
+			std::map< std::pair< unsigned long , unsigned long > , std::pair< wstring , wstring > > split;
+			EmissionOrder order;
+			bool ordered;
+
+			Memo( )
+				: ordered( false )
+			{
+			}
+		};
+
+		/// <summary>
+		/// Keeps this state alive for as long as its RenderCache, constructs depending on it only hold weak references.
+		/// </summary>
+		std::shared_ptr< State > self;
+		std::mutex lock;
+		/// <summary>
+		/// RenderCache whose hash is discarded along with this state, null once it has gone away.
+		/// </summary>
+		const RenderCache* owner;
+		std::unique_ptr< DependentMap > dependents;
+		/// <summary>
+		/// Number of dependents at which renderings which went away are next dropped.
+		/// </summary>
+		std::size_t sweep;
+		std::unique_ptr< Memo > memo;
+
+		explicit State( const RenderCache& cache )
+			: owner( &cache ) , sweep( 16 )
+		{
+		}
+
+		void invalidate( )
+		{
+			std::unique_ptr< DependentMap > pending;
+			{
+				std::lock_guard< std::mutex > guard( lock );
+				if( owner )
+					owner -> hash = 0;
+				if( memo.get( ) )
+				{
+					memo -> single.clear( );
+					memo -> split.clear( );
+					memo -> order.clear( );
+					memo -> ordered = false;
+				}
+				pending.swap( dependents );
+				sweep = 16;
+			}
+			if( pending.get( ) )
+				for( DependentMap::const_iterator iter = pending -> begin( ) ; iter != pending -> end( ) ; ++iter )
+				{
+					std::shared_ptr< State > dependent = iter -> second.lock( );
+					if( dependent )
+						dependent -> invalidate( );
+				}
+		}
+	};
+
+	__declspec( thread ) RenderCache::State* RenderCache::current = 0;
+
+	RenderCache::RenderCache( )
+		: state( 0 ) , hash( 0 )
+	{
+	}
+
+	RenderCache::RenderCache( const RenderCache& )
+		: state( 0 ) , hash( 0 )
+	{
+	}
+
+	RenderCache& RenderCache::operator = ( const RenderCache& )
+	{
+		Invalidate( );
+		return *this;
+	}
+
+	RenderCache::~RenderCache( )
+	{
+		State* existing = state.load( );
+		if( existing )
+		{
+			{
+				std::lock_guard< std::mutex > guard( existing -> lock );
+				existing -> owner = 0;
+			}
+			std::shared_ptr< State > last;
+			last.swap( existing -> self );
+		}
+	}
+
+	RenderCache::State& RenderCache::acquire( ) const
+	{
+		State* existing = state.load( );
+		if( !existing )
+		{
+			State* fresh = new State( *this );
+			fresh -> self.reset( fresh );
+			if( state.compare_exchange_strong( existing , fresh ) )
+				existing = fresh;
+			else
+				fresh -> self.reset( );
+		}
+		return *existing;
+	}
+
+	bool RenderCache::Enabled( ) const
+	{
+		State* existing = state.load( );
+		return existing && existing -> memo.get( );
+	}
+
+	void RenderCache::Enabled( bool flag )
+	{
+		if( flag )
+		{
+			State& target = acquire( );
+			std::lock_guard< std::mutex > guard( target.lock );
+			if( !target.memo.get( ) )
+				target.memo.reset( new State::Memo( ) );
+		}
+		else if( Enabled( ) )
+		{
+			Invalidate( );
+			State& target = *state.load( );
+			std::lock_guard< std::mutex > guard( target.lock );
+			target.memo.reset( );
+		}
+	}
+
+	void RenderCache::Track( ) const
+	{
+		if( !current )
+			return;
+		State& target = acquire( );
+		if( &target == current )
+			return;
+
+		std::lock_guard< std::mutex > guard( target.lock );
+		if( !target.dependents.get( ) )
+			target.dependents.reset( new State::DependentMap( ) );
+		State::DependentMap& dependents = *target.dependents;
+		std::weak_ptr< State >& dependent = dependents[ current ];
+		// A state which went away may have left its address to the current one, so the entry is checked for being alive.
+		if( !dependent.expired( ) )
+			return;
+		dependent = current -> self;
+		// Renderings which went away are dropped once the map doubles, so tracking stays constant time on average and the map does not grow without bound.
+		if( dependents.size( ) >= target.sweep )
+		{
+			for( State::DependentMap::iterator iter = dependents.begin( ) ; iter != dependents.end( ) ; )
+				if( iter -> second.expired( ) )
+					iter = dependents.erase( iter );
+				else
+					++iter;
+			target.sweep = std::max< std::size_t >( 16 , dependents.size( ) * 2 );
+		}
+	}
+
+	void RenderCache::Invalidate( )
+	{
+		hash = 0;
+		State* existing = state.load( );
+		if( existing )
+			existing -> invalidate( );
+	}
+
+	bool RenderCache::Lookup( wostream& os , unsigned long tabs ) const
+	{
+		State* existing = state.load( );
+		if( !existing )
+			return false;
+		std::lock_guard< std::mutex > guard( existing -> lock );
+		if( !existing -> memo.get( ) )
+			return false;
+		std::map< unsigned long , wstring >::const_iterator found = existing -> memo -> single.find( tabs );
+		if( found == existing -> memo -> single.end( ) )
+			return false;
+		os.write( found -> second.data( ) , found -> second.size( ) );
+		return true;
+	}
+
+	bool RenderCache::Lookup( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		State* existing = state.load( );
+		if( !existing )
+			return false;
+		std::lock_guard< std::mutex > guard( existing -> lock );
+		if( !existing -> memo.get( ) )
+			return false;
+		std::map< std::pair< unsigned long , unsigned long > , std::pair< wstring , wstring > >::const_iterator found = existing -> memo -> split.find( std::make_pair( decltabs , deftabs ) );
+		if( found == existing -> memo -> split.end( ) )
+			return false;
+		declos.write( found -> second.first.data( ) , found -> second.first.size( ) );
+		defos.write( found -> second.second.data( ) , found -> second.second.size( ) );
+		return true;
+	}
+
+	void RenderCache::Store( const wstring& text , unsigned long tabs ) const
+	{
+		State* existing = state.load( );
+		if( !existing )
+			return;
+		std::lock_guard< std::mutex > guard( existing -> lock );
+		if( existing -> memo.get( ) )
+			existing -> memo -> single[ tabs ] = text;
+	}
+
+	void RenderCache::Store( const wstring& decltext , const wstring& deftext , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		State* existing = state.load( );
+		if( !existing )
+			return;
+		std::lock_guard< std::mutex > guard( existing -> lock );
+		if( existing -> memo.get( ) )
+			existing -> memo -> split[ std::make_pair( decltabs , deftabs ) ] = std::make_pair( decltext , deftext );
+	}
+
+	bool RenderCache::LookupHash( unsigned long long& value ) const
+	{
+		value = hash;
+		return value != 0;
+	}
+
+	void RenderCache::StoreHash( unsigned long long value ) const
+	{
+		hash = value;
+	}
+
+	bool RenderCache::LookupOrder( EmissionOrder& order ) const
+	{
+		State* existing = state.load( );
+		if( !existing )
+			return false;
+		std::lock_guard< std::mutex > guard( existing -> lock );
+		if( !existing -> memo.get( ) || !existing -> memo -> ordered )
+			return false;
+		order = existing -> memo -> order;
+		return true;
+	}
+
+	void RenderCache::StoreOrder( const EmissionOrder& order ) const
+	{
+		State* existing = state.load( );
+		if( !existing || existing != current )
+			return;
+		std::lock_guard< std::mutex > guard( existing -> lock );
+		if( !existing -> memo.get( ) )
+			return;
+		existing -> memo -> order = order;
+		existing -> memo -> ordered = true;
+	}
+
+	RenderCache::Frame::Frame( const RenderCache& cache )
+		: previous( current )
+	{
+		current = &cache.acquire( );
+	}
+
+	RenderCache::Frame::~Frame( )
+	{
+		current = previous;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef RENDERCACHE_HEADER
+#define RENDERCACHE_HEADER
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace CPlusPlusCodeProvider
+{
+	struct Emission;
+
+	/// <summary>
+	/// Remembers the text a code-graph construct rendered to, its structural hash, and which constructs' renderings include it.
+	/// Renderings are keyed by indentation and output mode, they and the hash are discarded when the construct, or anything that was rendered as part of it, is modified.
+	/// The hash is held inline. Which constructs depend on this one is allocated once one does, and renderings only while they are stored.
+	/// Copies of a RenderCache start out empty.
+	/// </summary>
+	class RenderCache
+	{
+		struct State;
+		mutable std::atomic< State* > state;
+		mutable std::atomic< unsigned long long > hash;
+
+		/// <summary>
+		/// Rendering being stored by this thread, null if there is none.
+		/// </summary>
+		static __declspec( thread ) State* current;
+
+		State& acquire( ) const;
+	public:
+		/// <summary>
+		/// Constructs an empty RenderCache which does not store renderings.
+		/// </summary>
+		RenderCache( );
+
+		/// <summary>
+		/// Constructs an empty RenderCache, nothing is copied from the given one.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">This parameter is not used.</parameter>
+		RenderCache( const RenderCache& other );
+
+		/// <summary>
+		/// Discards renderings of the construct which owns this RenderCache, nothing is copied from the given one.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">This parameter is not used.</parameter>
+		/// <returns>A reference to this object.</returns>
+		RenderCache& operator = ( const RenderCache& other );
+
+		/// <summary>
+		/// Discards all renderings and detaches from the constructs depending on this one.
+		/// </summary>
+		~RenderCache( );
+
+		/// <summary>
+		/// Returns whether renderings are stored.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if renderings are stored, otherwise, false.</returns>
+		bool Enabled( ) const;
+
+		/// <summary>
+		/// Turns storing of renderings on or off, turning it off discards stored renderings.
+		/// </summary>
+		/// <parameter name="flag">True to store renderings.</parameter>
+		void Enabled( bool flag );
+
+		/// <summary>
+		/// Records that the rendering in progress on the calling thread includes the construct which owns this RenderCache.
+		/// This function does nothing when no rendering is being stored.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		void Track( ) const;
+
+		/// <summary>
+		/// Discards renderings stored here and in every RenderCache whose rendering included the owning construct.
+		/// </summary>
+		void Invalidate( );
+
+		/// <summary>
+		/// Writes out a stored rendering for the given indentation, if there is one.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation the rendering was made with.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if a stored rendering was written out, otherwise, false.</returns>
+		bool Lookup( std::wostream& os , unsigned long tabs ) const;
+		bool Lookup( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
+
+		/// <summary>
+		/// Stores a rendering for the given indentation.
+		/// </summary>
+		/// <parameter name="text" IsConst="true">Rendered text.</parameter>
+		/// <parameter name="tabs">Indentation the rendering was made with.</parameter>
+		/// <IsConstMember value="true"/>
+		void Store( const std::wstring& text , unsigned long tabs ) const;
+		void Store( const std::wstring& decltext , const std::wstring& deftext , unsigned long decltabs , unsigned long deftabs ) const;
+
+		/// <summary>
+		/// Reads the stored structural hash of the owning construct, if there is one.
+		/// </summary>
+		/// <parameter name="value">Receives the hash.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if a hash was stored, otherwise, false.</returns>
+		bool LookupHash( unsigned long long& value ) const;
+
+		/// <summary>
+		/// Stores the structural hash of the owning construct, it is kept whether or not renderings are stored.
+		/// A hash of zero marks that none is stored, so such a hash is computed again whenever it is needed.
+		/// </summary>
+		/// <parameter name="value">Hash of the owning construct.</parameter>
+		/// <IsConstMember value="true"/>
+		void StoreHash( unsigned long long value ) const;
+
+		/// <summary>
+		/// Reads the stored order in which the owning construct writes out its declarations, if there is one.
+		/// </summary>
+		/// <parameter name="order">Receives the order.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if an order was stored, otherwise, false.</returns>
+		bool LookupOrder( std::vector< Emission >& order ) const;
+
+		/// <summary>
+		/// Stores the order in which the owning construct writes out its declarations, it is discarded along with the hash.
+		/// The order is only kept while renderings are stored and the owning construct is being rendered or hashed into this RenderCache, since only then is everything it depends upon recorded.
+		/// </summary>
+		/// <parameter name="order" IsConst="true">Order of the declarations of the owning construct.</parameter>
+		/// <IsConstMember value="true"/>
+		void StoreOrder( const std::vector< Emission >& order ) const;
+
+		/// <summary>
+		/// Makes a RenderCache current on the calling thread for the lifetime of this object, so that every construct rendered meanwhile is recorded as part of its rendering.
+		/// </summary>
+		class Frame
+		{
+			State* previous;
+
+			Frame( const Frame& );
+			Frame& operator = ( const Frame& );
+		public:
+			/// <summary>
+			/// Makes the given RenderCache current on the calling thread.
+			/// </summary>
+			/// <parameter name="cache" IsConst="true">RenderCache which records constructs rendered by this thread.</parameter>
+			explicit Frame( const RenderCache& cache );
+			/// <summary>
+			/// Restores the RenderCache which was current before this object was constructed.
+			/// </summary>
+			~Frame( );
+		};
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "rendercontext.h"
+
+using std::vector;
+
+namespace CPlusPlusCodeProvider
+{
+	RenderContext::RenderContext( )
+		: depth( 0 ) , separate( true )
+	{
+	}
+
+	RenderContext RenderContext::Nested( ) const
+	{
+		RenderContext context;
+		context.depth = depth + 1;
+		context.separate = false;
+		return context;
+	}
+
+	vector< const CodeObject* >& RenderContext::Backlog( )
+	{
+		return backlog;
+	}
+
+	const vector< const CodeObject* >& RenderContext::Backlog( ) const
+	{
+		return backlog;
+	}
+
+	unsigned long RenderContext::Depth( ) const
+	{
+		return depth;
+	}
+
+	bool RenderContext::Separate( ) const
+	{
+		return separate;
+	}
+
+	RenderContext& RenderContext::Separate( bool flag )
+	{
+		separate = flag;
+		return *this;
+	}
+}
\ No newline at end of file
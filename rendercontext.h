@@ -0,0 +1,69 @@
+#ifndef RENDERCONTEXT_HEADER
+#define RENDERCONTEXT_HEADER
+
+#include <vector>
+
+namespace CPlusPlusCodeProvider
+{
+	class CodeObject;
+
+	/// <summary>
+	/// Carries the state of a single rendering pass, so code objects need not keep any while they are written out.
+	/// Contexts are cheap to create and are never shared between threads.
+	/// </summary>
+	class RenderContext
+	{
+		std::vector< const CodeObject* > backlog;
+		unsigned long depth;
+		bool separate;
+	public:
+		/// <summary>
+		/// Constructs a context for writing out a top level construct.
+		/// </summary>
+		RenderContext( );
+
+		/// <summary>
+		/// Returns a context for writing out members of the construct being written with this context.
+		/// It has its own empty backlog, one more level of nesting and does not write definitions separately.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A context for writing out members.</returns>
+		RenderContext Nested( ) const;
+
+		/// <summary>
+		/// Provides access to the constructs which have to be written out after the one being written with this context.
+		/// </summary>
+		/// <returns>A reference to the backlog.</returns>
+		std::vector< const CodeObject* >& Backlog( );
+
+		/// <summary>
+		/// Provides access to the constructs which have to be written out after the one being written with this context.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A constant reference to the backlog.</returns>
+		const std::vector< const CodeObject* >& Backlog( ) const;
+
+		/// <summary>
+		/// Returns the number of enclosing constructs, zero for a top level construct.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Nesting depth of this context.</returns>
+		unsigned long Depth( ) const;
+
+		/// <summary>
+		/// Returns whether definitions are written separately from the body of their enclosing type, qualified with its name.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if definitions are written separately, false if they appear inside the body of the enclosing type.</returns>
+		bool Separate( ) const;
+
+		/// <summary>
+		/// Sets whether definitions are written separately from the body of their enclosing type, qualified with its name.
+		/// </summary>
+		/// <parameter name="flag">New value of the flag.</parameter>
+		/// <returns>A reference to this object.</returns>
+		RenderContext& Separate( bool flag );
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,1648 @@
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "snapshot.h"
+#include "collections.h"
+#include "declarations.h"
+#include "expressions.h"
+#include "functions.h"
+#include "namespace.h"
+#include "preprocessor.h"
+#include "statements.h"
+#include "typedefinition.h"
+#include "types.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::wstring;
+	using std::vector;
+	using std::invalid_argument;
+	using std::auto_ptr;
+
+	namespace
+	{
+		const char Magic[ ] = { 'C' , 'P' , 'P' , 'S' };
+		const unsigned long Version = 3;
+
+		/// <summary>
+		/// Written in place of a node kind for an absent node.
+		/// </summary>
+		const unsigned char Absent = NodeKind::Count;
+
+		/// <summary>
+		/// Returns the enclosing type a nestabletype pointer refers to as a node, so that it can be saved as a reference.
+		/// </summary>
+		const CodeObject* enclosing( const nestabletype* type )
+		{
+			return type ? dynamic_cast< const CodeObject* >( type ) : 0;
+		}
+
+		/// <summary>
+		/// Returns the node an optional child refers to, read through a constant proxy so that an interned node is not copied.
+		/// </summary>
+		template< typename T > const T* held( const copying_pointer< T >* child )
+		{
+			return child -> pointer( );
+		}
+
+		nestabletype* nestable( CodeObject& node )
+		{
+			switch( node.Kind( ) )
+			{
+			case NodeKind::Union:
+				return static_cast< Union* >( &node );
+			case NodeKind::Enumeration:
+				return static_cast< Enumeration* >( &node );
+			case NodeKind::UserDefinedType:
+				return static_cast< UserDefinedType* >( &node );
+			default:
+				break;
+			}
+			throw std::bad_cast( );
+		}
+
+		template< typename T , typename P > void resolve( void* field , CodeObject& node )
+		{
+			*static_cast< P* >( field ) = const_cast< T* >( &cast< T >( node ) );
+		}
+
+		template< typename T > void resolvenestable( void* field , CodeObject& node )
+		{
+			*static_cast< T** >( field ) = nestable( node );
+		}
+	}
+
+	/// <summary>
+	/// Encodes nodes into a buffer, references are patched with node indices once every node, including the externals, has been written.
+	/// Counts and characters are written as variable length integers, indices of referred nodes as four little endian bytes.
+	/// </summary>
+	class Snapshot::Writer
+	{
+		vector< unsigned char > nodes;
+		std::unordered_map< wstring , unsigned long > strings;
+		vector< const wstring* > table;
+		std::unordered_map< const CodeObject* , unsigned long > indices;
+		vector< std::pair< std::size_t , const CodeObject* > > links;
+
+		static void encode( vector< unsigned char >& buffer , unsigned long value )
+		{
+			while( value >= 0x80 )
+			{
+				buffer.push_back( static_cast< unsigned char >( value | 0x80 ) );
+				value >>= 7;
+			}
+			buffer.push_back( static_cast< unsigned char >( value ) );
+		}
+
+		void element( const shared_pointer< CodeObject >& node )
+		{
+			save( *this , node.pointer( ) );
+		}
+
+		template< typename T > void element( const copying_pointer< T >& node )
+		{
+			save( *this , node.pointer( ) );
+		}
+
+		template< typename T > void element( const std::pair< T , AccessRestrictions >& member )
+		{
+			element( member.first );
+			number( member.second );
+		}
+
+		template< typename T > void element( const std::tuple< T , AccessRestrictions , bool >& member )
+		{
+			element( std::get< 0 >( member ) );
+			number( std::get< 1 >( member ) );
+			flag( std::get< 2 >( member ) );
+		}
+	public:
+		void byte( unsigned char value )
+		{
+			nodes.push_back( value );
+		}
+
+		void number( unsigned long value )
+		{
+			encode( nodes , value );
+		}
+
+		void flag( bool value )
+		{
+			nodes.push_back( value ? 1 : 0 );
+		}
+
+		void text( const wstring& value )
+		{
+			std::pair< std::unordered_map< wstring , unsigned long >::iterator , bool > entry = strings.insert( std::make_pair( value , static_cast< unsigned long >( table.size( ) ) ) );
+			if( entry.second )
+				table.push_back( &entry.first -> first );
+			number( entry.first -> second );
+		}
+
+		void texts( const StringCollection& values )
+		{
+			number( static_cast< unsigned long >( values.size( ) ) );
+			for( StringCollection::const_iterator iter = values.begin( ) ; iter != values.end( ) ; ++iter )
+				text( *iter );
+		}
+
+		/// <summary>
+		/// Starts the record of a node, which is numbered in the order records are started.
+		/// </summary>
+		void begin( const CodeObject& node )
+		{
+			byte( static_cast< unsigned char >( node.Kind( ) ) );
+			indices.insert( std::make_pair( &node , static_cast< unsigned long >( indices.size( ) + 1 ) ) );
+		}
+
+		void reference( const CodeObject* node )
+		{
+			if( node )
+				links.push_back( std::make_pair( nodes.size( ) , node ) );
+			nodes.insert( nodes.end( ) , 4 , 0 );
+		}
+
+		template< typename C > void children( const C& collection )
+		{
+			number( static_cast< unsigned long >( collection.size( ) ) );
+			for( typename C::const_iterator iter = collection.begin( ) ; iter != collection.end( ) ; ++iter )
+				element( *iter );
+		}
+
+		/// <summary>
+		/// Writes every node referred to so far which has not been written as part of the graph, each preceded by a marker and all followed by a terminator.
+		/// </summary>
+		void externals( )
+		{
+			for( std::size_t i = 0 ; i < links.size( ) ; ++i )
+				if( indices.find( links[ i ].second ) == indices.end( ) )
+				{
+					flag( true );
+					save( *this , links[ i ].second );
+				}
+			flag( false );
+		}
+
+		void write( std::ostream& os )
+		{
+			for( vector< std::pair< std::size_t , const CodeObject* > >::const_iterator iter = links.begin( ) ; iter != links.end( ) ; ++iter )
+			{
+				unsigned long index = indices[ iter -> second ];
+				for( std::size_t i = 0 ; i < 4 ; ++i , index >>= 8 )
+					nodes[ iter -> first + i ] = static_cast< unsigned char >( index );
+			}
+
+			vector< unsigned char > header( Magic , Magic + sizeof( Magic ) );
+			encode( header , Version );
+			encode( header , static_cast< unsigned long >( indices.size( ) ) );
+			encode( header , static_cast< unsigned long >( table.size( ) ) );
+			for( vector< const wstring* >::const_iterator iter = table.begin( ) ; iter != table.end( ) ; ++iter )
+			{
+				encode( header , static_cast< unsigned long >( ( *iter ) -> size( ) ) );
+				for( wstring::const_iterator character = ( *iter ) -> begin( ) ; character != ( *iter ) -> end( ) ; ++character )
+					encode( header , static_cast< unsigned long >( *character ) );
+			}
+			os.write( reinterpret_cast< const char* >( &header[ 0 ] ) , header.size( ) );
+			if( !nodes.empty( ) )
+				os.write( reinterpret_cast< const char* >( &nodes[ 0 ] ) , nodes.size( ) );
+		}
+	};
+
+	/// <summary>
+	/// Decodes nodes from a snapshot, references are recorded as they are read and resolved once every node has been created.
+	/// Constructors which need a referred node are given a placeholder until then.
+	/// </summary>
+	class Snapshot::Reader
+	{
+		struct Link
+		{
+			void* field;
+			unsigned long index;
+			void ( *resolve )( void* field , CodeObject& node );
+		};
+
+		const unsigned char* position;
+		const unsigned char* end;
+		vector< wstring > strings;
+		vector< CodeObject* > slots;
+		vector< Link > links;
+		unsigned long next;
+
+		void link( void* field , void ( *function )( void* , CodeObject& ) )
+		{
+			unsigned long index = 0;
+			for( std::size_t i = 0 ; i < 4 ; ++i )
+				index |= static_cast< unsigned long >( byte( ) ) << ( 8 * i );
+			if( index > slots.size( ) )
+				throw invalid_argument( "Snapshot refers to a node which does not exist." );
+			Link entry = { field , index , function };
+			links.push_back( entry );
+		}
+
+		void element( shared_pointer< CodeObject >& node )
+		{
+			node = shared_pointer< CodeObject >( load( *this ) );
+		}
+
+		template< typename T > void element( copying_pointer< T >& node )
+		{
+			node = child< T >( );
+		}
+
+		template< typename T > void element( std::pair< T , AccessRestrictions >& member )
+		{
+			element( member.first );
+			member.second = static_cast< AccessRestrictions >( number( ) );
+		}
+
+		template< typename T > void element( std::tuple< T , AccessRestrictions , bool >& member )
+		{
+			element( std::get< 0 >( member ) );
+			std::get< 1 >( member ) = static_cast< AccessRestrictions >( number( ) );
+			std::get< 2 >( member ) = flag( );
+		}
+	public:
+		copying_pointer< UserDefinedType > type;
+		copying_pointer< Function > function;
+		copying_pointer< MemberFunction > memberfunction;
+		copying_pointer< VariableDeclaration > variable;
+		copying_pointer< PrimitiveExpression > expression;
+		copying_pointer< ExpressionStatement > statement;
+
+		Reader( const char* data , std::size_t size )
+			: position( reinterpret_cast< const unsigned char* >( data ) ) , end( reinterpret_cast< const unsigned char* >( data ) + size ) , next( 0 )
+		{
+			if( size < sizeof( Magic ) || !std::equal( Magic , Magic + sizeof( Magic ) , data ) )
+				throw invalid_argument( "Data is not a code graph snapshot." );
+			position += sizeof( Magic );
+			if( number( ) != Version )
+				throw invalid_argument( "Snapshot was written by an unsupported version." );
+			slots.resize( length( ) );
+			strings.resize( length( ) );
+			for( vector< wstring >::iterator iter = strings.begin( ) ; iter != strings.end( ) ; ++iter )
+			{
+				iter -> resize( length( ) );
+				for( wstring::iterator character = iter -> begin( ) ; character != iter -> end( ) ; ++character )
+					*character = static_cast< wchar_t >( number( ) );
+			}
+
+			type = UserDefinedType::Instantiate( L"" , UserDefinedType::Class );
+			function = Function::Instantiate( L"" );
+			memberfunction = MemberFunction::Instantiate( *type , L"" , Public );
+			variable = VariableDeclaration::Instantiate( *type , L"" );
+			expression = PrimitiveExpression::Instantiate( );
+			statement = ExpressionStatement::Instantiate( );
+		}
+
+		unsigned char byte( )
+		{
+			if( position == end )
+				throw invalid_argument( "Snapshot is truncated." );
+			return *position++;
+		}
+
+		unsigned long number( )
+		{
+			unsigned long value = 0;
+			for( unsigned int shift = 0 ; ; shift += 7 )
+			{
+				unsigned char part = byte( );
+				if( shift >= 8 * sizeof( unsigned long ) )
+					throw invalid_argument( "Snapshot holds a malformed number." );
+				value |= static_cast< unsigned long >( part & 0x7F ) << shift;
+				if( !( part & 0x80 ) )
+					return value;
+			}
+		}
+
+		/// <summary>
+		/// Reads the number of items which follow, each of which takes at least a byte, so it can not be more than the bytes left.
+		/// </summary>
+		unsigned long length( )
+		{
+			unsigned long value = number( );
+			if( value > static_cast< std::size_t >( end - position ) )
+				throw invalid_argument( "Snapshot holds more items than it has data for." );
+			return value;
+		}
+
+		bool flag( )
+		{
+			return byte( ) != 0;
+		}
+
+		const wstring& text( )
+		{
+			unsigned long index = number( );
+			if( index >= strings.size( ) )
+				throw invalid_argument( "Snapshot refers to a string which does not exist." );
+			return strings[ index ];
+		}
+
+		void texts( StringCollection& values )
+		{
+			for( unsigned long count = length( ) ; count ; --count )
+				values.push_back( text( ) );
+		}
+
+		/// <summary>
+		/// Numbers the node whose record is being read, in the same order as Writer::begin.
+		/// </summary>
+		unsigned long reserve( )
+		{
+			if( next == slots.size( ) )
+				throw invalid_argument( "Snapshot holds more nodes than it declares." );
+			return next++;
+		}
+
+		void bind( unsigned long index , CodeObject& node )
+		{
+			slots[ index ] = &node;
+		}
+
+		template< typename T > void reference( const T*& field )
+		{
+			link( &field , &CPlusPlusCodeProvider::resolve< T , const T* > );
+		}
+
+		template< typename T > void reference( T*& field )
+		{
+			link( &field , &CPlusPlusCodeProvider::resolve< T , T* > );
+		}
+
+		template< typename T > void enclosing( T*& field )
+		{
+			link( &field , &resolvenestable< T > );
+		}
+
+		template< typename T > copying_pointer< T > child( )
+		{
+			CodeObject* node = load( *this );
+			if( node && !IsKindOf< T >( node -> Kind( ) ) )
+			{
+				delete node;
+				throw invalid_argument( "Snapshot holds a node of unexpected kind." );
+			}
+			return copying_pointer< T >( static_cast< T* >( node ) );
+		}
+
+		template< typename T > void children( TypedCollection< T >& collection )
+		{
+			for( unsigned long count = length( ) ; count ; --count )
+			{
+				T value;
+				element( value );
+				collection.push_back( std::move( value ) );
+			}
+		}
+
+		template< typename T > void children( LazyCollection< TypedCollection< T > >& collection )
+		{
+			if( unsigned long count = length( ) )
+			{
+				TypedCollection< T >& values = collection.Acquire( );
+				for( ; count ; --count )
+				{
+					T value;
+					element( value );
+					values.push_back( std::move( value ) );
+				}
+			}
+		}
+
+		/// <summary>
+		/// Points every recorded reference at the node it names, an index of zero stands for no node.
+		/// </summary>
+		void resolve( )
+		{
+			if( next != slots.size( ) )
+				throw invalid_argument( "Snapshot holds fewer nodes than it declares." );
+			for( vector< Link >::const_iterator iter = links.begin( ) ; iter != links.end( ) ; ++iter )
+				if( iter -> index )
+				{
+					try
+					{
+						iter -> resolve( iter -> field , *slots[ iter -> index - 1 ] );
+					}
+					catch( std::bad_cast& )
+					{
+						throw invalid_argument( "Snapshot refers to a node of unexpected kind." );
+					}
+				}
+				else
+					*static_cast< void** >( iter -> field ) = 0;
+		}
+	};
+
+	void Snapshot::savecomment( Writer& writer , const LazyComment& comment )
+	{
+		save( writer , comment.comment.pointer( ) );
+	}
+
+	void Snapshot::savetype( Writer& writer , const Type& type )
+	{
+		writer.text( type.name );
+		savecomment( writer , type.comment );
+	}
+
+	void Snapshot::savecallable( Writer& writer , const Callable& callable )
+	{
+		writer.text( callable.name );
+		writer.texts( *callable.exception_list );
+		writer.children( *callable.argumentlist );
+		writer.flag( callable.return_type.get( ) != 0 );
+		if( callable.return_type.get( ) )
+			save( writer , held( callable.return_type.get( ) ) );
+		savecomment( writer , callable.comment );
+		writer.number( callable.specs );
+	}
+
+	void Snapshot::savefunction( Writer& writer , const Function& function )
+	{
+		savecallable( writer , function );
+		writer.children( *function.template_parameters );
+		writer.children( *function.statements );
+		writer.children( *function.catchclauses );
+		writer.flag( function.is_inline );
+		writer.number( function.capability );
+	}
+
+	void Snapshot::savespecifier( Writer& writer , const DeclaratorSpecifier& specifier )
+	{
+		writer.reference( specifier.type );
+		writer.flag( specifier.is_constant );
+		writer.flag( specifier.is_volatile );
+		writer.flag( specifier.is_static );
+		writer.flag( specifier.is_extern );
+	}
+
+	void Snapshot::savedeclarator( Writer& writer , const Declarator& declarator )
+	{
+		writer.text( declarator.name );
+		writer.flag( declarator.is_reference );
+		writer.flag( declarator.is_constant );
+		writer.flag( declarator.is_volatile );
+		writer.number( declarator.level );
+		writer.number( static_cast< unsigned long >( declarator.indices -> size( ) ) );
+		const IntegerCollection& dimensions = *declarator.indices;
+		for( IntegerCollection::const_iterator iter = dimensions.begin( ) ; iter != dimensions.end( ) ; ++iter )
+			writer.number( *iter );
+		writer.flag( declarator.has_initializer );
+		if( declarator.has_initializer )
+			save( writer , held( declarator.initializer.get( ) ) );
+	}
+
+	void Snapshot::saveblock( Writer& writer , const StatementBlock& block )
+	{
+		writer.children( *block.statements );
+	}
+
+	void Snapshot::saveiteration( Writer& writer , const IterationClause& clause )
+	{
+		saveblock( writer , clause );
+		save( writer , clause.condition.pointer( ) );
+		savecomment( writer , clause.comment );
+	}
+
+	void Snapshot::saveunit( Writer& writer , const CompilationUnit& unit )
+	{
+		writer.text( unit.name );
+		savecomment( writer , unit.comment );
+		writer.children( unit.codeblock );
+	}
+
+	void Snapshot::save( Writer& writer , const CodeObject* node )
+	{
+		if( !node )
+		{
+			writer.byte( Absent );
+			return;
+		}
+		writer.begin( *node );
+		switch( node -> Kind( ) )
+		{
+		case NodeKind::Comment:
+			{
+				const Comment& comment = static_cast< const Comment& >( *node );
+				writer.text( comment.text );
+				writer.flag( comment.multiline );
+				writer.flag( comment.object_source );
+				if( comment.object_source )
+					writer.reference( comment.object );
+			}
+			break;
+		case NodeKind::CodeSnippet:
+			writer.text( static_cast< const CodeSnippet& >( *node ).snippet );
+			break;
+		case NodeKind::Namespace:
+			{
+				const Namespace& space = static_cast< const Namespace& >( *node );
+				writer.text( space.name );
+				savecomment( writer , space.comment );
+				writer.children( *space.codeblock );
+			}
+			break;
+		case NodeKind::Typedefinition:
+			{
+				const Typedefinition& definition = static_cast< const Typedefinition& >( *node );
+				writer.text( definition.defining_type );
+				writer.texts( *definition.synonyms );
+				savecomment( writer , definition.comment );
+			}
+			break;
+		case NodeKind::PreprocessorDirective:
+		case NodeKind::MacroTestDirective:
+			{
+				const PreprocessorDirective& directive = static_cast< const PreprocessorDirective& >( *node );
+				writer.text( directive.directive );
+				writer.number( directive.type );
+				writer.flag( directive.multiline );
+				savecomment( writer , directive.comment );
+				if( node -> Kind( ) == NodeKind::MacroTestDirective )
+				{
+					const MacroTestDirective& test = static_cast< const MacroTestDirective& >( *node );
+					writer.flag( test.codeblock.get( ) != 0 );
+					if( test.codeblock.get( ) )
+						saveunit( writer , *test.codeblock );
+				}
+			}
+			break;
+		case NodeKind::VariableDeclaration:
+			{
+				const VariableDeclaration& declaration = static_cast< const VariableDeclaration& >( *node );
+				savespecifier( writer , declaration.type );
+				savecomment( writer , declaration.comment );
+				savedeclarator( writer , declaration.declarator );
+			}
+			break;
+		case NodeKind::VariableDeclarationList:
+			{
+				const VariableDeclarationList& declaration = static_cast< const VariableDeclarationList& >( *node );
+				savespecifier( writer , declaration.type );
+				savecomment( writer , declaration.comment );
+				writer.number( static_cast< unsigned long >( declaration.declarators -> size( ) ) );
+				const DeclaratorList& declarators = *declaration.declarators;
+				for( DeclaratorList::const_iterator iter = declarators.begin( ) ; iter != declarators.end( ) ; ++iter )
+					savedeclarator( writer , *iter );
+			}
+			break;
+		case NodeKind::Function:
+			savefunction( writer , static_cast< const Function& >( *node ) );
+			break;
+		case NodeKind::MemberFunction:
+			{
+				const MemberFunction& function = static_cast< const MemberFunction& >( *node );
+				savefunction( writer , function );
+				writer.reference( enclosing( function.enclosingtype ) );
+				writer.flag( function.is_virtual );
+				writer.flag( function.is_static );
+				writer.flag( function.is_constant );
+				writer.flag( function.is_volatile );
+				writer.flag( function.is_pure );
+				writer.flag( function.force_body );
+				writer.number( function.access );
+			}
+			break;
+		case NodeKind::Constructor:
+			{
+				const Constructor& constructor = static_cast< const Constructor& >( *node );
+				savefunction( writer , constructor );
+				writer.flag( constructor.is_explicit );
+				writer.children( *constructor.initializer_list );
+				writer.reference( constructor.enclosingtype );
+				writer.number( constructor.access );
+			}
+			break;
+		case NodeKind::Destructor:
+			{
+				const Destructor& destructor = static_cast< const Destructor& >( *node );
+				savefunction( writer , destructor );
+				writer.reference( destructor.enclosingtype );
+				writer.flag( destructor.is_virtual );
+				writer.flag( destructor.is_pure );
+				writer.number( destructor.access );
+			}
+			break;
+		case NodeKind::Operator:
+			savefunction( writer , static_cast< const Operator& >( *node ) );
+			writer.number( static_cast< const Operator& >( *node ).t );
+			break;
+		case NodeKind::MemberOperator:
+			{
+				const MemberOperator& function = static_cast< const MemberOperator& >( *node );
+				savefunction( writer , function );
+				writer.number( function.t );
+				writer.reference( enclosing( function.enclosingtype ) );
+				writer.flag( function.is_virtual );
+				writer.flag( function.is_const );
+				writer.flag( function.is_pure );
+				writer.flag( function.is_volatile );
+				writer.flag( function.force_body );
+				writer.number( function.access );
+			}
+			break;
+		case NodeKind::TypedefinedType:
+		case NodeKind::TypedParameter:
+		case NodeKind::BasicType:
+			savetype( writer , static_cast< const Type& >( *node ) );
+			break;
+		case NodeKind::NontypeParameter:
+			savetype( writer , static_cast< const Type& >( *node ) );
+			writer.flag( static_cast< const NontypeParameter& >( *node ).is_integral );
+			break;
+		case NodeKind::TemplateTemplateParameter:
+			savetype( writer , static_cast< const Type& >( *node ) );
+			writer.number( static_cast< const TemplateTemplateParameter& >( *node ).arguments );
+			break;
+		case NodeKind::Union:
+			{
+				const Union& type = static_cast< const Union& >( *node );
+				savetype( writer , type );
+				writer.children( *type.template_parameters );
+				writer.children( *type.membervariables );
+				writer.children( *type.memberfunctions );
+				writer.children( *type.memberoperators );
+				writer.flag( type.is_templated );
+				writer.flag( type.is_inline );
+				writer.reference( enclosing( type.enclosingtype ) );
+			}
+			break;
+		case NodeKind::Enumeration:
+			{
+				const Enumeration& type = static_cast< const Enumeration& >( *node );
+				savetype( writer , type );
+				writer.reference( enclosing( type.enclosingtype ) );
+				writer.reference( type.underlying );
+				// Enumerators are saved in the order of their names, which is the order enumeratorlist keeps them in.
+				writer.number( static_cast< unsigned long >( type.enumerators.size( ) ) );
+				for( enumeratorlist::const_iterator iter = type.enumerators.begin( ) ; iter != type.enumerators.end( ) ; ++iter )
+				{
+					save( writer , iter -> first.first.pointer( ) );
+					writer.text( iter -> first.second );
+					save( writer , iter -> second.pointer( ) );
+				}
+			}
+			break;
+		case NodeKind::UserDefinedType:
+			{
+				const UserDefinedType& type = static_cast< const UserDefinedType& >( *node );
+				savetype( writer , type );
+				writer.number( type.usertype );
+				writer.flag( type.is_sealed );
+				writer.flag( type.is_inline );
+				writer.reference( enclosing( type.enclosingtype ) );
+				writer.number( static_cast< unsigned long >( type.bases -> size( ) ) );
+				for( BaseTypeCollection::const_iterator iter = type.bases -> begin( ) ; iter != type.bases -> end( ) ; ++iter )
+				{
+					writer.number( iter -> access );
+					writer.reference( iter -> actual );
+					writer.texts( *iter -> arguments );
+					writer.flag( iter -> is_virtual );
+				}
+				writer.children( *type.template_parameters );
+				writer.children( *type.specialized_parameters );
+				writer.children( *type.typedefinitions );
+				writer.children( *type.memberuserdefinedtypes );
+				writer.children( *type.memberenumerations );
+				writer.children( *type.memberunions );
+				writer.children( *type.membervariables );
+				writer.children( *type.constructors );
+				save( writer , type.destructor );
+				writer.children( *type.memberfunctions );
+				writer.children( *type.memberoperators );
+			}
+			break;
+		case NodeKind::FunctionPtr:
+		case NodeKind::MemFun:
+			{
+				const FunctionPtr& pointer = static_cast< const FunctionPtr& >( *node );
+				savetype( writer , pointer );
+				savecallable( writer , pointer );
+				writer.reference( pointer.function );
+				if( node -> Kind( ) == NodeKind::MemFun )
+					writer.reference( static_cast< const MemFun& >( *node ).containingtype );
+			}
+			break;
+		case NodeKind::PointerToMember:
+			{
+				const PointerToMember& pointer = static_cast< const PointerToMember& >( *node );
+				savetype( writer , pointer );
+				writer.reference( pointer.type );
+				writer.reference( pointer.containingtype );
+				writer.flag( pointer.initialized );
+			}
+			break;
+		case NodeKind::PrefixExpression:
+			{
+				const PrefixExpression& expression = static_cast< const PrefixExpression& >( *node );
+				save( writer , expression.source.pointer( ) );
+				writer.text( expression.name );
+				writer.number( expression.t );
+			}
+			break;
+		case NodeKind::PostfixExpression:
+			save( writer , static_cast< const PostfixExpression& >( *node ).source.pointer( ) );
+			writer.number( static_cast< const PostfixExpression& >( *node ).t );
+			break;
+		case NodeKind::ScopeResolutionExpression:
+			writer.text( static_cast< const ScopeResolutionExpression& >( *node ).left );
+			save( writer , static_cast< const ScopeResolutionExpression& >( *node ).right.pointer( ) );
+			break;
+		case NodeKind::BinaryExpression:
+			{
+				const BinaryExpression& expression = static_cast< const BinaryExpression& >( *node );
+				save( writer , expression.left.pointer( ) );
+				save( writer , expression.right.pointer( ) );
+				writer.text( expression.name );
+				writer.number( expression.t );
+			}
+			break;
+		case NodeKind::ArgumentReference:
+			writer.reference( static_cast< const ArgumentReference& >( *node ).argument );
+			break;
+		case NodeKind::Cast:
+			writer.text( static_cast< const Cast& >( *node ).target );
+			writer.reference( static_cast< const Cast& >( *node ).expression );
+			writer.number( static_cast< const Cast& >( *node ).type );
+			break;
+		case NodeKind::ConditionalExpression:
+			{
+				const ConditionalExpression& expression = static_cast< const ConditionalExpression& >( *node );
+				writer.reference( expression.test );
+				writer.reference( expression.correct );
+				writer.reference( expression.incorrect );
+			}
+			break;
+		case NodeKind::VariableReference:
+			writer.reference( static_cast< const VariableReference& >( *node ).reference );
+			break;
+		case NodeKind::LambdaCapture:
+			writer.reference( static_cast< const LambdaCapture& >( *node ).reference );
+			writer.number( static_cast< const LambdaCapture& >( *node ).captureType );
+			break;
+		case NodeKind::CallExpression:
+			{
+				const CallExpression& expression = static_cast< const CallExpression& >( *node );
+				writer.flag( expression.target.get( ) != 0 );
+				if( expression.target.get( ) )
+					save( writer , held( expression.target.get( ) ) );
+				writer.reference( expression.method );
+				writer.children( *expression.arguments );
+				writer.flag( expression.is_pointer );
+			}
+			break;
+		case NodeKind::MethodReference:
+			writer.reference( static_cast< const MethodReference& >( *node ).method );
+			break;
+		case NodeKind::NewExpression:
+			{
+				const NewExpression& expression = static_cast< const NewExpression& >( *node );
+				writer.reference( expression.type );
+				writer.children( *expression.arguments );
+				writer.number( expression.level );
+				writer.flag( expression.is_pointer );
+				writer.flag( expression.is_array );
+				writer.flag( expression.size.get( ) != 0 );
+				if( expression.size.get( ) )
+					save( writer , held( expression.size.get( ) ) );
+			}
+			break;
+		case NodeKind::ParenthesizedExpression:
+			writer.reference( static_cast< const ParenthesizedExpression& >( *node ).source );
+			break;
+		case NodeKind::DeleteExpression:
+			save( writer , static_cast< const DeleteExpression& >( *node ).type.pointer( ) );
+			writer.flag( static_cast< const DeleteExpression& >( *node ).is_array );
+			break;
+		case NodeKind::ThrowExpression:
+			save( writer , static_cast< const ThrowExpression& >( *node ).tothrow.pointer( ) );
+			break;
+		case NodeKind::PrimitiveExpression:
+			writer.text( static_cast< const PrimitiveExpression& >( *node ).expression );
+			break;
+		case NodeKind::LambdaExpression:
+			{
+				const LambdaExpression& expression = static_cast< const LambdaExpression& >( *node );
+				savecallable( writer , expression );
+				writer.children( *expression.captures );
+				writer.children( *expression.statements );
+				writer.flag( expression.is_mutable );
+			}
+			break;
+		case NodeKind::UsingStatement:
+			savecomment( writer , static_cast< const UsingStatement& >( *node ).comment );
+			save( writer , static_cast< const UsingStatement& >( *node ).name.pointer( ) );
+			break;
+		case NodeKind::ExpressionStatement:
+			{
+				const ExpressionStatement& statement = static_cast< const ExpressionStatement& >( *node );
+				save( writer , statement.expression.pointer( ) );
+				writer.flag( statement.is_empty );
+				savecomment( writer , statement.comment );
+			}
+			break;
+		case NodeKind::JumpStatement:
+			{
+				const JumpStatement& statement = static_cast< const JumpStatement& >( *node );
+				writer.text( statement.label );
+				writer.number( statement.type );
+				if( statement.type == JumpStatement::JumpType::Return )
+					save( writer , held( statement.expr ) );
+			}
+			break;
+		case NodeKind::LabelStatement:
+			writer.text( static_cast< const LabelStatement& >( *node ).label );
+			writer.reference( static_cast< const LabelStatement& >( *node ).statement );
+			break;
+		case NodeKind::StatementBlock:
+			saveblock( writer , static_cast< const StatementBlock& >( *node ) );
+			break;
+		case NodeKind::CatchClause:
+			{
+				const CatchClause& clause = static_cast< const CatchClause& >( *node );
+				saveblock( writer , clause );
+				writer.flag( clause.empty );
+				savecomment( writer , clause.comment );
+				save( writer , clause.var.pointer( ) );
+			}
+			break;
+		case NodeKind::Case:
+			{
+				const Case& clause = static_cast< const Case& >( *node );
+				saveblock( writer , clause );
+				save( writer , clause.label.pointer( ) );
+				writer.flag( clause.has_variable_declarations );
+				writer.flag( clause.is_default );
+				savecomment( writer , clause.comment );
+			}
+			break;
+		case NodeKind::TryCatchClause:
+			{
+				const TryCatchClause& clause = static_cast< const TryCatchClause& >( *node );
+				saveblock( writer , clause );
+				writer.children( *clause.catchclauses );
+				savecomment( writer , clause.comment );
+			}
+			break;
+		case NodeKind::ConditionClause:
+			{
+				const ConditionClause& clause = static_cast< const ConditionClause& >( *node );
+				saveblock( writer , clause );
+				save( writer , clause.condition.pointer( ) );
+				savecomment( writer , clause.comment );
+				save( writer , &clause.else_block );
+			}
+			break;
+		case NodeKind::ForLoop:
+			{
+				const ForLoop& loop = static_cast< const ForLoop& >( *node );
+				saveiteration( writer , loop );
+				save( writer , loop.init.pointer( ) );
+				save( writer , loop.change.pointer( ) );
+			}
+			break;
+		case NodeKind::WhileLoop:
+		case NodeKind::DoWhileLoop:
+			saveiteration( writer , static_cast< const IterationClause& >( *node ) );
+			break;
+		case NodeKind::SwitchStatement:
+			{
+				const SwitchStatement& statement = static_cast< const SwitchStatement& >( *node );
+				save( writer , statement.condition.pointer( ) );
+				savecomment( writer , statement.comment );
+				writer.flag( statement.cases.get( ) != 0 );
+				if( statement.cases.get( ) )
+					writer.children( *statement.cases );
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Snapshot::loadcomment( Reader& reader , LazyComment& comment )
+	{
+		comment.comment = reader.child< Comment >( );
+	}
+
+	void Snapshot::loadtype( Reader& reader , Type& type )
+	{
+		type.name = reader.text( );
+		loadcomment( reader , type.comment );
+	}
+
+	void Snapshot::loadcallable( Reader& reader , Callable& callable )
+	{
+		callable.name = reader.text( );
+		if( unsigned long count = reader.length( ) )
+		{
+			StringCollection& exceptions = callable.exception_list.Acquire( );
+			for( ; count ; --count )
+				exceptions.push_back( reader.text( ) );
+		}
+		reader.children( callable.argumentlist );
+		if( reader.flag( ) )
+			callable.return_type.reset( new copying_pointer< VariableDeclaration >( reader.child< VariableDeclaration >( ) ) );
+		loadcomment( reader , callable.comment );
+		callable.specs = static_cast< int >( reader.number( ) );
+	}
+
+	void Snapshot::loadfunction( Reader& reader , Function& function )
+	{
+		loadcallable( reader , function );
+		reader.children( *function.template_parameters );
+		reader.children( *function.statements );
+		reader.children( *function.catchclauses );
+		function.is_inline = reader.flag( );
+		function.capability = reader.number( );
+	}
+
+	void Snapshot::loadspecifier( Reader& reader , DeclaratorSpecifier& specifier )
+	{
+		reader.reference( specifier.type );
+		specifier.is_constant = reader.flag( );
+		specifier.is_volatile = reader.flag( );
+		specifier.is_static = reader.flag( );
+		specifier.is_extern = reader.flag( );
+	}
+
+	void Snapshot::loaddeclarator( Reader& reader , Declarator& declarator )
+	{
+		declarator.name = reader.text( );
+		declarator.is_reference = reader.flag( );
+		declarator.is_constant = reader.flag( );
+		declarator.is_volatile = reader.flag( );
+		declarator.level = reader.number( );
+		for( unsigned long count = reader.length( ) ; count ; --count )
+			declarator.indices -> push_back( static_cast< int >( reader.number( ) ) );
+		declarator.has_initializer = reader.flag( );
+		if( declarator.has_initializer )
+			declarator.initializer.reset( new copying_pointer< Expression >( reader.child< Expression >( ) ) );
+	}
+
+	void Snapshot::loadblock( Reader& reader , StatementBlock& block )
+	{
+		reader.children( *block.statements );
+	}
+
+	void Snapshot::loaditeration( Reader& reader , IterationClause& clause )
+	{
+		loadblock( reader , clause );
+		clause.condition = reader.child< Expression >( );
+		loadcomment( reader , clause.comment );
+	}
+
+	void Snapshot::loadunit( Reader& reader , CompilationUnit& unit )
+	{
+		unit.name = reader.text( );
+		loadcomment( reader , unit.comment );
+		reader.children( unit.codeblock );
+	}
+
+	CodeObject* Snapshot::load( Reader& reader )
+	{
+		unsigned char kind = reader.byte( );
+		if( kind == Absent )
+			return 0;
+		unsigned long index = reader.reserve( );
+		CodeObject* result = 0;
+		switch( kind )
+		{
+		case NodeKind::Comment:
+			{
+				auto_ptr< Comment > comment( new Comment( reader.text( ) ) );
+				reader.bind( index , *comment );
+				comment -> multiline = reader.flag( );
+				comment -> object_source = reader.flag( );
+				if( comment -> object_source )
+					reader.reference( comment -> object );
+				result = comment.release( );
+			}
+			break;
+		case NodeKind::CodeSnippet:
+			result = new CodeSnippet( reader.text( ) );
+			reader.bind( index , *result );
+			break;
+		case NodeKind::Namespace:
+			{
+				auto_ptr< Namespace > space( new Namespace( reader.text( ) ) );
+				reader.bind( index , *space );
+				loadcomment( reader , space -> comment );
+				reader.children( *space -> codeblock );
+				result = space.release( );
+			}
+			break;
+		case NodeKind::Typedefinition:
+			{
+				auto_ptr< Typedefinition > definition( new Typedefinition( reader.text( ) , L"" ) );
+				reader.bind( index , *definition );
+				definition -> synonyms.reset( new StringCollection );
+				reader.texts( *definition -> synonyms );
+				loadcomment( reader , definition -> comment );
+				result = definition.release( );
+			}
+			break;
+		case NodeKind::PreprocessorDirective:
+		case NodeKind::MacroTestDirective:
+			{
+				const wstring& text = reader.text( );
+				auto_ptr< PreprocessorDirective > directive( kind == NodeKind::MacroTestDirective ? new MacroTestDirective( text ) : new PreprocessorDirective( text ) );
+				reader.bind( index , *directive );
+				directive -> type = static_cast< PreprocessorDirective::DirectiveType >( reader.number( ) );
+				directive -> multiline = reader.flag( );
+				loadcomment( reader , directive -> comment );
+				if( kind == NodeKind::MacroTestDirective && reader.flag( ) )
+				{
+					MacroTestDirective& test = static_cast< MacroTestDirective& >( *directive );
+					test.codeblock.reset( new CompilationUnit( L"" ) );
+					loadunit( reader , *test.codeblock );
+				}
+				result = directive.release( );
+			}
+			break;
+		case NodeKind::VariableDeclaration:
+			{
+				auto_ptr< VariableDeclaration > declaration( new VariableDeclaration( *reader.type , L"" ) );
+				reader.bind( index , *declaration );
+				loadspecifier( reader , declaration -> type );
+				loadcomment( reader , declaration -> comment );
+				loaddeclarator( reader , declaration -> declarator );
+				result = declaration.release( );
+			}
+			break;
+		case NodeKind::VariableDeclarationList:
+			{
+				auto_ptr< VariableDeclarationList > declaration( new VariableDeclarationList( *reader.type ) );
+				reader.bind( index , *declaration );
+				loadspecifier( reader , declaration -> type );
+				loadcomment( reader , declaration -> comment );
+				// Declarators are added before they are read so that their initializers are not copied afterwards.
+				for( unsigned long count = reader.length( ) ; count ; --count )
+					declaration -> declarators -> push_back( Declarator( L"" ) );
+				for( DeclaratorList::iterator iter = declaration -> declarators -> begin( ) ; iter != declaration -> declarators -> end( ) ; ++iter )
+					loaddeclarator( reader , *iter );
+				result = declaration.release( );
+			}
+			break;
+		case NodeKind::Function:
+			{
+				auto_ptr< Function > function( new Function( L"" , 0 ) );
+				reader.bind( index , *function );
+				loadfunction( reader , *function );
+				result = function.release( );
+			}
+			break;
+		case NodeKind::MemberFunction:
+			{
+				auto_ptr< MemberFunction > function( new MemberFunction( *reader.type , L"" , Public , 0 ) );
+				reader.bind( index , *function );
+				loadfunction( reader , *function );
+				reader.enclosing( function -> enclosingtype );
+				function -> is_virtual = reader.flag( );
+				function -> is_static = reader.flag( );
+				function -> is_constant = reader.flag( );
+				function -> is_volatile = reader.flag( );
+				function -> is_pure = reader.flag( );
+				function -> force_body = reader.flag( );
+				function -> access = static_cast< AccessRestrictions >( reader.number( ) );
+				result = function.release( );
+			}
+			break;
+		case NodeKind::Constructor:
+			{
+				auto_ptr< Constructor > constructor( new Constructor( *reader.type , Public , false , 0 ) );
+				reader.bind( index , *constructor );
+				loadfunction( reader , *constructor );
+				constructor -> is_explicit = reader.flag( );
+				reader.children( *constructor -> initializer_list );
+				reader.reference( constructor -> enclosingtype );
+				constructor -> access = static_cast< AccessRestrictions >( reader.number( ) );
+				result = constructor.release( );
+			}
+			break;
+		case NodeKind::Destructor:
+			{
+				auto_ptr< Destructor > destructor( new Destructor( *reader.type , Public , 0 ) );
+				reader.bind( index , *destructor );
+				loadfunction( reader , *destructor );
+				reader.reference( destructor -> enclosingtype );
+				destructor -> is_virtual = reader.flag( );
+				destructor -> is_pure = reader.flag( );
+				destructor -> access = static_cast< AccessRestrictions >( reader.number( ) );
+				result = destructor.release( );
+			}
+			break;
+		case NodeKind::Operator:
+			{
+				auto_ptr< Operator > function( new Operator( L"" , Operator::unary , 0 ) );
+				reader.bind( index , *function );
+				loadfunction( reader , *function );
+				function -> t = static_cast< Operator::OperatorType >( reader.number( ) );
+				result = function.release( );
+			}
+			break;
+		case NodeKind::MemberOperator:
+			{
+				auto_ptr< MemberOperator > function( new MemberOperator( *reader.type , L"" , Operator::unary , Public , 0 ) );
+				reader.bind( index , *function );
+				loadfunction( reader , *function );
+				function -> t = static_cast< Operator::OperatorType >( reader.number( ) );
+				reader.enclosing( function -> enclosingtype );
+				function -> is_virtual = reader.flag( );
+				function -> is_const = reader.flag( );
+				function -> is_pure = reader.flag( );
+				function -> is_volatile = reader.flag( );
+				function -> force_body = reader.flag( );
+				function -> access = static_cast< AccessRestrictions >( reader.number( ) );
+				result = function.release( );
+			}
+			break;
+		case NodeKind::TypedefinedType:
+			{
+				// Names are not validated again, the definition only has to hold the name for the constructor to accept it.
+				const wstring& name = reader.text( );
+				auto_ptr< TypedefinedType > type( new TypedefinedType( Typedefinition::Instantiate( name , name ) , name ) );
+				reader.bind( index , *type );
+				loadcomment( reader , type -> comment );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::NontypeParameter:
+			{
+				auto_ptr< NontypeParameter > type( new NontypeParameter( reader.text( ) ) );
+				reader.bind( index , *type );
+				loadcomment( reader , type -> comment );
+				type -> is_integral = reader.flag( );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::TypedParameter:
+			{
+				auto_ptr< TypedParameter > type( new TypedParameter( reader.text( ) ) );
+				reader.bind( index , *type );
+				loadcomment( reader , type -> comment );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::TemplateTemplateParameter:
+			{
+				const wstring& name = reader.text( );
+				auto_ptr< TemplateTemplateParameter > type( new TemplateTemplateParameter( name , 1 ) );
+				reader.bind( index , *type );
+				loadcomment( reader , type -> comment );
+				type -> arguments = reader.number( );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::BasicType:
+			{
+				auto_ptr< BasicType > type( new BasicType( reader.text( ) ) );
+				reader.bind( index , *type );
+				loadcomment( reader , type -> comment );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::Union:
+			{
+				auto_ptr< Union > type( new Union( L"" ) );
+				reader.bind( index , *type );
+				loadtype( reader , *type );
+				reader.children( type -> template_parameters );
+				reader.children( type -> membervariables );
+				reader.children( type -> memberfunctions );
+				reader.children( type -> memberoperators );
+				type -> is_templated = reader.flag( );
+				type -> is_inline = reader.flag( );
+				reader.enclosing( type -> enclosingtype );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::Enumeration:
+			{
+				auto_ptr< Enumeration > type( new Enumeration( L"" ) );
+				reader.bind( index , *type );
+				loadtype( reader , *type );
+				reader.enclosing( type -> enclosingtype );
+				reader.reference( type -> underlying );
+				for( unsigned long count = reader.length( ) ; count ; --count )
+				{
+					copying_pointer< Comment > comment = reader.child< Comment >( );
+					wstring name = reader.text( );
+					type -> enumerators.insert( std::make_pair( key_type( std::move( comment ) , name ) , reader.child< Expression >( ) ) );
+				}
+				result = type.release( );
+			}
+			break;
+		case NodeKind::UserDefinedType:
+			{
+				auto_ptr< UserDefinedType > type( new UserDefinedType( L"" , UserDefinedType::Class ) );
+				reader.bind( index , *type );
+				loadtype( reader , *type );
+				type -> usertype = static_cast< UserDefinedType::UserType >( reader.number( ) );
+				type -> is_sealed = reader.flag( );
+				type -> is_inline = reader.flag( );
+				reader.enclosing( type -> enclosingtype );
+				if( unsigned long count = reader.length( ) )
+				{
+					// Bases are added before they are read so that the references recorded for them are not moved afterwards.
+					BaseTypeCollection& bases = type -> bases.Acquire( );
+					for( ; count ; --count )
+						bases.push_back( BaseType( *reader.type , StringCollection( ) , Public ) );
+					for( BaseTypeCollection::iterator iter = bases.begin( ) ; iter != bases.end( ) ; ++iter )
+					{
+						iter -> access = static_cast< AccessRestrictions >( reader.number( ) );
+						reader.reference( iter -> actual );
+						reader.texts( *iter -> arguments );
+						iter -> is_virtual = reader.flag( );
+					}
+				}
+				reader.children( type -> template_parameters );
+				reader.children( type -> specialized_parameters );
+				reader.children( type -> typedefinitions );
+				reader.children( type -> memberuserdefinedtypes );
+				reader.children( type -> memberenumerations );
+				reader.children( type -> memberunions );
+				reader.children( type -> membervariables );
+				reader.children( type -> constructors );
+				type -> destructor = reader.child< Destructor >( ).release( );
+				reader.children( type -> memberfunctions );
+				reader.children( type -> memberoperators );
+				result = type.release( );
+			}
+			break;
+		case NodeKind::FunctionPtr:
+			{
+				auto_ptr< FunctionPtr > pointer( new FunctionPtr( L"" , *reader.function ) );
+				reader.bind( index , *pointer );
+				loadtype( reader , *pointer );
+				loadcallable( reader , *pointer );
+				reader.reference( pointer -> function );
+				result = pointer.release( );
+			}
+			break;
+		case NodeKind::MemFun:
+			{
+				auto_ptr< MemFun > pointer( new MemFun( L"" , *reader.memberfunction ) );
+				reader.bind( index , *pointer );
+				loadtype( reader , *pointer );
+				loadcallable( reader , *pointer );
+				reader.reference( pointer -> function );
+				reader.reference( pointer -> containingtype );
+				result = pointer.release( );
+			}
+			break;
+		case NodeKind::PointerToMember:
+			{
+				auto_ptr< PointerToMember > pointer( new PointerToMember( L"" , *reader.type , *reader.type ) );
+				reader.bind( index , *pointer );
+				loadtype( reader , *pointer );
+				reader.reference( pointer -> type );
+				reader.reference( pointer -> containingtype );
+				pointer -> initialized = reader.flag( );
+				result = pointer.release( );
+			}
+			break;
+		case NodeKind::PrefixExpression:
+			{
+				auto_ptr< PrefixExpression > expression( new PrefixExpression( copying_pointer< Expression >( ) , 0 ) );
+				reader.bind( index , *expression );
+				expression -> source = reader.child< Expression >( );
+				expression -> name = reader.text( );
+				expression -> t = static_cast< int >( reader.number( ) );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::PostfixExpression:
+			{
+				auto_ptr< PostfixExpression > expression( new PostfixExpression( copying_pointer< Expression >( ) , 0 ) );
+				reader.bind( index , *expression );
+				expression -> source = reader.child< Expression >( );
+				expression -> t = static_cast< int >( reader.number( ) );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::ScopeResolutionExpression:
+			{
+				auto_ptr< ScopeResolutionExpression > expression( new ScopeResolutionExpression( reader.text( ) ) );
+				reader.bind( index , *expression );
+				expression -> right = reader.child< ScopeResolutionExpression >( );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::BinaryExpression:
+			{
+				auto_ptr< BinaryExpression > expression( new BinaryExpression( copying_pointer< Expression >( ) , copying_pointer< Expression >( ) , 0 ) );
+				reader.bind( index , *expression );
+				expression -> left = reader.child< Expression >( );
+				expression -> right = reader.child< Expression >( );
+				expression -> name = reader.text( );
+				expression -> t = static_cast< int >( reader.number( ) );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::ArgumentReference:
+			{
+				auto_ptr< ArgumentReference > expression( new ArgumentReference( *reader.variable ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> argument );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::Cast:
+			{
+				auto_ptr< Cast > expression( new Cast( reader.text( ) , *reader.expression , Cast::Static ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> expression );
+				expression -> type = static_cast< Cast::CastType >( reader.number( ) );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::ConditionalExpression:
+			{
+				auto_ptr< ConditionalExpression > expression( new ConditionalExpression( *reader.expression , *reader.expression , *reader.expression ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> test );
+				reader.reference( expression -> correct );
+				reader.reference( expression -> incorrect );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::VariableReference:
+			{
+				auto_ptr< VariableReference > expression( new VariableReference( ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> reference );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::LambdaCapture:
+			{
+				auto_ptr< LambdaCapture > expression( new LambdaCapture( CaptureType::None ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> reference );
+				expression -> captureType = static_cast< int >( reader.number( ) );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::CallExpression:
+			{
+				auto_ptr< CallExpression > expression( new CallExpression( copying_pointer< Expression >( ) , *reader.function ) );
+				reader.bind( index , *expression );
+				if( reader.flag( ) )
+					expression -> target.reset( new copying_pointer< Expression >( reader.child< Expression >( ) ) );
+				reader.reference( expression -> method );
+				reader.children( *expression -> arguments );
+				expression -> is_pointer = reader.flag( );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::MethodReference:
+			{
+				auto_ptr< MethodReference > expression( new MethodReference( *reader.function ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> method );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::NewExpression:
+			{
+				ExpressionCollection arguments;
+				auto_ptr< NewExpression > expression( new NewExpression( *reader.type , arguments ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> type );
+				reader.children( *expression -> arguments );
+				expression -> level = reader.number( );
+				expression -> is_pointer = reader.flag( );
+				expression -> is_array = reader.flag( );
+				if( reader.flag( ) )
+					expression -> size.reset( new copying_pointer< Expression >( reader.child< Expression >( ) ) );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::ParenthesizedExpression:
+			{
+				auto_ptr< ParenthesizedExpression > expression( new ParenthesizedExpression( *reader.expression ) );
+				reader.bind( index , *expression );
+				reader.reference( expression -> source );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::DeleteExpression:
+			{
+				auto_ptr< DeleteExpression > expression( new DeleteExpression( copying_pointer< Expression >( ) ) );
+				reader.bind( index , *expression );
+				expression -> type = reader.child< Expression >( );
+				expression -> is_array = reader.flag( );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::ThrowExpression:
+			{
+				auto_ptr< ThrowExpression > expression( new ThrowExpression( copying_pointer< Expression >( ) ) );
+				reader.bind( index , *expression );
+				expression -> tothrow = reader.child< Expression >( );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::PrimitiveExpression:
+			result = new PrimitiveExpression( reader.text( ) );
+			reader.bind( index , *result );
+			break;
+		case NodeKind::LambdaExpression:
+			{
+				auto_ptr< LambdaExpression > expression( new LambdaExpression( ) );
+				reader.bind( index , *expression );
+				loadcallable( reader , *expression );
+				reader.children( *expression -> captures );
+				reader.children( *expression -> statements );
+				expression -> is_mutable = reader.flag( );
+				result = expression.release( );
+			}
+			break;
+		case NodeKind::UsingStatement:
+			{
+				auto_ptr< UsingStatement > statement( new UsingStatement( copying_pointer< ScopeResolutionExpression >( ) ) );
+				reader.bind( index , *statement );
+				loadcomment( reader , statement -> comment );
+				statement -> name = reader.child< ScopeResolutionExpression >( );
+				result = statement.release( );
+			}
+			break;
+		case NodeKind::ExpressionStatement:
+			{
+				auto_ptr< ExpressionStatement > statement( new ExpressionStatement( ) );
+				reader.bind( index , *statement );
+				statement -> expression = reader.child< Expression >( );
+				statement -> is_empty = reader.flag( );
+				loadcomment( reader , statement -> comment );
+				result = statement.release( );
+			}
+			break;
+		case NodeKind::JumpStatement:
+			{
+				auto_ptr< JumpStatement > statement( new JumpStatement( reader.text( ) ) );
+				reader.bind( index , *statement );
+				// The expression is only owned once the type says so, it is read first so that a malformed one leaves nothing to delete.
+				int type = static_cast< int >( reader.number( ) );
+				if( type == JumpStatement::JumpType::Return )
+				{
+					copying_pointer< Expression > expression = reader.child< Expression >( );
+					statement -> expr = new copying_pointer< Expression >( std::move( expression ) );
+				}
+				statement -> type = type;
+				result = statement.release( );
+			}
+			break;
+		case NodeKind::LabelStatement:
+			{
+				auto_ptr< LabelStatement > statement( new LabelStatement( reader.text( ) , *reader.statement ) );
+				reader.bind( index , *statement );
+				reader.reference( statement -> statement );
+				result = statement.release( );
+			}
+			break;
+		case NodeKind::StatementBlock:
+			{
+				auto_ptr< StatementBlock > block( new StatementBlock( ) );
+				reader.bind( index , *block );
+				loadblock( reader , *block );
+				result = block.release( );
+			}
+			break;
+		case NodeKind::CatchClause:
+			{
+				auto_ptr< CatchClause > clause( new CatchClause( ) );
+				reader.bind( index , *clause );
+				loadblock( reader , *clause );
+				clause -> empty = reader.flag( );
+				loadcomment( reader , clause -> comment );
+				clause -> var = reader.child< VariableDeclaration >( );
+				result = clause.release( );
+			}
+			break;
+		case NodeKind::Case:
+			{
+				auto_ptr< Case > clause( new Case( ) );
+				reader.bind( index , *clause );
+				loadblock( reader , *clause );
+				clause -> label = reader.child< PrimitiveExpression >( );
+				clause -> has_variable_declarations = reader.flag( );
+				clause -> is_default = reader.flag( );
+				loadcomment( reader , clause -> comment );
+				result = clause.release( );
+			}
+			break;
+		case NodeKind::TryCatchClause:
+			{
+				auto_ptr< TryCatchClause > clause( new TryCatchClause( ) );
+				reader.bind( index , *clause );
+				loadblock( reader , *clause );
+				reader.children( *clause -> catchclauses );
+				loadcomment( reader , clause -> comment );
+				result = clause.release( );
+			}
+			break;
+		case NodeKind::ConditionClause:
+			{
+				auto_ptr< ConditionClause > clause( new ConditionClause( copying_pointer< Expression >( ) ) );
+				reader.bind( index , *clause );
+				loadblock( reader , *clause );
+				clause -> condition = reader.child< Expression >( );
+				loadcomment( reader , clause -> comment );
+				// The else block is saved as a record of its own but lives inside the clause.
+				if( reader.byte( ) != NodeKind::StatementBlock )
+					throw invalid_argument( "Snapshot holds a node of unexpected kind." );
+				reader.bind( reader.reserve( ) , clause -> else_block );
+				loadblock( reader , clause -> else_block );
+				result = clause.release( );
+			}
+			break;
+		case NodeKind::ForLoop:
+			{
+				auto_ptr< ForLoop > loop( new ForLoop( ) );
+				reader.bind( index , *loop );
+				loaditeration( reader , *loop );
+				loop -> init = reader.child< Expression >( );
+				loop -> change = reader.child< Expression >( );
+				result = loop.release( );
+			}
+			break;
+		case NodeKind::WhileLoop:
+		case NodeKind::DoWhileLoop:
+			{
+				auto_ptr< IterationClause > loop( kind == NodeKind::WhileLoop ? static_cast< IterationClause* >( new WhileLoop( copying_pointer< Expression >( ) ) ) : new DoWhileLoop( copying_pointer< Expression >( ) ) );
+				reader.bind( index , *loop );
+				loaditeration( reader , *loop );
+				result = loop.release( );
+			}
+			break;
+		case NodeKind::SwitchStatement:
+			{
+				auto_ptr< SwitchStatement > statement( new SwitchStatement( copying_pointer< Expression >( ) ) );
+				reader.bind( index , *statement );
+				statement -> condition = reader.child< Expression >( );
+				loadcomment( reader , statement -> comment );
+				if( reader.flag( ) )
+				{
+					statement -> cases.reset( new CaseCollection );
+					reader.children( *statement -> cases );
+				}
+				result = statement.release( );
+			}
+			break;
+		default:
+			break;
+		}
+		if( !result )
+			throw invalid_argument( "Snapshot holds a node of unknown kind." );
+		return result;
+	}
+
+	void Snapshot::Save( const CompilationUnit& unit , std::ostream& os )
+	{
+		Writer writer;
+		saveunit( writer , unit );
+		writer.externals( );
+		writer.write( os );
+	}
+
+	Snapshot::Snapshot( const char* data , std::size_t size )
+		: unit( L"" )
+	{
+		load( data , size );
+	}
+
+	Snapshot::Snapshot( std::istream& is )
+		: unit( L"" )
+	{
+		vector< char > data( ( std::istreambuf_iterator< char >( is ) ) , std::istreambuf_iterator< char >( ) );
+		load( data.empty( ) ? 0 : &data[ 0 ] , data.size( ) );
+	}
+
+	void Snapshot::load( const char* data , std::size_t size )
+	{
+		CodeArena::Scope scope( unit.Arena( ) );
+		Reader reader( data , size );
+		loadunit( reader , unit );
+		while( reader.flag( ) )
+			externals.push_back( shared_pointer< CodeObject >( load( reader ) ) );
+		reader.resolve( );
+	}
+
+	CompilationUnit& Snapshot::Unit( )
+	{
+		return unit;
+	}
+
+	const CodeCollection& Snapshot::Externals( ) const
+	{
+		return externals;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef SNAPSHOT_HEADER
+#define SNAPSHOT_HEADER
+
+#include <cstddef>
+#include <iosfwd>
+#include "cppcodeprovider.h"
+#include "compilationunit.h"
+
+namespace CPlusPlusCodeProvider
+{
+	class Declarator;
+	class DeclaratorSpecifier;
+	class Function;
+	class IterationClause;
+	class StatementBlock;
+
+	/// <summary>
+	/// A compilation unit reloaded from a compact binary snapshot, which lets a built code graph be cached between runs instead of being built again.
+	/// A snapshot holds a string table followed by the nodes in the order they are written out, owned nodes follow their owner and references between nodes, including those of base classes and call expressions, are stored as node indices.
+	/// Nodes referred to from the compilation unit but not contained in it, such as the basic types of declarations, are saved along with it and reloaded as externals owned by the snapshot.
+	/// </summary>
+	/// <remarks>A snapshot is loaded in one pass into the arena of its compilation unit and must outlive every use of the unit's nodes, since they may refer to its externals.</remarks>
+	class Snapshot
+	{
+		class Writer;
+		class Reader;
+
+		CompilationUnit unit;
+		CodeCollection externals;
+
+		Snapshot( const Snapshot& );
+		Snapshot& operator = ( const Snapshot& );
+
+		/// <summary>
+		/// Reads the compilation unit and the externals from the given snapshot.
+		/// </summary>
+		/// <parameter name="data" IsConst="true">Pointer to the snapshot.</parameter>
+		/// <parameter name="size">Size of the snapshot in bytes.</parameter>
+		void load( const char* data , std::size_t size );
+
+		static void save( Writer& writer , const CodeObject* node );
+		static void savecomment( Writer& writer , const LazyComment& comment );
+		static void savetype( Writer& writer , const Type& type );
+		static void savecallable( Writer& writer , const Callable& callable );
+		static void savefunction( Writer& writer , const Function& function );
+		static void savespecifier( Writer& writer , const DeclaratorSpecifier& specifier );
+		static void savedeclarator( Writer& writer , const Declarator& declarator );
+		static void saveblock( Writer& writer , const StatementBlock& block );
+		static void saveiteration( Writer& writer , const IterationClause& clause );
+		static void saveunit( Writer& writer , const CompilationUnit& unit );
+
+		static CodeObject* load( Reader& reader );
+		static void loadcomment( Reader& reader , LazyComment& comment );
+		static void loadtype( Reader& reader , Type& type );
+		static void loadcallable( Reader& reader , Callable& callable );
+		static void loadfunction( Reader& reader , Function& function );
+		static void loadspecifier( Reader& reader , DeclaratorSpecifier& specifier );
+		static void loaddeclarator( Reader& reader , Declarator& declarator );
+		static void loadblock( Reader& reader , StatementBlock& block );
+		static void loaditeration( Reader& reader , IterationClause& clause );
+		static void loadunit( Reader& reader , CompilationUnit& unit );
+	public:
+		/// <summary>
+		/// Writes a snapshot of the given compilation unit to a stream, which must be opened in binary mode.
+		/// </summary>
+		/// <parameter name="unit" IsConst="true">Compilation unit to save.</parameter>
+		/// <parameter name="os">Stream which receives the snapshot.</parameter>
+		static void Save( const CompilationUnit& unit , std::ostream& os );
+
+		/// <summary>
+		/// Loads a snapshot from memory, which may be a mapped view of a snapshot file.
+		/// </summary>
+		/// <parameter name="data" IsConst="true">Pointer to the snapshot, it is not used after the constructor returns.</parameter>
+		/// <parameter name="size">Size of the snapshot in bytes.</parameter>
+		/// <exception ref="std::invalid_argument">Thrown if the data is not a well formed snapshot.</exception>
+		Snapshot( const char* data , std::size_t size );
+
+		/// <summary>
+		/// Loads a snapshot from a stream, which must be opened in binary mode.
+		/// </summary>
+		/// <parameter name="is">Stream to read the snapshot from, it is read to its end.</parameter>
+		/// <exception ref="std::invalid_argument">Thrown if the stream does not hold a well formed snapshot.</exception>
+		explicit Snapshot( std::istream& is );
+
+		/// <summary>
+		/// Provides access to the reloaded compilation unit.
+		/// </summary>
+		/// <returns>A reference to the compilation unit.</returns>
+		CompilationUnit& Unit( );
+
+		/// <summary>
+		/// Provides access to the nodes the compilation unit refers to without containing them.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A collection of the external nodes, in the order they were first referred to.</returns>
+		const CodeCollection& Externals( ) const;
+	};
+}
+
+#endif
\ No newline at end of file
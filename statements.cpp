@@ -12,9 +12,15 @@ namespace CPlusPlusCodeProvider
 	using std::invalid_argument;
 	using std::auto_ptr;
 
+	UsingStatement::UsingStatement( const copying_pointer< ScopeResolutionExpression >& obj )
+		 : name( obj )
+	{
+		tag( NodeKind::UsingStatement );
+	}
+
 	Comment& UsingStatement::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	UsingStatement& UsingStatement::Duplicate( ) const
@@ -26,8 +32,9 @@ namespace CPlusPlusCodeProvider
 	{
 		const UsingStatement& ref = cast< UsingStatement >( object );
 
-		comment -> Assign( *ref.comment );
+		comment = ref.comment;
 		name -> Assign( *ref.name) ;
+		Invalidate( );
 		return *this;
 	}
 
@@ -41,6 +48,7 @@ namespace CPlusPlusCodeProvider
 	ExpressionStatement& ExpressionStatement::Assign( const CodeObject&object )
 	{		
 		expression = cast< ExpressionStatement >( object ).expression;
+		Invalidate( );
 		return *this;
 	}
 
@@ -51,17 +59,19 @@ namespace CPlusPlusCodeProvider
 
 	Comment& ExpressionStatement::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	ExpressionStatement::ExpressionStatement( )
-		 : expression( 0 ) , is_empty( true ) , comment( Comment::Instantiate( ) )
+		 : expression( 0 ) , is_empty( true )
 	{
+		tag( NodeKind::ExpressionStatement );
 	}
 
 	ExpressionStatement::ExpressionStatement( const copying_pointer< Expression >& expr )
-		 : expression( expr ) , is_empty( false ) , comment( Comment::Instantiate( ) )
+		 : expression( expr ) , is_empty( false )
 	{
+		tag( NodeKind::ExpressionStatement );
 	}
 
 	bool ExpressionStatement::IsEmpty( ) const
@@ -71,8 +81,8 @@ namespace CPlusPlusCodeProvider
 
 	void ExpressionStatement::writetext( wostream& os , unsigned long tabs ) const
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		if( !is_empty )
 			expression -> write( os , tabs );
@@ -80,37 +90,38 @@ namespace CPlusPlusCodeProvider
 	}
 
 	JumpStatement::JumpStatement( const std::wstring& str )
-		: label( str ) , type( JumpType::Goto )
+		: label( str ) , expr( 0 ) , type( JumpType::Goto )
 	{
+		tag( NodeKind::JumpStatement );
 	}
 
 	JumpStatement::JumpStatement( int t )
-		: type( t )
+		: expr( 0 ) , type( t )
 	{
+		tag( NodeKind::JumpStatement );
 		if( type == JumpType::Goto )
 			throw invalid_argument( "" );
 	}
 
 	JumpStatement::JumpStatement( const copying_pointer< Expression >& e )
-		: expr( new copying_pointer< Expression >( static_cast< Expression* >( &( e -> Duplicate( ) ) ) ) ) , type( JumpType::Return )
+		: expr( new copying_pointer< Expression >( e ) ) , type( JumpType::Return )
 	{
+		tag( NodeKind::JumpStatement );
 	}
 
 	JumpStatement::JumpStatement( const JumpStatement& other )
-		: label( other.label ) , type( other.type )
+		: label( other.label ) , expr( other.expr ? new copying_pointer< Expression >( *other.expr ) : 0 ) , type( other.type )
 	{
-		if( type == JumpType::Return )
-			expr = new copying_pointer< Expression >( static_cast< Expression* >( &( other.expr -> operator ->( ) -> Duplicate( ) ) ) );
+		tag( other.Kind( ) );
 	}
 
 	JumpStatement& JumpStatement::Assign( const CodeObject& object )
 	{
 		const JumpStatement& ref = cast< JumpStatement >( object );
-		type = ref.type , label = ref.label;
-		if( expr -> operator -> ( ) )
-			delete expr -> release( );
-		if( ref.expr )
-			expr = new copying_pointer< Expression >( dynamic_cast< Expression* >( &( ref.expr -> operator ->( ) -> Duplicate( ) ) ) );
+		copying_pointer< Expression >* copy = ref.expr ? new copying_pointer< Expression >( *ref.expr ) : 0;
+		delete expr;
+		type = ref.type , label = ref.label , expr = copy;
+		Invalidate( );
 		return *this;
 	}
 
@@ -121,8 +132,7 @@ namespace CPlusPlusCodeProvider
 
 	JumpStatement::~JumpStatement( )
 	{
-		if( type == JumpType::Return )
-			delete expr;
+		delete expr;
 	}
 
 	void JumpStatement::writetext( wostream& os , unsigned long tabs ) const
@@ -137,10 +147,10 @@ namespace CPlusPlusCodeProvider
 		else if( type == JumpType::Return )
 		{
 			os << tab << L"return";
-			if( expr )
+			if( const copying_pointer< Expression >* value = expr )
 			{
 				os << L' ';
-				( *expr ) -> write( os , 0 );
+				( *value ) -> write( os , 0 );
 			}
 			os << L';';
 		}
@@ -150,6 +160,7 @@ namespace CPlusPlusCodeProvider
 	{
 		const LabelStatement& ref = cast< LabelStatement >( object );
 		statement = ref.statement , label = ref.label;
+		Invalidate( );
 		return *this;
 	}
 
@@ -158,9 +169,15 @@ namespace CPlusPlusCodeProvider
 		return *new LabelStatement( *this );
 	}
 
+	void LabelStatement::remap( const CloneScope& scope )
+	{
+		scope.Remap( statement );
+	}
+
 	LabelStatement::LabelStatement( const wstring& str , const Statement& st )
 		 : label( str ) , statement( &st )
 	{
+		tag( NodeKind::LabelStatement );
 	}
 
 	void LabelStatement::writetext( wostream& os , unsigned long tabs ) const
@@ -172,6 +189,7 @@ namespace CPlusPlusCodeProvider
 	StatementBlock& StatementBlock::Assign( const CodeObject& object )
 	{
 		statements.reset( new StatementCollection( *cast< StatementBlock >( object ).statements ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -183,16 +201,19 @@ namespace CPlusPlusCodeProvider
 	StatementBlock::StatementBlock( )
 		 : statements( new StatementCollection( ) )
 	{
+		tag( NodeKind::StatementBlock );
 	}
 
 	StatementBlock::StatementBlock( StatementCollection& statement )
 		 : statements( new StatementCollection( statement ) )
 	{
+		tag( NodeKind::StatementBlock );
 	}
 
 	StatementBlock::StatementBlock( const StatementBlock& other )
 		 : statements( new StatementCollection( *other.statements ) )
 	{
+		tag( other.Kind( ) );
 	}
 
 	StatementCollection& StatementBlock::Statements( ) const
@@ -207,8 +228,9 @@ namespace CPlusPlusCodeProvider
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		if( statements -> size( ) > 1 )
 			os << tab << L"{\n";
+		const StatementCollection& body = *statements;
 		++tabs;
-		for( StatementCollection::const_iterator i = statements -> begin( ) ; i != statements -> end( ) ; ++i )
+		for( StatementCollection::const_iterator i = body.begin( ) ; i != body.end( ) ; ++i )
 		{
 			( **i ).write( os , tabs );
 			os << L'\n';
@@ -219,8 +241,9 @@ namespace CPlusPlusCodeProvider
 	}
 
 	CatchClause::CatchClause( const copying_pointer< VariableDeclaration >& decl )
-		 : var( decl ) , empty( false ) , comment( Comment::Instantiate( ) )
+		 : var( decl ) , empty( false )
 	{
+		tag( NodeKind::CatchClause );
 	}
 
 	CatchClause& CatchClause::Assign( const CodeObject& object )
@@ -228,6 +251,7 @@ namespace CPlusPlusCodeProvider
 		const CatchClause& ref = cast< CatchClause >( object );
 		StatementBlock::Assign( ref );
 		var = ref.var , empty = ref.empty;
+		Invalidate( );
 		return *this;
 	}
 
@@ -238,7 +262,7 @@ namespace CPlusPlusCodeProvider
 
 	Comment& CatchClause::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	const VariableDeclaration& CatchClause::CatchType( ) const
@@ -257,8 +281,8 @@ namespace CPlusPlusCodeProvider
 			var -> writeasparameter( os );
 		}
 		os << L" )\n";
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		if( !Statements( ).size( ) )
 			os << tab << L"{\n";
@@ -268,8 +292,9 @@ namespace CPlusPlusCodeProvider
 	}
 
 	CatchClause::CatchClause( )
-		: var( 0 ) , empty( true ) , comment( Comment::Instantiate( ) )
+		: var( 0 ) , empty( true )
 	{
+		tag( NodeKind::CatchClause );
 	}
 
 	void IterationClause::Assign( const IterationClause& ref )
@@ -283,13 +308,20 @@ namespace CPlusPlusCodeProvider
 		return *comment;
 	}
 
+	void IterationClause::writecomment( wostream& os , unsigned long tabs ) const
+	{
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
+			os << L'\n';
+	}
+
 	IterationClause::IterationClause( )
-		: condition( PrimitiveExpression::Instantiate( ) ) , comment( Comment::Instantiate( ) )
+		: condition( PrimitiveExpression::Instantiate( ) )
 	{
 	}
 
 	IterationClause::IterationClause( const copying_pointer< Expression >& c )
-		 : condition( c ) , comment( Comment::Instantiate( ) )
+		 : condition( c )
 	{
 	}
 
@@ -301,6 +333,7 @@ namespace CPlusPlusCodeProvider
 	void IterationClause::Condition( const copying_pointer< Expression >& expression )
 	{
 		condition = expression;
+		Invalidate( );
 	}
 
 	SwitchStatement& SwitchStatement::Assign( const CodeObject& object )
@@ -308,6 +341,7 @@ namespace CPlusPlusCodeProvider
 		const SwitchStatement& ref = cast< SwitchStatement >( object );
 		condition.release( ) , condition = ref.condition;
 		cases.reset( new CaseCollection( *ref.cases ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -318,23 +352,26 @@ namespace CPlusPlusCodeProvider
 
 	Comment& SwitchStatement::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	SwitchStatement::SwitchStatement( const copying_pointer< Expression >& expr )
-		 : condition( expr ) , cases( 0 ) , comment( Comment::Instantiate( ) )
+		 : condition( expr ) , cases( 0 )
 	{
+		tag( NodeKind::SwitchStatement );
 	}
 
 	SwitchStatement::SwitchStatement( const SwitchStatement& other )
 		 : condition( other.condition ) , cases( new CaseCollection( *other.cases ) ) , comment( other.comment )
 	{
+		tag( other.Kind( ) );
 	}
 
 	Case& Case::Assign( const CodeObject& object )
 	{
 		const Case& ref = cast< Case >( object );
 		label = ref.label , has_variable_declarations = ref.has_variable_declarations , is_default = ref.is_default;
+		Invalidate( );
 		return *this;
 	}
 
@@ -344,13 +381,15 @@ namespace CPlusPlusCodeProvider
 	}
 
 	Case::Case( bool variables )
-		: label( PrimitiveExpression::Instantiate( ) ) , is_default( true ) , has_variable_declarations( variables ) , comment( Comment::Instantiate( ) )
+		: label( PrimitiveExpression::Instantiate( ) ) , is_default( true ) , has_variable_declarations( variables )
 	{
+		tag( NodeKind::Case );
 	}
 
 	Case::Case( const copying_pointer< PrimitiveExpression >& expression , bool variables )
-		 : label( expression ) , has_variable_declarations( variables ) , is_default( false ) , comment( Comment::Instantiate( ) )
+		 : label( expression ) , has_variable_declarations( variables ) , is_default( false )
 	{
+		tag( NodeKind::Case );
 	}
 
 	void Case::writetext( wostream& os , unsigned long tabs ) const
@@ -373,16 +412,16 @@ namespace CPlusPlusCodeProvider
 
 	void SwitchStatement::writetext( wostream& os , unsigned long tabs ) const
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab << L"switch( ";
 		condition -> write( os , 0 );
 		os << L" )\n";
 		os << tab << L"{\n";
-		if( cases.get( ) )
-			for( CaseCollection::const_iterator i = cases -> begin( ) ; i != cases -> end( ) ; ++i )
+		if( const CaseCollection* labels = cases.get( ) )
+			for( CaseCollection::const_iterator i = labels -> begin( ) ; i != labels -> end( ) ; ++i )
 				( *i ) -> write( os , tabs );
 		os << tab << L"}\n";
 	}
@@ -392,6 +431,7 @@ namespace CPlusPlusCodeProvider
 		const TryCatchClause& ref = cast< TryCatchClause >( object );
 		StatementBlock::Assign( ref );
 		catchclauses.reset( new CatchClauseCollection( *ref.catchclauses ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -402,12 +442,13 @@ namespace CPlusPlusCodeProvider
 
 	Comment& TryCatchClause::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	TryCatchClause::TryCatchClause( )
-		 : catchclauses( new CatchClauseCollection ) , comment( Comment::Instantiate( ) )
+		 : catchclauses( new CatchClauseCollection )
 	{
+		tag( NodeKind::TryCatchClause );
 	}
 
 	TryCatchClause::TryCatchClause( const TryCatchClause& other )
@@ -422,8 +463,8 @@ namespace CPlusPlusCodeProvider
 
 	void TryCatchClause::writetext( wostream& os , unsigned long tabs ) const
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab << L"try\n";
@@ -435,7 +476,8 @@ namespace CPlusPlusCodeProvider
 		if( Statements( ).size( ) < 2 )
 			os << tab << L"}\n";
 
-		for( CatchClauseCollection::const_iterator i = catchclauses -> begin( );i != catchclauses -> end( ); ++i )
+		const CatchClauseCollection& clauses = *catchclauses;
+		for( CatchClauseCollection::const_iterator i = clauses.begin( ) ; i != clauses.end( ) ; ++i )
 			( **i ).write( os , tabs );
 	}
 
@@ -444,6 +486,7 @@ namespace CPlusPlusCodeProvider
 		const ConditionClause& ref = cast< ConditionClause >( object );
 		condition.release( ) , condition = ref.condition;
 		else_block.Assign( ref.else_block );
+		Invalidate( );
 		return *this;
 	}
 
@@ -454,12 +497,13 @@ namespace CPlusPlusCodeProvider
 
 	Comment& ConditionClause::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	ConditionClause::ConditionClause( const copying_pointer< Expression >& expr )
-		: condition( expr ) , comment( Comment::Instantiate( ) )
+		: condition( expr )
 	{
+		tag( NodeKind::ConditionClause );
 	}
 
 	const Expression& ConditionClause::Condition( ) const
@@ -478,8 +522,8 @@ namespace CPlusPlusCodeProvider
 		os << tab << L"if( ";
 		condition -> write( os , 0 );
 		os << L" )\n";
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		StatementBlock::writetext( os , tabs );
 		if( else_block.Statements( ).size( ) > 0 )
@@ -494,6 +538,7 @@ namespace CPlusPlusCodeProvider
 		const ForLoop& ref = cast< ForLoop >( object );
 		IterationClause::Assign( ref );
 		init.release( ) , init = ref.init , change.release( ) , change = ref.change;
+		Invalidate( );
 		return *this;
 	}
 
@@ -505,6 +550,7 @@ namespace CPlusPlusCodeProvider
 	ForLoop::ForLoop( )
 		: init( PrimitiveExpression::Instantiate( ) ) , change( PrimitiveExpression::Instantiate( ) )
 	{
+		tag( NodeKind::ForLoop );
 	}
 
 	const Expression& ForLoop::Change( ) const
@@ -515,6 +561,7 @@ namespace CPlusPlusCodeProvider
 	ForLoop& ForLoop::Change( const copying_pointer< Expression >& expression )
 	{
 		change = expression;
+		Invalidate( );
 		return *this;
 	}
 
@@ -526,14 +573,13 @@ namespace CPlusPlusCodeProvider
 	ForLoop& ForLoop::Initialization( const copying_pointer< Expression >& expr )
 	{
 		init = expr;
+		Invalidate( );
 		return *this;
 	}
 
 	void ForLoop::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab << L"for( ";
 		init -> write( os , 0 );
@@ -548,6 +594,7 @@ namespace CPlusPlusCodeProvider
 	WhileLoop& WhileLoop::Assign( const CodeObject& object )
 	{
 		IterationClause::Assign( cast< WhileLoop >( object ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -559,13 +606,12 @@ namespace CPlusPlusCodeProvider
 	WhileLoop::WhileLoop( const copying_pointer< Expression >& condition )
 		 : IterationClause( condition )
 	{
+		tag( NodeKind::WhileLoop );
 	}
 
 	void WhileLoop::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab << L"while( ";
 		Condition( ).write( os , 0 );
@@ -576,6 +622,7 @@ namespace CPlusPlusCodeProvider
 	DoWhileLoop& DoWhileLoop::Assign( const CodeObject&object )
 	{		
 		IterationClause::Assign( cast< DoWhileLoop >( object ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -587,13 +634,12 @@ namespace CPlusPlusCodeProvider
 	DoWhileLoop::DoWhileLoop( const copying_pointer< Expression >& condition )
 		 : IterationClause( condition )
 	{
+		tag( NodeKind::DoWhileLoop );
 	}
 
 	void DoWhileLoop::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab << L"do\n";
 		StatementBlock::writetext( os , tabs );
@@ -13,7 +13,10 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class UsingStatement : public Statement
 	{
-		copying_pointer< Comment > comment;
+		friend class NodeChildren;
+		friend class Snapshot;
+
+		LazyComment comment;
 		copying_pointer< ScopeResolutionExpression > name;
 	public:
 		/// <summary>
@@ -65,9 +68,12 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ExpressionStatement : public Statement
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > expression;
 		bool is_empty;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this expression statement.
@@ -138,6 +144,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class JumpStatement : public Statement
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::wstring label;
 		copying_pointer< Expression >* expr;
 		int type;
@@ -250,6 +259,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class LabelStatement : public Statement
 	{
+		friend class Snapshot;
 		std::wstring label;
 		const Statement* statement;
 	public:
@@ -280,6 +290,12 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		std::wstring Label( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the labelled statement to its copy if it was cloned along with this label.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a new LabelStatement from the given label and Statement object.
 		/// </summary>
@@ -296,13 +312,16 @@ namespace CPlusPlusCodeProvider
 		void writetext( std::wostream& os , unsigned long tabs ) const;
 	};
 
-	typedef TypedCollection< copying_pointer< CodeObject > > StatementCollection;
+	typedef TypedCollection< shared_pointer< CodeObject > > StatementCollection;
 
 	/// <summary>
 	/// Represents a compound statement in code-graph.
 	/// </summary>
 	class StatementBlock : public Statement
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::auto_ptr< StatementCollection > statements;
 	public:
 		/// <summary>
@@ -371,8 +390,11 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class CatchClause : public StatementBlock
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		bool empty;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 		copying_pointer< VariableDeclaration > var;
 	public:
 		/// <summary>
@@ -446,9 +468,12 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Case : public StatementBlock
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< PrimitiveExpression > label;
 		bool has_variable_declarations , is_default;
-		copying_pointer< CPlusPlusCodeProvider::Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this case.
@@ -525,8 +550,11 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class SwitchStatement : public Statement
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > condition;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this switch statement.
@@ -593,8 +621,11 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class TryCatchClause : public StatementBlock
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		std::auto_ptr< CatchClauseCollection > catchclauses;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this try block.
@@ -655,9 +686,12 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ConditionClause : public StatementBlock
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		StatementBlock else_block;
 		copying_pointer< Expression > condition;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this if-else statement.
@@ -721,8 +755,11 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class IterationClause : public StatementBlock
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > condition;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this loop.
@@ -758,6 +795,14 @@ namespace CPlusPlusCodeProvider
 		/// </summary>
 		/// <parameter IsConst="true" name="other">Another IterationClause which will be assigned to this one.</parameter>
 		void Assign( const IterationClause& other );
+
+		/// <summary>
+		/// Writes out the comment applied to this loop followed by a line break, nothing is written if there is no comment.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation for the comment.</parameter>
+		/// <IsConstMember value="true"/>
+		void writecomment( std::wostream& os , unsigned long tabs ) const;
 	};
 
 	/// <summary>
@@ -765,6 +810,9 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class ForLoop : public IterationClause
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		copying_pointer< Expression > init , change;
 	public:
 		/// <summary>
@@ -834,6 +882,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class WhileLoop : public IterationClause
 	{
+		friend class Snapshot;
 	public:
 		/// <summary>
 		/// Creates a new while loop from the given loop condition.
@@ -878,6 +927,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class DoWhileLoop : public IterationClause
 	{
+		friend class Snapshot;
 	public:
 		/// <summary>
 		/// Creates a new do-while loop from the given loop condition.
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <stdexcept>
+#include "symboltable.h"
+#include "compilationunit.h"
+#include "declarations.h"
+#include "functions.h"
+#include "namespace.h"
+#include "types.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::invalid_argument;
+	using std::wstring;
+	using std::vector;
+
+	namespace
+	{
+		bool opensscope( const CodeObject* node )
+		{
+			switch( node -> Kind( ) )
+			{
+			case NodeKind::Namespace:
+			case NodeKind::Union:
+			case NodeKind::UserDefinedType:
+			case NodeKind::Function:
+			case NodeKind::MemberFunction:
+			case NodeKind::Constructor:
+			case NodeKind::Destructor:
+			case NodeKind::Operator:
+			case NodeKind::MemberOperator:
+				return true;
+			default:
+				break;
+			}
+			return false;
+		}
+
+		bool closed( const CodeObject* node )
+		{
+			return !opensscope( node );
+		}
+	}
+
+	SymbolTable::SymbolTable( const CompilationUnit& unit_ )
+		: unit( unit_ )
+	{
+		Scope global = { 0 , 0 };
+		scopes.push_back( global );
+		refresh( );
+	}
+
+	void SymbolTable::drop( Scope& current )
+	{
+		for( vector< Scope* >::const_iterator iter = current.children.begin( ) ; iter != current.children.end( ) ; ++iter )
+		{
+			nodes.erase( ( *iter ) -> node );
+			drop( **iter );
+			unused.push_back( *iter );
+		}
+		current.children.clear( );
+	}
+
+	SymbolTable::Scope& SymbolTable::scope( const CodeObject* node , Scope* parent )
+	{
+		std::unordered_map< const CodeObject* , Scope* >::iterator iter = nodes.find( node );
+		if( iter != nodes.end( ) )
+		{
+			if( !iter -> second -> parent && parent )
+			{
+				iter -> second -> parent = parent;
+				parent -> children.push_back( iter -> second );
+			}
+			return *iter -> second;
+		}
+		Scope added = { node , parent };
+		Scope* result;
+		if( unused.empty( ) )
+		{
+			scopes.push_back( added );
+			result = &scopes.back( );
+		}
+		else
+		{
+			result = unused.back( );
+			unused.pop_back( );
+			*result = added;
+		}
+		if( parent )
+			parent -> children.push_back( result );
+		nodes[ node ] = result;
+		return *result;
+	}
+
+	void SymbolTable::update( Scope& current )
+	{
+		vector< const CodeObject* > added;
+		MemberIndex& members = current.members;
+		unsigned long generation = members.Generation( );
+		if( !current.node )
+			while( !members.Update( 0 , unit.codeblock , &added ) )
+				members.Clear( );
+		else
+			switch( current.node -> Kind( ) )
+			{
+			case NodeKind::Namespace:
+				while( !members.Update( 0 , *static_cast< const Namespace* >( current.node ) -> codeblock , &added ) )
+					members.Clear( );
+				break;
+			case NodeKind::UserDefinedType:
+				{
+					const UserDefinedType& type = *static_cast< const UserDefinedType* >( current.node );
+					type.update( members , &added );
+					while( !members.Update( 8 , *type.template_parameters , &added ) )
+					{
+						members.Clear( );
+						type.update( members , &added );
+					}
+				}
+				break;
+			case NodeKind::Union:
+				{
+					const Union& type = *static_cast< const Union* >( current.node );
+					while( !( members.Update( 0 , *type.template_parameters , &added ) && members.Update( 1 , *type.membervariables , &added )
+						&& members.Update( 2 , *type.memberfunctions , &added ) && members.Update( 3 , *type.memberoperators , &added ) ) )
+						members.Clear( );
+				}
+				break;
+			case NodeKind::Function:
+			case NodeKind::MemberFunction:
+			case NodeKind::Constructor:
+			case NodeKind::Destructor:
+			case NodeKind::Operator:
+			case NodeKind::MemberOperator:
+				{
+					const Function& function = *static_cast< const Function* >( current.node );
+					while( !( members.Update( 0 , *function.template_parameters , &added ) && members.Update( 1 , *function.argumentlist , &added )
+						&& members.Update( 2 , *function.statements , &added ) ) )
+						members.Clear( );
+				}
+				break;
+			default:
+				break;
+			}
+		// Declarations which opened the scopes found before may be gone once the index had to be built again.
+		if( members.Generation( ) != generation )
+			drop( current );
+		for( vector< const CodeObject* >::const_iterator iter = added.begin( ) ; iter != added.end( ) ; ++iter )
+			if( opensscope( *iter ) )
+				scope( *iter , &current );
+	}
+
+	void SymbolTable::refresh( )
+	{
+		vector< Scope* > pending( 1 , &scopes.front( ) );
+		while( !pending.empty( ) )
+		{
+			Scope& current = *pending.back( );
+			pending.pop_back( );
+			update( current );
+			pending.insert( pending.end( ) , current.children.begin( ) , current.children.end( ) );
+		}
+	}
+
+	void SymbolTable::members( Scope& current , const wstring& name , vector< const CodeObject* >& found )
+	{
+		update( current );
+		std::size_t count = found.size( );
+		current.members.Find( name , found );
+		if( found.size( ) != count || !current.node || current.node -> Kind( ) != NodeKind::UserDefinedType )
+			return;
+		const BaseTypeCollection& bases = *static_cast< const UserDefinedType* >( current.node ) -> bases;
+		for( BaseTypeCollection::const_iterator iter = bases.begin( ) ; iter != bases.end( ) ; ++iter )
+			members( scope( iter -> actual , 0 ) , name , found );
+	}
+
+	void SymbolTable::unqualified( Scope& current , const wstring& name , bool scopesonly , vector< const CodeObject* >& found )
+	{
+		std::size_t count = found.size( );
+		for( Scope* searched = &current ; searched && found.size( ) == count ; searched = searched -> parent )
+		{
+			members( *searched , name , found );
+			if( scopesonly )
+				found.erase( std::remove_if( found.begin( ) + count , found.end( ) , closed ) , found.end( ) );
+		}
+	}
+
+	void SymbolTable::lookup( Scope& current , const wstring& name , vector< const CodeObject* >& found )
+	{
+		wstring::size_type begin = 0 , end = name.find( L"::" );
+		bool global = end == 0;
+		if( global )
+			begin = 2 , end = name.find( L"::" , begin );
+		bool last = end == wstring::npos;
+		vector< const CodeObject* > candidates;
+		if( global )
+			members( scopes.front( ) , name.substr( begin , end - begin ) , candidates );
+		else
+			unqualified( current , name.substr( begin , end - begin ) , !last , candidates );
+		while( !last )
+		{
+			begin = end + 2 , end = name.find( L"::" , begin );
+			last = end == wstring::npos;
+			vector< const CodeObject* > next;
+			for( vector< const CodeObject* >::const_iterator iter = candidates.begin( ) ; iter != candidates.end( ) ; ++iter )
+				if( opensscope( *iter ) )
+					members( scope( *iter , 0 ) , name.substr( begin , end - begin ) , next );
+			candidates.swap( next );
+		}
+		found.insert( found.end( ) , candidates.begin( ) , candidates.end( ) );
+	}
+
+	void SymbolTable::Lookup( const wstring& name , vector< const CodeObject* >& found )
+	{
+		lookup( scopes.front( ) , name , found );
+	}
+
+	void SymbolTable::Lookup( const CodeObject& scope , const wstring& name , vector< const CodeObject* >& found )
+	{
+		std::unordered_map< const CodeObject* , Scope* >::iterator iter = nodes.find( &scope );
+		if( iter == nodes.end( ) || !iter -> second -> parent )
+		{
+			refresh( );
+			iter = nodes.find( &scope );
+			if( iter == nodes.end( ) || !iter -> second -> parent )
+				throw invalid_argument( "Scope is not declared in this compilation unit." );
+		}
+		lookup( *iter -> second , name , found );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#ifndef SYMBOLTABLE_HEADER
+#define SYMBOLTABLE_HEADER
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cppcodeprovider.h"
+#include "memberindex.h"
+
+namespace CPlusPlusCodeProvider
+{
+	class CompilationUnit;
+
+	/// <summary>
+	/// Resolves names the way they are looked up in C++ source, from any namespace, class, union or function of a compilation unit.
+	/// Every such scope keeps a MemberIndex of the names it declares and a link to its enclosing scope, so resolving a name costs one hash lookup per scope searched instead of a scan of the whole graph.
+	/// </summary>
+	/// <remarks>Declarations added to the compilation unit after the table was built are picked up by the next lookup which reaches their scope. A scope whose declarations were removed or replaced is indexed again by the next lookup which reaches it, and the scopes its old declarations opened are forgotten.</remarks>
+	class SymbolTable
+	{
+		/// <summary>
+		/// A declarative region, the compilation unit itself has none for its node.
+		/// </summary>
+		struct Scope
+		{
+			const CodeObject* node;
+			Scope* parent;
+			MemberIndex members;
+			std::vector< Scope* > children;
+		};
+
+		const CompilationUnit& unit;
+		std::deque< Scope > scopes;
+		std::unordered_map< const CodeObject* , Scope* > nodes;
+		std::vector< Scope* > unused;
+
+		SymbolTable( const SymbolTable& );
+		SymbolTable& operator = ( const SymbolTable& );
+
+		/// <summary>
+		/// Forgets the scopes opened by the declarations of a scope, at any depth, their places are reused for scopes added later.
+		/// </summary>
+		/// <parameter name="current">Scope whose declarations may have been removed.</parameter>
+		void drop( Scope& current );
+
+		/// <summary>
+		/// Returns the scope of the given node, adding it if it has not been seen yet.
+		/// </summary>
+		/// <parameter name="node" IsConst="true">Namespace, type or function which opens the scope.</parameter>
+		/// <parameter name="parent">Enclosing scope, or null if it is not known yet.</parameter>
+		/// <returns>The scope of node.</returns>
+		Scope& scope( const CodeObject* node , Scope* parent );
+		/// <summary>
+		/// Indexes the declarations added to a scope since it was last updated and adds the scopes they open.
+		/// If the scope has to be indexed again because its declarations were removed or replaced, the scopes opened by its old declarations are dropped first.
+		/// </summary>
+		/// <parameter name="current">Scope to update.</parameter>
+		void update( Scope& current );
+		/// <summary>
+		/// Updates every scope reachable from the global one, including those found while doing so, which is only needed to find a scope not reached by a lookup yet.
+		/// </summary>
+		void refresh( );
+		/// <summary>
+		/// Finds the members of a scope with the given name, those of base classes are searched if a class declares none itself.
+		/// </summary>
+		/// <parameter name="current">Scope to search.</parameter>
+		/// <parameter name="name" IsConst="true">Unqualified name to find.</parameter>
+		/// <parameter name="found">List which receives the declarations found.</parameter>
+		void members( Scope& current , const std::wstring& name , std::vector< const CodeObject* >& found );
+		/// <summary>
+		/// Finds the declarations with the given name in the innermost scope which has any, starting from the given one.
+		/// </summary>
+		/// <parameter name="current">Scope to start from.</parameter>
+		/// <parameter name="name" IsConst="true">Unqualified name to find.</parameter>
+		/// <parameter name="scopesonly">True to skip declarations which do not open a scope, as for the leftmost name of a qualified name.</parameter>
+		/// <parameter name="found">List which receives the declarations found.</parameter>
+		void unqualified( Scope& current , const std::wstring& name , bool scopesonly , std::vector< const CodeObject* >& found );
+		/// <summary>
+		/// Finds the declarations a possibly qualified name refers to from the given scope.
+		/// </summary>
+		/// <parameter name="current">Scope in which the name appears.</parameter>
+		/// <parameter name="name" IsConst="true">Name to find.</parameter>
+		/// <parameter name="found">List which receives the declarations found.</parameter>
+		void lookup( Scope& current , const std::wstring& name , std::vector< const CodeObject* >& found );
+	public:
+		/// <summary>
+		/// Builds the scopes of every declaration in the given compilation unit.
+		/// </summary>
+		/// <parameter name="unit" IsConst="true">Compilation unit whose names are resolved, it must outlive this table.</parameter>
+		explicit SymbolTable( const CompilationUnit& unit );
+
+		/// <summary>
+		/// Finds the declarations a name refers to at the global scope of the compilation unit, overloads included.
+		/// </summary>
+		/// <parameter name="name" IsConst="true">Name to find, which may be qualified with "::" and start with it.</parameter>
+		/// <parameter name="found">List which receives the declarations found, nothing is added if the name is not declared.</parameter>
+		void Lookup( const std::wstring& name , std::vector< const CodeObject* >& found );
+		/// <summary>
+		/// Finds the declarations a name refers to when it appears in the given scope, overloads included.
+		/// Unqualified names are searched from the given scope outwards, the members of base classes being searched when a class declares none with that name.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Namespace, class, union or function of the compilation unit in which the name appears.</parameter>
+		/// <parameter name="name" IsConst="true">Name to find, which may be qualified with "::" and start with it.</parameter>
+		/// <parameter name="found">List which receives the declarations found, nothing is added if the name is not declared.</parameter>
+		/// <exception ref="std::invalid_argument">If scope does not belong to the compilation unit.</exception>
+		void Lookup( const CodeObject& scope , const std::wstring& name , std::vector< const CodeObject* >& found );
+	};
+}
+
+#endif
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace CPlusPlusCodeProvider
 		const Typedefinition& ref = cast< Typedefinition >( object );
 		defining_type = ref.defining_type;
  		synonyms.reset( new StringCollection( *ref.synonyms ) );
+		Invalidate( );
 		return *this;
 	}
 
@@ -23,18 +24,20 @@ namespace CPlusPlusCodeProvider
 
 	Comment& Typedefinition::Comment( )
 	{
-		return *comment;
+		return comment.Acquire( );
 	}
 
 	Typedefinition::Typedefinition( const wstring& name , const wstring& synonym )
-		 : defining_type( name ) , synonyms( new StringCollection( ) ) , comment( Comment::Instantiate( ) )
+		 : defining_type( name ) , synonyms( new StringCollection( ) )
 	{
+		tag( NodeKind::Typedefinition );
 		synonyms -> push_back( synonym );
 	}
 
 	Typedefinition::Typedefinition( const Typedefinition& other )
 		: defining_type( other.defining_type ) , synonyms( new StringCollection( *other.synonyms ) ) , comment( other.comment )
 	{
+		tag( other.Kind( ) );
 	}
 
 	StringCollection& Typedefinition::Synonyms( ) const
@@ -49,8 +52,8 @@ namespace CPlusPlusCodeProvider
 
 	void Typedefinition::writetext( wostream& os , unsigned long tabs ) const //incorrect
 	{
-		comment -> write( os , tabs );
-		if( !comment -> IsEmpty( ) )
+		comment.write( os , tabs );
+		if( !comment.IsEmpty( ) )
 			os << L'\n';
 		os << wstring( tabs , FormattingData::IndentationCharacter ) << L"typedef " << defining_type << L' ';
 		StringCollection::const_iterator i = synonyms -> begin( );
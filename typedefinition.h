@@ -13,9 +13,10 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Typedefinition : public CodeObject
 	{
+		friend class Snapshot;
 		std::wstring defining_type;
 		std::auto_ptr< StringCollection > synonyms;
-		copying_pointer< Comment > comment;
+		LazyComment comment;
 	public:
 		/// <summary>
 		/// Returns a reference to the comments applied to this typedefinition.
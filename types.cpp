@@ -1,11 +1,13 @@
 #include "collections.h"
 #include "declarations.h"
+#include "dependencygraph.h"
 #include "exceptions.h"
 #include "expressions.h"
 #include "functions.h"
+#include "memberindex.h"
 #include "typedefinition.h"
 #include "types.h"
-#include <sstream>
+#include "output.h"
 
 namespace CPlusPlusCodeProvider
 {
@@ -14,11 +16,11 @@ namespace CPlusPlusCodeProvider
 	using std::wostream;
 	using std::auto_ptr;
 	using std::vector;
-	using std::wostringstream;
 
 	BasicType& BasicType::Assign( const CodeObject& object )
 	{
 		Type::Assign( cast< BasicType >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -30,6 +32,7 @@ namespace CPlusPlusCodeProvider
 	BasicType::BasicType( const wstring& name )
 		 : Type( validate( name ) )
 	{
+		tag( NodeKind::BasicType );
 	}
 
 	const wstring& BasicType::validate( const wstring& name )
@@ -68,21 +71,24 @@ namespace CPlusPlusCodeProvider
 
 	Union& Union::Assign( const nestabletype& object )
 	{
-		Assign( cast< Union >( object ) , true );
+		// nestabletype does not carry a kind, it is cast across to the CodeObject side of the hierarchy.
+		Assign( dynamic_cast< const Union& >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
 	void Union::Assign( const Union& ref , bool )
 	{
 		Type::Assign( ref , true );
-		membervariables.reset( new MemberVariableCollection( *ref.membervariables ) );
-		memberfunctions.reset( new MemberFunctionCollection( *ref.memberfunctions ) );
-		memberoperators.reset( new MemberOperatorCollection( *ref.memberoperators ) );
+		membervariables = ref.membervariables;
+		memberfunctions = ref.memberfunctions;
+		memberoperators = ref.memberoperators;
 	}
 
 	Union& Union::Assign( const CodeObject& object )
 	{
 		Assign( cast< Union >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -91,13 +97,19 @@ namespace CPlusPlusCodeProvider
 		return *new Union( *this );
 	}
 
+	void Union::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+	}
+
 	Union::Union( const wstring& name )
-		 : Type( name ) , membervariables( new MemberVariableCollection ) , memberfunctions( new MemberFunctionCollection ) , memberoperators( new MemberOperatorCollection ) , enclosingtype( 0 )
+		 : Type( name ) , enclosingtype( 0 )
 	{
+		tag( NodeKind::Union );
 	}
 
 	Union::Union( const Union& other )
-		: memberfunctions( new MemberFunctionCollection( *other.memberfunctions ) ) , memberoperators( new MemberOperatorCollection( *other.memberoperators ) ) , membervariables( new MemberVariableCollection( *other.membervariables ) ) , Type( other ) , enclosingtype( other.enclosingtype )
+		: memberfunctions( other.memberfunctions ) , memberoperators( other.memberoperators ) , membervariables( other.membervariables ) , template_parameters( other.template_parameters ) , Type( other ) , enclosingtype( other.enclosingtype )
 	{
 	}
 
@@ -109,6 +121,7 @@ namespace CPlusPlusCodeProvider
 	Union& Union::Inline( bool flag )
 	{
 		is_inline = flag;
+		Invalidate( );
 		return *this;
 	}
 
@@ -149,9 +162,7 @@ namespace CPlusPlusCodeProvider
 
 	void Union::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 
 		os << tab << L"union";
@@ -213,9 +224,8 @@ namespace CPlusPlusCodeProvider
 
 	void Union::writetext( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
 	{
-		Comment( ).write( declos , decltabs );
-		if( !Comment( ).IsEmpty( ) )
-			declos << L'\n';
+		const RenderContext members = RenderContext( ).Nested( );
+		writecomment( declos , decltabs );
 		wstring tab( decltabs , FormattingData::IndentationCharacter );
 		declos << tab;
 
@@ -249,66 +259,80 @@ namespace CPlusPlusCodeProvider
 				if( !( *i ) -> Inline( ) )
 					( *i ) -> write( declos , defos , decltabs , deftabs );
 				else
-				{
-					bool flag = ( *i ) -> separate;
-					( *i ) -> separate = false;
-					( *i ) -> write( declos , decltabs );
-					( *i ) -> separate = flag;
-				}
+					( *i ) -> writeinclass( declos , decltabs , members );
 		declos << tab << "private:\n";
 		for( MemberOperatorCollection::const_iterator i = memberoperators -> begin( ) ; i != memberoperators -> end( ) ; ++i )
 			if( ( *i ) -> Access( ) == Private )
 				if( !( *i ) -> Inline( ) )
 					( *i ) -> write( declos , defos , decltabs , deftabs );
 				else
-				{
-					bool flag = ( *i ) -> separate;
-					( *i ) -> separate = false;
-					( *i ) -> write( declos , decltabs );
-					( *i ) -> separate = flag;
-				}
+					( *i ) -> writeinclass( declos , decltabs , members );
 		declos << tab << "public:\n";
 		for( MemberFunctionCollection::const_iterator i = memberfunctions -> begin( ) ; i != memberfunctions -> end( ) ; ++i )
 			if( ( *i ) -> Access( ) == Public )
 				if( !( *i ) -> Inline( ) )
 					( *i ) -> write( declos , defos , decltabs , deftabs );
 				else
-				{
-					bool flag = ( *i ) -> separate;
-					( *i ) -> separate = false;
-					( *i ) -> write( declos , decltabs );
-					( *i ) -> separate = flag;
-				}
+					( *i ) -> writeinclass( declos , decltabs , members );
 		declos << tab << "private:\n";
 		for( MemberFunctionCollection::const_iterator i = memberfunctions -> begin( ) ; i != memberfunctions -> end( ) ; ++i )
 			if( ( *i ) -> Access( ) == Private )
 				if( !( *i ) -> Inline( ) )
 					( *i ) -> write( declos , defos , decltabs , deftabs );
 				else
-				{
-					bool flag = ( *i ) -> separate;
-					( *i ) -> separate = false;
-					( *i ) -> write( declos , decltabs );
-					( *i ) -> separate = flag;
-				}
+					( *i ) -> writeinclass( declos , decltabs , members );
 		--decltabs;
 		tab.assign( wstring( decltabs , FormattingData::IndentationCharacter ) );
 		declos << tab << L"};\n";
 	}
 
-	MemberVariableCollection& Union::MemberVariables( ) const
+	void Union::writetext( wostream& declos , wostream& defos , wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		write( declos , defos , decltabs , deftabs );
+		if( Name( ).size( ) )
+			declaration( fwdos , decltabs );
+	}
+
+	void Union::declaration( wostream& os , unsigned long tabs ) const
+	{
+		track( );
+		os << wstring( tabs , FormattingData::IndentationCharacter );
+		writetemplateattributes( os );
+		os << L"union " << Name( ) << L";\n";
+	}
+
+	MemberVariableCollection& Union::MemberVariables( )
+	{
+		return membervariables.Acquire( );
+	}
+
+	const MemberVariableCollection& Union::MemberVariables( ) const
 	{
 		return *membervariables;
 	}
 
-	MemberFunctionCollection& Union::MemberFunctions( ) const
+	MemberFunctionCollection& Union::MemberFunctions( )
+	{
+		if( !Name( ).size( ) )
+			throw NotSupportedException( "Only named unions can have member functions." );
+		return memberfunctions.Acquire( );
+	}
+
+	const MemberFunctionCollection& Union::MemberFunctions( ) const
 	{
 		if( !Name( ).size( ) )
 			throw NotSupportedException( "Only named unions can have member functions." );
 		return *memberfunctions;
 	}
 
-	MemberOperatorCollection& Union::MemberOperators( ) const
+	MemberOperatorCollection& Union::MemberOperators( )
+	{
+		if( !Name( ).size( ) )
+			throw NotSupportedException( "Only named unions can have member operators." );
+		return memberoperators.Acquire( );
+	}
+
+	const MemberOperatorCollection& Union::MemberOperators( ) const
 	{
 		if( !Name( ).size( ) )
 			throw NotSupportedException( "Only named unions can have member operators." );
@@ -327,9 +351,7 @@ namespace CPlusPlusCodeProvider
 
 	void TemplateParameter::writetext( wostream& os , unsigned long ) const
 	{
-		Comment( ).write( os , 0 );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , 0 );
 		os << L"typename " << Name( );
 	}
 
@@ -341,12 +363,14 @@ namespace CPlusPlusCodeProvider
 	NontypeParameter& NontypeParameter::Assign( const CodeObject& object )
 	{
 		Type::Assign( cast< NontypeParameter >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
 	NontypeParameter::NontypeParameter( const wstring& name )
 		 : TemplateParameter( validate( name ) )
 	{
+		tag( NodeKind::NontypeParameter );
 	}
 
 	bool NontypeParameter::IsIntegral( ) const
@@ -374,6 +398,7 @@ namespace CPlusPlusCodeProvider
 	TypedParameter& TypedParameter::Assign( const CodeObject& object )
 	{
 		Type::Assign( cast< TypedParameter >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -385,6 +410,7 @@ namespace CPlusPlusCodeProvider
 	TypedParameter::TypedParameter( const wstring& name )
 		 : TemplateParameter( validate( name ) )
 	{
+		tag( NodeKind::TypedParameter );
 	}
 
 	const wstring& TypedParameter::validate( const wstring& name ) const
@@ -405,6 +431,7 @@ namespace CPlusPlusCodeProvider
 		const TemplateTemplateParameter& ref = cast< TemplateTemplateParameter >( object );
 		arguments = ref.arguments;
 		Type::Assign( ref , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -416,6 +443,7 @@ namespace CPlusPlusCodeProvider
 	TemplateTemplateParameter::TemplateTemplateParameter( const wstring& name , unsigned int args )
 		 : TemplateParameter( validate( name ) ) , arguments( args )
 	{
+		tag( NodeKind::TemplateTemplateParameter );
 	}
 
 	const wstring& TemplateTemplateParameter::validate( const wstring& name ) const
@@ -442,6 +470,7 @@ namespace CPlusPlusCodeProvider
 	TypedefinedType& TypedefinedType::Assign( const CodeObject& object )
 	{
 		Type::Assign( cast< TypedefinedType >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -453,6 +482,7 @@ namespace CPlusPlusCodeProvider
 	TypedefinedType::TypedefinedType( const copying_pointer< Typedefinition >& typedefinition , const wstring& name )
 		 : Type( validate( typedefinition , name ) )
 	{
+		tag( NodeKind::TypedefinedType );
 	}
 
 	void TypedefinedType::writetext( wostream& declos , wostream& , unsigned long decltabs , unsigned long ) const
@@ -477,17 +507,21 @@ namespace CPlusPlusCodeProvider
 	{
 		Type::Assign( ref , true );
 		enumerators = ref.enumerators;
+		underlying = ref.underlying;
 	}
 
 	Enumeration& Enumeration::Assign( const CodeObject&object )
 	{
 		Assign( cast< Enumeration >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
 	Enumeration& Enumeration::Assign( const nestabletype& object )
 	{
-		Assign( cast< Enumeration >( object ) , true );
+		// nestabletype does not carry a kind, it is cast across to the CodeObject side of the hierarchy.
+		Assign( dynamic_cast< const Enumeration& >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -496,38 +530,62 @@ namespace CPlusPlusCodeProvider
 		return *new Enumeration( *this );
 	}
 
+	void Enumeration::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+		scope.Remap( underlying );
+	}
+
 	Enumeration::Enumeration( const wstring& str )
-		: Type( str ) , enclosingtype( 0 )
+		: Type( str ) , enclosingtype( 0 ) , underlying( 0 )
 	{
+		tag( NodeKind::Enumeration );
 	}
 
 	Enumeration::Enumeration( const wstring& str , const enumeratorlist& enumerator )
-		 : Type( str ) , enumerators( enumerator ) , enclosingtype( 0 )
+		 : Type( str ) , enumerators( enumerator ) , enclosingtype( 0 ) , underlying( 0 )
 	{
+		tag( NodeKind::Enumeration );
 	}
 
 	Enumeration::Enumeration( const Enumeration& other )
-		 : Type( other ) , enumerators( other.enumerators )
+		 : Type( other ) , enumerators( other.enumerators ) , underlying( other.underlying )
 	{
 	}
 
 	enumeratorlist& Enumeration::Enumerators( )
 	{
+		Invalidate( );
 		return enumerators;
 	}
 
+	const Type* Enumeration::UnderlyingType( ) const
+	{
+		return underlying;
+	}
+
+	Enumeration& Enumeration::UnderlyingType( Type& type )
+	{
+		underlying = &type;
+		Invalidate( );
+		return *this;
+	}
+
 	void Enumeration::writetext( wostream& os , unsigned long tabs ) const
 	{
-		Comment( ).write( os , tabs );
-		if( !Comment( ).IsEmpty( ) )
-			os << L'\n';
+		writecomment( os , tabs );
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << tab;
 
 		os << L"enum";
 
 		if( Name( ).length( ) )
-			os << Name( );
+			os << L' ' << Name( );
+		if( underlying )
+		{
+			os << L" : " << underlying -> Name( );
+			refer( *underlying );
+		}
 		os << L'\n' << tab << L"{\n";
 		tab.assign( tabs + 1 , FormattingData::IndentationCharacter );
 		if( enumerators.size( ) > 0 )
@@ -565,6 +623,14 @@ namespace CPlusPlusCodeProvider
 		writetext( declos , decltabs );
 	}
 
+	void Enumeration::writetext( wostream& declos , wostream& defos , wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		write( declos , defos , decltabs , deftabs );
+		// An enumeration can only be declared without its enumerators if its underlying type is fixed.
+		if( Name( ).length( ) && underlying )
+			fwdos << wstring( decltabs , FormattingData::IndentationCharacter ) << L"enum " << Name( ) << L" : " << underlying -> Name( ) << L";\n";
+	}
+
 	void Enumeration::writetemplateattributesrecursive( wostream& ) const
 	{
 		throw NotSupportedException( "An enumeration cannot have template parameters." );
@@ -591,6 +657,7 @@ namespace CPlusPlusCodeProvider
 		{
 			arguments.reset( new StringCollection( *other.arguments ) );
 			access = other.access , actual = other.actual;
+			cache.Invalidate( );
 		}
 		return *this;
 	}
@@ -600,6 +667,11 @@ namespace CPlusPlusCodeProvider
 		return *actual;
 	}
 
+	void BaseType::remap( const CloneScope& scope )
+	{
+		scope.Remap( actual );
+	}
+
 	bool BaseType::Virtual( ) const
 	{
 		return is_virtual;
@@ -608,11 +680,13 @@ namespace CPlusPlusCodeProvider
 	BaseType& BaseType::Virtual( bool flag )
 	{
 		is_virtual = flag;
+		cache.Invalidate( );
 		return *this;
 	}
 
 	void BaseType::write( wostream& os ) const
 	{
+		cache.Track( );
 		switch( access )
 		{
 		case Public:
@@ -628,6 +702,7 @@ namespace CPlusPlusCodeProvider
 		if( is_virtual )
 			os << L"virtual ";
 		os << actual -> instantiate( *arguments );
+		CodeObject::refer( *actual );
 	}
 
 	UserDefinedType& UserDefinedType::Duplicate( ) const
@@ -635,54 +710,85 @@ namespace CPlusPlusCodeProvider
 		return *new UserDefinedType( *this );
 	}
 
+	void UserDefinedType::remap( const CloneScope& scope )
+	{
+		scope.Remap( enclosingtype );
+		if( bases.Allocated( ) )
+			for( BaseTypeCollection::iterator iter = bases.Acquire( ).begin( ) ; iter != bases.Acquire( ).end( ) ; ++iter )
+				iter -> remap( scope );
+		// Copies share their destructor, the clone gets its own so that it can refer back to the cloned type.
+		if( destructor )
+		{
+			class Destructor& copy = destructor -> Duplicate( );
+			CloneScope::Copied( *destructor , copy );
+			destructor = &copy;
+		}
+	}
+
 	void UserDefinedType::Assign( const UserDefinedType& ref , bool )
 	{
 		Type::Assign( ref , true );
-		typedefinitions.reset( new MemberTypedefinitionCollection( *ref.typedefinitions ) );
-		memberuserdefinedtypes.reset( new NestedTypeCollection( *ref.memberuserdefinedtypes ) );
-		memberfunctions.reset( new MemberFunctionCollection( *ref.memberfunctions ) );
-		memberenumerations.reset( new MemberEnumerationCollection( *ref.memberenumerations ) );
-		memberunions.reset( new MemberUnionCollection( *ref.memberunions ) );
-		memberoperators.reset( new MemberOperatorCollection( *ref.memberoperators ) );
-		membervariables.reset( new MemberVariableCollection( *ref.membervariables ) );
-		constructors.reset( new ConstructorCollection( *ref.constructors ) );
+		typedefinitions = ref.typedefinitions;
+		memberuserdefinedtypes = ref.memberuserdefinedtypes;
+		memberfunctions = ref.memberfunctions;
+		memberenumerations = ref.memberenumerations;
+		memberunions = ref.memberunions;
+		memberoperators = ref.memberoperators;
+		membervariables = ref.membervariables;
+		constructors = ref.constructors;
 		destructor = ref.destructor;
-		template_parameters.reset( new TemplateParameterCollection( *ref.template_parameters ) );
-		bases.reset( new BaseTypeCollection( *ref.bases ) );
-		specialized_parameters.reset( new TypeCollection( *ref.specialized_parameters ) );
+		template_parameters = ref.template_parameters;
+		bases = ref.bases;
+		specialized_parameters = ref.specialized_parameters;
 		is_sealed = ref.is_sealed;
 		usertype = ref.usertype;
 		enclosingtype = ref.enclosingtype;
+		// Collections are assigned in place, so the index can not tell their elements were replaced.
+		if( index.get( ) )
+			index -> Clear( );
 	}
 
 	UserDefinedType& UserDefinedType::Assign( const nestabletype& object )
 	{
-		Assign( cast< UserDefinedType >( object ) , true );
+		// nestabletype does not carry a kind, it is cast across to the CodeObject side of the hierarchy.
+		Assign( dynamic_cast< const UserDefinedType& >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
 	UserDefinedType& UserDefinedType::Assign( const CodeObject& object )
 	{
 		Assign( cast< UserDefinedType >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
 	UserDefinedType::UserDefinedType( const wstring& name , UserType type )
-		 : Type( name ) , typedefinitions( new MemberTypedefinitionCollection ) , memberuserdefinedtypes( new NestedTypeCollection ) , memberfunctions( new MemberFunctionCollection ) , memberenumerations( new MemberEnumerationCollection ) , memberunions( new MemberUnionCollection ) , membervariables( new MemberVariableCollection ) , memberoperators( new MemberOperatorCollection ) , constructors( new ConstructorCollection ) , template_parameters( new TemplateParameterCollection ) , usertype( type ) , destructor( 0 ) , specialized_parameters( new TypeCollection ) , bases( new BaseTypeCollection ) , enclosingtype( 0 ) , nestinglevel( 0 )
+		 : Type( name ) , usertype( type ) , destructor( 0 ) , enclosingtype( 0 )
 	{
+		tag( NodeKind::UserDefinedType );
 	}
 
 	UserDefinedType::UserDefinedType( const UserDefinedType& other )
-		 : Type( other ) , usertype( other.usertype ) , typedefinitions( new MemberTypedefinitionCollection( *other.typedefinitions ) ) , memberuserdefinedtypes( new NestedTypeCollection( *other.memberuserdefinedtypes ) ) , memberfunctions( new MemberFunctionCollection( *other.memberfunctions ) ) , memberenumerations( new MemberEnumerationCollection( *other.memberenumerations ) ) , memberunions( new MemberUnionCollection( *other.memberunions ) ) , membervariables( new MemberVariableCollection( *other.membervariables ) ) , memberoperators( new MemberOperatorCollection( *other.memberoperators ) ) , constructors( new ConstructorCollection( *other.constructors ) ) , destructor( other.destructor ) , template_parameters( new TemplateParameterCollection( *other.template_parameters ) ) , specialized_parameters( other.specialized_parameters.get( ) ? new TypeCollection( *other.specialized_parameters ) : 0 ) , bases( other.bases.get( ) ? new BaseTypeCollection( *other.bases ) : 0 ) , enclosingtype( other.enclosingtype ) , nestinglevel( 0 )
+		 : Type( other ) , usertype( other.usertype ) , typedefinitions( other.typedefinitions ) , memberuserdefinedtypes( other.memberuserdefinedtypes ) , memberfunctions( other.memberfunctions ) , memberenumerations( other.memberenumerations ) , memberunions( other.memberunions ) , membervariables( other.membervariables ) , memberoperators( other.memberoperators ) , constructors( other.constructors ) , destructor( other.destructor ) , template_parameters( other.template_parameters ) , specialized_parameters( other.specialized_parameters ) , bases( other.bases ) , enclosingtype( other.enclosingtype ) , index( other.index.get( ) ? new MemberIndex : 0 )
+	{
+	}
+
+	UserDefinedType::~UserDefinedType( )
 	{
 	}
 
 	bool UserDefinedType::IsSpecialized( ) const
 	{
-		return specialized_parameters.get( ) && specialized_parameters -> size( ) != 0;
+		return specialized_parameters -> size( ) != 0;
+	}
+
+	BaseTypeCollection& UserDefinedType::BaseTypes( )
+	{
+		return bases.Acquire( );
 	}
 
-	BaseTypeCollection& UserDefinedType::BaseTypes( ) const
+	const BaseTypeCollection& UserDefinedType::BaseTypes( ) const
 	{
 		return *bases;
 	}
@@ -700,10 +806,16 @@ namespace CPlusPlusCodeProvider
 	UserDefinedType& UserDefinedType::Inline( bool flag )
 	{
 		is_inline = flag;
+		Invalidate( );
 		return *this;
 	}
 
-	TemplateParameterCollection& UserDefinedType::TemplateParameters( ) const
+	TemplateParameterCollection& UserDefinedType::TemplateParameters( )
+	{
+		return template_parameters.Acquire( );
+	}
+
+	const TemplateParameterCollection& UserDefinedType::TemplateParameters( ) const
 	{
 		return *template_parameters;
 	}
@@ -716,8 +828,9 @@ namespace CPlusPlusCodeProvider
 	UserDefinedType& UserDefinedType::Abstract( bool flag )
 	{
 		if( !destructor )
-			destructor = &Destructor::Instantiate( *this , Public ) -> Duplicate( );
+			destructor = Destructor::Instantiate( *this , Public ).release( );
 		destructor -> Pure( flag );
+		Invalidate( );
 		return *this;
 	}
 
@@ -729,6 +842,7 @@ namespace CPlusPlusCodeProvider
 	UserDefinedType& UserDefinedType::EnclosingType( nestabletype* type )
 	{
 		enclosingtype = type;
+		Invalidate( );
 		return *this;
 	}
 
@@ -737,37 +851,72 @@ namespace CPlusPlusCodeProvider
 		return usertype;
 	}
 
-	MemberTypedefinitionCollection& UserDefinedType::Typedefinitions( ) const
+	MemberTypedefinitionCollection& UserDefinedType::Typedefinitions( )
+	{
+		return typedefinitions.Acquire( );
+	}
+
+	const MemberTypedefinitionCollection& UserDefinedType::Typedefinitions( ) const
 	{
 		return *typedefinitions;
 	}
 
-	NestedTypeCollection& UserDefinedType::MemberTypes( ) const
+	NestedTypeCollection& UserDefinedType::MemberTypes( )
+	{
+		return memberuserdefinedtypes.Acquire( );
+	}
+
+	const NestedTypeCollection& UserDefinedType::MemberTypes( ) const
 	{
 		return *memberuserdefinedtypes;
 	}
 
-	MemberFunctionCollection& UserDefinedType::MemberFunctions( ) const
+	MemberFunctionCollection& UserDefinedType::MemberFunctions( )
+	{
+		return memberfunctions.Acquire( );
+	}
+
+	const MemberFunctionCollection& UserDefinedType::MemberFunctions( ) const
 	{
 		return *memberfunctions;
 	}
 
-	MemberEnumerationCollection& UserDefinedType::MemberEnumerations( ) const
+	MemberEnumerationCollection& UserDefinedType::MemberEnumerations( )
+	{
+		return memberenumerations.Acquire( );
+	}
+
+	const MemberEnumerationCollection& UserDefinedType::MemberEnumerations( ) const
 	{
 		return *memberenumerations;
 	}
 
-	MemberUnionCollection& UserDefinedType::MemberUnions( ) const
+	MemberUnionCollection& UserDefinedType::MemberUnions( )
+	{
+		return memberunions.Acquire( );
+	}
+
+	const MemberUnionCollection& UserDefinedType::MemberUnions( ) const
 	{
 		return *memberunions;
 	}
 
-	MemberVariableCollection& UserDefinedType::MemberVariables( ) const
+	MemberVariableCollection& UserDefinedType::MemberVariables( )
+	{
+		return membervariables.Acquire( );
+	}
+
+	const MemberVariableCollection& UserDefinedType::MemberVariables( ) const
 	{
 		return *membervariables;
 	}
 
-	MemberOperatorCollection& UserDefinedType::MemberOperators( ) const
+	MemberOperatorCollection& UserDefinedType::MemberOperators( )
+	{
+		return memberoperators.Acquire( );
+	}
+
+	const MemberOperatorCollection& UserDefinedType::MemberOperators( ) const
 	{
 		return *memberoperators;
 	}
@@ -781,19 +930,61 @@ namespace CPlusPlusCodeProvider
 	{
 		is_sealed = flag;
 		AccessRestrictions access = flag ? Private : Public;
-		for( ConstructorCollection::const_iterator i = Constructors( ).begin( ) , j = Constructors( ).end( ) ; i != j ; i++ )
+		for( ConstructorCollection::const_iterator i = constructors -> begin( ) , j = constructors -> end( ) ; i != j ; i++ )
 		{
 			copying_pointer< Constructor > p = *i;
 			p -> Access( access );
 		}
+		Invalidate( );
 		return *this;
 	}
 
-	ConstructorCollection& UserDefinedType::Constructors( ) const
+	ConstructorCollection& UserDefinedType::Constructors( )
+	{
+		return constructors.Acquire( );
+	}
+
+	const ConstructorCollection& UserDefinedType::Constructors( ) const
 	{
 		return *constructors;
 	}
 
+	bool UserDefinedType::Indexed( ) const
+	{
+		return index.get( ) != 0;
+	}
+
+	UserDefinedType& UserDefinedType::Indexed( bool flag )
+	{
+		if( !flag )
+			index.reset( );
+		else if( !index.get( ) )
+			index.reset( new MemberIndex );
+		return *this;
+	}
+
+	void UserDefinedType::update( MemberIndex& members , vector< const CodeObject* >* added ) const
+	{
+		while( !( members.Update( 0 , *typedefinitions , added ) && members.Update( 1 , *memberuserdefinedtypes , added ) && members.Update( 2 , *memberenumerations , added ) && members.Update( 3 , *memberunions , added )
+			&& members.Update( 4 , *membervariables , added ) && members.Update( 5 , *constructors , added ) && members.Update( 6 , *memberfunctions , added ) && members.Update( 7 , *memberoperators , added ) ) )
+			members.Clear( );
+	}
+
+	void UserDefinedType::Find( const wstring& name , vector< const CodeObject* >& members ) const
+	{
+		if( index.get( ) )
+		{
+			update( *index );
+			index -> Find( name , members );
+		}
+		else
+		{
+			MemberIndex scan;
+			update( scan );
+			scan.Find( name , members );
+		}
+	}
+
 	Destructor* UserDefinedType::Destructor( ) const
 	{
 		return destructor;
@@ -802,12 +993,18 @@ namespace CPlusPlusCodeProvider
 	UserDefinedType& UserDefinedType::Destructor( copying_pointer< class Destructor >& dstr )
 	{
 		destructor = dstr.release( );
+		Invalidate( );
 		return *this;
 	}
 
-	bool UserDefinedType::hasbacklog( ) const
+	TypeCollection& UserDefinedType::SpecializedParameters( )
 	{
-		return !render_backlog.empty( );
+		return specialized_parameters.Acquire( );
+	}
+
+	const TypeCollection& UserDefinedType::SpecializedParameters( ) const
+	{
+		return *specialized_parameters;
 	}
 
 	void UserDefinedType::writeelaboratednamerecursive( wostream& os ) const
@@ -836,7 +1033,7 @@ namespace CPlusPlusCodeProvider
 	{
 		if( templatearguments.size( ) != template_parameters -> size( ) )
 			throw invalid_argument( "Template arguments must match the number of template parameters." );
-		std::wostringstream os;
+		OutputStream os;
 		os << UserDefinedType::Name( );
 		if( templatearguments.size( ) )
 		{
@@ -851,6 +1048,7 @@ namespace CPlusPlusCodeProvider
 
 	void UserDefinedType::declaration( wostream& os , unsigned long tabs ) const
 	{
+		track( );
 		os << wstring( tabs , FormattingData::IndentationCharacter );
 		writetemplateattributes( os );
 		os << ( usertype == Class ? L" class " : L" struct " ) << Name( ) << L";\n";
@@ -901,10 +1099,9 @@ namespace CPlusPlusCodeProvider
 		}
 	}
 
-	void UserDefinedType::writemembers( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
+	void UserDefinedType::writemembers( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs , RenderContext& context ) const
 	{
-		render_backlog.clear( );
-		wostringstream public_decstream , protected_decstream , private_decstream;
+		OutputStream public_decstream , protected_decstream , private_decstream;
 		wstring deftab( deftabs , FormattingData::IndentationCharacter ) , dectab( decltabs , FormattingData::IndentationCharacter );
 		++deftabs , ++decltabs;
 		for( MemberEnumerationCollection::const_iterator iter = memberenumerations -> begin( ) ; iter != memberenumerations -> end( ) ; ++iter )
@@ -913,15 +1110,15 @@ namespace CPlusPlusCodeProvider
 				{
 				case Public:
 					iter -> first -> write( public_decstream , decltabs );
-					public_decstream << L'\n';
+					public_decstream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					iter -> first -> write( protected_decstream , decltabs );
-					protected_decstream << L'\n';
+					protected_decstream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					iter -> first -> write( private_decstream , decltabs );
-					private_decstream << L'\n';
+					private_decstream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
@@ -934,92 +1131,92 @@ namespace CPlusPlusCodeProvider
 						iter -> first -> write( public_decstream , decltabs );
 					else
 						iter -> first -> write( public_decstream , defos , decltabs , deftabs );
-					public_decstream << L'\n';
+					public_decstream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					if( iter -> first -> Inline( ) )
 						iter -> first -> write( protected_decstream , decltabs );
 					else
 						iter -> first -> write( protected_decstream , defos , decltabs , deftabs );
-					protected_decstream << L'\n';
+					protected_decstream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					if( iter -> first -> Inline( ) )
 						iter -> first -> write( private_decstream , decltabs );
 					else
 						iter -> first -> write( private_decstream, defos , decltabs , deftabs );
-					private_decstream << L'\n';
+					private_decstream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
-		for( NestedTypeCollection::const_iterator iter = memberuserdefinedtypes -> begin( ) ; iter != memberuserdefinedtypes -> end( ) ; ++iter )
+		// Nested types are all declared by writeforwarddeclarations, so only their definitions have to be ordered.
+		EmissionOrder nestedorder = nestedtypeorder( );
+		for( EmissionOrder::const_iterator entry = nestedorder.begin( ) ; entry != nestedorder.end( ) ; ++entry )
 		{
+			if( entry -> Forward )
+				continue;
+			NestedTypeCollection::const_iterator iter = memberuserdefinedtypes -> begin( ) + entry -> Position;
 			bool flag = true;
-			for( BaseTypeCollection::const_iterator base_iter = iter -> first -> BaseTypes( ).begin( ) ; flag && base_iter != iter -> first -> BaseTypes( ).end( ) ; ++base_iter )
+			for( BaseTypeCollection::const_iterator base_iter = iter -> first -> bases -> begin( ) ; flag && base_iter != iter -> first -> bases -> end( ) ; ++base_iter )
 				if( &base_iter -> Type( ) == this )
 					flag = false;
 			if( flag )
 			{
-				++iter -> first -> nestinglevel;
+				RenderContext nested = context.Nested( );
 				switch( iter -> second )
 				{
 				case Public:
 					if( iter -> first -> Inline( ) )
 					{
-						iter -> first -> write( public_decstream , defos , decltabs , deftabs );
-						public_decstream << L'\n';
+						iter -> first -> writetype( public_decstream , defos , decltabs , deftabs , nested );
+						public_decstream.Buffer( ).Append( L'\n' );
 					}
 					else
 					{
 						iter -> first -> declaration( public_decstream , decltabs );
-						public_decstream << L'\n';
-						render_backlog.push_back( &*( iter -> first ) );
+						public_decstream.Buffer( ).Append( L'\n' );
+						context.Backlog( ).push_back( &*( iter -> first ) );
 					}
 					break;
 				case Protected:
 					if( iter -> first -> Inline( ) )
 					{
-						iter -> first -> write( protected_decstream , defos , decltabs , deftabs );
-						protected_decstream << L'\n';
+						iter -> first -> writetype( protected_decstream , defos , decltabs , deftabs , nested );
+						protected_decstream.Buffer( ).Append( L'\n' );
 					}
 					else
 					{
 						iter -> first -> declaration( protected_decstream , decltabs );
-						protected_decstream << L'\n';
-						render_backlog.push_back( &*( iter -> first ) );
+						protected_decstream.Buffer( ).Append( L'\n' );
+						context.Backlog( ).push_back( &*( iter -> first ) );
 					}
 					break;
 				case Private:
 					if( iter -> first -> Inline( ) )
 					{
-						iter -> first -> write( private_decstream , defos , decltabs , deftabs );
-						private_decstream << L'\n';
+						iter -> first -> writetype( private_decstream , defos , decltabs , deftabs , nested );
+						private_decstream.Buffer( ).Append( L'\n' );
 					}
 					else
 					{
 						iter -> first -> declaration( private_decstream , decltabs );
-						private_decstream << L'\n';
-						render_backlog.push_back( &*( iter -> first ) );
+						private_decstream.Buffer( ).Append( L'\n' );
+						context.Backlog( ).push_back( &*( iter -> first ) );
 					}
 					break;
 				}
 			}
 			else
-				render_backlog.push_back( &*( iter -> first ) );
+				context.Backlog( ).push_back( &*( iter -> first ) );
 		}
 
-		for( MemberVariableCollection::iterator iter = membervariables -> begin( ) ; iter != membervariables -> end( ) ; ++iter )
+		for( MemberVariableCollection::const_iterator iter = membervariables -> begin( ) ; iter != membervariables -> end( ) ; ++iter )
 			switch (std::get< 1 >(*iter))
 			{
 			case Public:
 				if (std::get< 0 >(*iter)->Specifier().Static())
 					if (std::get< 0 >(*iter)->Specifier().Constant() && BasicType::validate(std::get< 0 >(*iter)->Specifier().Type().Name()).size())
-					{
-					bool flag = std::get< 0 >(*iter)->Specifier().Extern();
-					std::get< 0 >(*iter)->Specifier().Extern(false);
-					std::get< 0 >(*iter)->write(public_decstream, decltabs);
-					std::get< 0 >(*iter)->Specifier().Extern(flag);
-					}
+						std::get< 0 >(*iter)->write(public_decstream, decltabs);
 					else
 						std::get< 0 >(*iter)->write(public_decstream, defos, decltabs, deftabs);
 				else
@@ -1028,12 +1225,7 @@ namespace CPlusPlusCodeProvider
 			case Protected:
 				if (std::get< 0 >(*iter)->Specifier().Static())
 					if (std::get< 0 >(*iter)->Specifier().Constant() && BasicType::validate(std::get< 0 >(*iter)->Specifier().Type().Name()).size())
-					{
-					bool flag = std::get< 0 >(*iter)->Specifier().Extern();
-					std::get< 0 >(*iter)->Specifier().Extern(false);
-					std::get< 0 >(*iter)->write(protected_decstream, decltabs);
-					std::get< 0 >(*iter)->Specifier().Extern(flag);
-					}
+						std::get< 0 >(*iter)->write(protected_decstream, decltabs);
 					else
 						std::get< 0 >(*iter)->write(protected_decstream, defos, decltabs, deftabs);
 				else
@@ -1042,12 +1234,7 @@ namespace CPlusPlusCodeProvider
 			case Private:
 				if (std::get< 0 >(*iter)->Specifier().Static())
 					if (std::get< 0 >(*iter)->Specifier().Constant() && BasicType::validate(std::get< 0 >(*iter)->Specifier().Type().Name()).size())
-					{
-					bool flag = std::get< 0 >(*iter)->Specifier().Extern();
-					std::get< 0 >(*iter)->Specifier().Extern(false);
-					std::get< 0 >(*iter)->write(private_decstream, decltabs);
-					std::get< 0 >(*iter)->Specifier().Extern(flag);
-					}
+						std::get< 0 >(*iter)->write(private_decstream, decltabs);
 					else
 						std::get< 0 >(*iter)->write(private_decstream, defos, decltabs, deftabs);
 				else
@@ -1068,7 +1255,7 @@ namespace CPlusPlusCodeProvider
 					else
 						( *iter ) -> declaration( public_decstream , decltabs );
 				}
-				public_decstream << L'\n';
+				public_decstream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
 				if( ( *iter ) -> Inline( ) && !( *iter ) -> Pure( ) )
@@ -1080,7 +1267,7 @@ namespace CPlusPlusCodeProvider
 					else
 						( *iter ) -> declaration( protected_decstream , decltabs );
 				}
-				protected_decstream << L'\n';
+				protected_decstream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
 				if( ( *iter ) -> Inline( ) && !( *iter ) -> Pure( ) )
@@ -1092,7 +1279,7 @@ namespace CPlusPlusCodeProvider
 					else
 						( *iter ) -> declaration( private_decstream , decltabs );
 				}
-				private_decstream << L'\n';
+				private_decstream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
@@ -1109,7 +1296,7 @@ namespace CPlusPlusCodeProvider
 					else
 						( *iter ) -> declaration( public_decstream , decltabs );
 				}
-				public_decstream << L'\n';
+				public_decstream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
 				if( ( *iter ) -> Inline( ) && !( *iter ) -> Pure( ) )
@@ -1121,7 +1308,7 @@ namespace CPlusPlusCodeProvider
 					else
 						( *iter ) -> declaration( protected_decstream , decltabs );
 				}
-				protected_decstream << L'\n';
+				protected_decstream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
 				if( ( *iter ) -> Inline( ) && !( *iter ) -> Pure( ) )
@@ -1133,7 +1320,7 @@ namespace CPlusPlusCodeProvider
 					else
 						( *iter ) -> declaration( private_decstream , decltabs );
 				}
-				private_decstream << L'\n';
+				private_decstream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
@@ -1145,21 +1332,21 @@ namespace CPlusPlusCodeProvider
 					( *iter ) -> write( public_decstream , decltabs );
 				else
 					( *iter ) -> write( public_decstream , defos , decltabs , deftabs );
-				public_decstream << L'\n';
+				public_decstream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
 				if( ( *iter ) -> Inline( ) )
 					( *iter ) -> write( protected_decstream , decltabs );
 				else
 					( *iter ) -> write( protected_decstream , defos , decltabs , deftabs );
-				protected_decstream << L'\n';
+				protected_decstream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
 				if( ( *iter ) -> Inline( ) )
 					( *iter ) -> write( private_decstream , decltabs );
 				else
 					( *iter ) -> write( private_decstream , defos , decltabs , deftabs );
-				private_decstream << L'\n';
+				private_decstream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
@@ -1186,20 +1373,27 @@ namespace CPlusPlusCodeProvider
 				break;
 			}
 
-		wstring public_decstr = public_decstream.str( ) , protected_decstr = protected_decstream.str( ) , private_decstr = private_decstream.str( );
-
-		if( public_decstr.size( ) )
-			declos << dectab << L"public:\n" << public_decstr;
-		if( protected_decstr.size( ) )
-			declos << dectab << L"protected:\n" << protected_decstr;
-		if( private_decstr.size( ) )
-			declos << dectab << L"private:\n" << private_decstr;
+		if( !public_decstream.Empty( ) )
+		{
+			declos << dectab << L"public:\n";
+			public_decstream.WriteTo( declos );
+		}
+		if( !protected_decstream.Empty( ) )
+		{
+			declos << dectab << L"protected:\n";
+			protected_decstream.WriteTo( declos );
+		}
+		if( !private_decstream.Empty( ) )
+		{
+			declos << dectab << L"private:\n";
+			private_decstream.WriteTo( declos );
+		}
 	}
 
-	void UserDefinedType::writemembers( wostream& os , unsigned long tabs ) const
+	void UserDefinedType::writemembers( wostream& os , unsigned long tabs , RenderContext& context ) const
 	{
-		render_backlog.clear( );
-		wostringstream public_stream , protected_stream , private_stream;
+		const RenderContext members = context.Nested( );
+		OutputStream public_stream , protected_stream , private_stream;
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		++tabs;
 
@@ -1209,15 +1403,15 @@ namespace CPlusPlusCodeProvider
 				{
 				case Public:
 					iter -> first -> write( public_stream , tabs );
-					public_stream << L'\n';
+					public_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					iter -> first -> write( protected_stream , tabs );
-					protected_stream << L'\n';
+					protected_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					iter -> first -> write( private_stream , tabs );
-					private_stream << L'\n';
+					private_stream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
@@ -1227,169 +1421,143 @@ namespace CPlusPlusCodeProvider
 				{
 				case Public:
 					iter -> first -> write( public_stream , tabs );
-					public_stream << L'\n';
+					public_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					iter -> first -> write( protected_stream , tabs );
-					protected_stream << L'\n';
+					protected_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					iter -> first -> write( private_stream , tabs );
-					private_stream << L'\n';
+					private_stream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
-		for( NestedTypeCollection::const_iterator iter = memberuserdefinedtypes -> begin( ) ; iter != memberuserdefinedtypes -> end( ) ; ++iter )
+		// Nested types are all declared by writeforwarddeclarations, so only their definitions have to be ordered.
+		EmissionOrder nestedorder = nestedtypeorder( );
+		for( EmissionOrder::const_iterator entry = nestedorder.begin( ) ; entry != nestedorder.end( ) ; ++entry )
 		{
+			if( entry -> Forward )
+				continue;
+			NestedTypeCollection::const_iterator iter = memberuserdefinedtypes -> begin( ) + entry -> Position;
 			bool flag = true;
-			for( BaseTypeCollection::const_iterator base_iter = iter -> first -> BaseTypes( ).begin( ) ; flag && base_iter != iter -> first -> BaseTypes( ).end( ) ; ++base_iter )
+			for( BaseTypeCollection::const_iterator base_iter = iter -> first -> bases -> begin( ) ; flag && base_iter != iter -> first -> bases -> end( ) ; ++base_iter )
 				if( &base_iter -> Type( ) == this )
 					flag = false;
 			if( flag )
 			{
-				++iter -> first -> nestinglevel;
+				RenderContext nested = context.Nested( );
 				switch( iter -> second )
 				{
 				case Public:
-					iter -> first -> write( public_stream , tabs );
-					public_stream << L'\n';
+					iter -> first -> writetype( public_stream , tabs , nested );
+					public_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
-					iter -> first -> write( protected_stream , tabs );
-					protected_stream << L'\n';
+					iter -> first -> writetype( protected_stream , tabs , nested );
+					protected_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
-					iter -> first -> write( private_stream , tabs );
-					private_stream << L'\n';
+					iter -> first -> writetype( private_stream , tabs , nested );
+					private_stream.Buffer( ).Append( L'\n' );
 					break;
 				}
 			}
 			else
-				render_backlog.push_back( &*( iter -> first ) );
+				context.Backlog( ).push_back( &*( iter -> first ) );
 		}
 
-		for( MemberVariableCollection::iterator iter = membervariables -> begin( ) ; iter != membervariables -> end( ) ; ++iter )
+		for( MemberVariableCollection::const_iterator iter = membervariables -> begin( ) ; iter != membervariables -> end( ) ; ++iter )
 			switch (std::get< 1 >(*iter))
 			{
 			case Public:
 				if (std::get< 0 >(*iter)->Specifier().Static())
 					if (std::get< 0 >(*iter)->Specifier().Constant() && BasicType::validate(std::get< 0 >(*iter)->Specifier().Type().Name()).size())
-					{
-					bool flag = std::get< 0 >(*iter)->Specifier().Extern();
-					std::get< 0 >(*iter)->Specifier().Extern(false);
-					std::get< 0 >(*iter)->write(public_stream, tabs);
-					std::get< 0 >(*iter)->Specifier().Extern(flag);
-					}
+						std::get< 0 >(*iter)->write(public_stream, tabs);
 					else
 					{
 						std::get< 0 >(*iter)->declaration(public_stream, tabs);
-						render_backlog.push_back(&*(std::get< 0 >(*iter)));
+						context.Backlog( ).push_back(&*(std::get< 0 >(*iter)));
 					}
 				else
 				{
 					if (std::get< 2 >(*iter))
-						public_stream << wstring(tabs, FormattingData::IndentationCharacter)  << L"mutable ";
+						public_stream.Buffer( ).Append( wstring( tabs , FormattingData::IndentationCharacter ) ).Append( L"mutable " );
 					std::get< 0 >(*iter)->declaration(public_stream, 0);
-					private_stream << std::endl;
+					private_stream.Buffer( ).Append( L'\n' );
 				}
 				break;
 			case Protected:
 				if (std::get< 0 >(*iter)->Specifier().Static())
 					if (std::get< 0 >(*iter)->Specifier().Constant() && BasicType::validate(std::get< 0 >(*iter)->Specifier().Type().Name()).size())
-					{
-					bool flag = std::get< 0 >(*iter)->Specifier().Extern();
-					std::get< 0 >(*iter)->Specifier().Extern(false);
-					std::get< 0 >(*iter)->write(protected_stream, tabs);
-					std::get< 0 >(*iter)->Specifier().Extern(flag);
-					}
+						std::get< 0 >(*iter)->write(protected_stream, tabs);
 					else
 					{
 						std::get< 0 >(*iter)->declaration(protected_stream, tabs);
-						render_backlog.push_back(&*(std::get< 0 >(*iter)));
+						context.Backlog( ).push_back(&*(std::get< 0 >(*iter)));
 					}
 				else
 				{
 					if (std::get< 2 >(*iter))
-						protected_stream << wstring(tabs, FormattingData::IndentationCharacter) << L"mutable ";
+						protected_stream.Buffer( ).Append( wstring( tabs , FormattingData::IndentationCharacter ) ).Append( L"mutable " );
 					std::get< 0 >(*iter)->declaration(protected_stream, 0);
-					private_stream << std::endl;
+					private_stream.Buffer( ).Append( L'\n' );
 				}
 				break;
 			case Private:
 				if (std::get< 0 >(*iter)->Specifier().Static())
 					if (std::get< 0 >(*iter)->Specifier().Constant() && BasicType::validate(std::get< 0 >(*iter)->Specifier().Type().Name()).size())
-					{
-					bool flag = std::get< 0 >(*iter)->Specifier().Extern();
-					std::get< 0 >(*iter)->Specifier().Extern(false);
-					std::get< 0 >(*iter)->write(private_stream, tabs);
-					std::get< 0 >(*iter)->Specifier().Extern(flag);
-					}
+						std::get< 0 >(*iter)->write(private_stream, tabs);
 					else
 					{
 						std::get< 0 >(*iter)->declaration(private_stream, tabs);
-						render_backlog.push_back(&*(std::get< 0 >(*iter)));
+						context.Backlog( ).push_back(&*(std::get< 0 >(*iter)));
 					}
 				else
 				{
 					if (std::get< 2 >(*iter))
-						private_stream << wstring(tabs, FormattingData::IndentationCharacter) << L"mutable ";
+						private_stream.Buffer( ).Append( wstring( tabs , FormattingData::IndentationCharacter ) ).Append( L"mutable " );
 					std::get< 0 >(*iter)->declaration(private_stream, 0);
-					private_stream << std::endl;
+					private_stream.Buffer( ).Append( L'\n' );
 				}
 				break;
 			}
 
-		bool flag;
 		for( MemberFunctionCollection::const_iterator iter = memberfunctions -> begin( ) ; iter != memberfunctions -> end( ) ; ++iter )
 			switch( ( *iter ) -> Access( ) )
 			{
 			case Public:
 				if( !( *iter ) -> Pure( ) )
-				{
-					flag = ( *iter ) -> separate;
-					( *iter ) -> separate = false;
-					( *iter ) -> write( public_stream , tabs );
-					( *iter ) -> separate = flag;
-				}
+					( *iter ) -> writeinclass( public_stream , tabs , members );
 				else
 				{
 					( *iter ) -> declaration( public_stream , tabs );
 					if( ( *iter ) -> ForceBody ( ) )
-						render_backlog.push_back( &**iter );
+						context.Backlog( ).push_back( &**iter );
 				}
-				public_stream << L'\n';
+				public_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
 				if( !( *iter ) -> Pure( ) )
-				{
-					flag = ( *iter ) -> separate;
-					( *iter ) -> separate = false;
-					( *iter ) -> write( protected_stream , tabs );
-					( *iter ) -> separate = flag;
-				}
+					( *iter ) -> writeinclass( protected_stream , tabs , members );
 				else
 				{
 					( *iter ) -> declaration( protected_stream , tabs );
 					if( ( *iter ) -> ForceBody ( ) )
-						render_backlog.push_back( &**iter );
+						context.Backlog( ).push_back( &**iter );
 				}
-				protected_stream << L'\n';
+				protected_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
 				if( !( *iter ) -> Pure( ) )
-				{
-					flag = ( *iter ) -> separate;
-					( *iter ) -> separate = false;
-					( *iter ) -> write( private_stream , tabs );
-					( *iter ) -> separate = flag;
-				}
+					( *iter ) -> writeinclass( private_stream , tabs , members );
 				else
 				{
 					( *iter ) -> declaration( private_stream , tabs );
 					if( ( *iter ) -> ForceBody ( ) )
-						render_backlog.push_back( &**iter );
+						context.Backlog( ).push_back( &**iter );
 				}
-				private_stream << L'\n';
+				private_stream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
@@ -1398,51 +1566,36 @@ namespace CPlusPlusCodeProvider
 			{
 			case Public:
 				if( !( *iter ) -> Pure( ) )
-				{
-					flag = ( *iter ) -> separate;
-					( *iter ) -> separate = false;
-					( *iter ) -> write( public_stream , tabs );
-					( *iter ) -> separate = flag;
-				}
+					( *iter ) -> writeinclass( public_stream , tabs , members );
 				else
 				{
 					( *iter ) -> declaration( public_stream , tabs );
 					if( ( *iter ) -> ForceBody ( ) )
-						render_backlog.push_back( &**iter );
+						context.Backlog( ).push_back( &**iter );
 				}
-				public_stream << L'\n';
+				public_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
 				if( !( *iter ) -> Pure( ) )
-				{
-					flag = ( *iter ) -> separate;
-					( *iter ) -> separate = false;
-					( *iter ) -> write( protected_stream , tabs );
-					( *iter ) -> separate = flag;
-				}
+					( *iter ) -> writeinclass( protected_stream , tabs , members );
 				else
 				{
 					( *iter ) -> declaration( protected_stream , tabs );
 					if( ( *iter ) -> ForceBody ( ) )
-						render_backlog.push_back( &**iter );
+						context.Backlog( ).push_back( &**iter );
 				}
-				protected_stream << L'\n';
+				protected_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
 				if( !( *iter ) -> Pure( ) )
-				{
-					flag = ( *iter ) -> separate;
-					( *iter ) -> separate = false;
-					( *iter ) -> write( private_stream , tabs );
-					( *iter ) -> separate = flag;
-				}
+					( *iter ) -> writeinclass( private_stream , tabs , members );
 				else
 				{
 					( *iter ) -> declaration( private_stream , tabs );
 					if( ( *iter ) -> ForceBody ( ) )
-						render_backlog.push_back( &**iter );
+						context.Backlog( ).push_back( &**iter );
 				}
-				private_stream << L'\n';
+				private_stream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
@@ -1450,25 +1603,16 @@ namespace CPlusPlusCodeProvider
 			switch( ( *iter ) -> Access( ) )
 			{
 			case Public:
-				flag = ( *iter ) -> separate;
-				( *iter ) -> separate = false;
-				( *iter ) -> write( public_stream , tabs );
-				( *iter ) -> separate = flag;
-				public_stream << L'\n';
+				( *iter ) -> writeinclass( public_stream , tabs , members );
+				public_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
-				flag = ( *iter ) -> separate;
-				( *iter ) -> separate = false;
-				( *iter ) -> write( protected_stream , tabs );
-				( *iter ) -> separate = flag;
-				protected_stream << L'\n';
+				( *iter ) -> writeinclass( protected_stream , tabs , members );
+				protected_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
-				flag = ( *iter ) -> separate;
-				( *iter ) -> separate = false;
-				( *iter ) -> write( private_stream , tabs );
-				( *iter ) -> separate = flag;
-				private_stream << L'\n';
+				( *iter ) -> writeinclass( private_stream , tabs , members );
+				private_stream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
@@ -1477,61 +1621,64 @@ namespace CPlusPlusCodeProvider
 			{
 			case Public:
 				if( !destructor -> Pure( ) )
-				{
-					flag = destructor -> separate;
-					destructor -> separate = false;
-					destructor -> write( public_stream , tabs );
-					destructor -> separate = flag;
-				}
+					destructor -> writeinclass( public_stream , tabs , members );
 				else
 				{
 					destructor -> declaration( public_stream , tabs );
-					render_backlog.push_back( destructor );
+					context.Backlog( ).push_back( destructor );
 				}
 				break;
 			case Protected:
 				if( !destructor -> Pure( ) )
-				{
-					flag = destructor -> separate;
-					destructor -> separate = false;
-					destructor -> write( protected_stream , tabs );
-					destructor -> separate = flag;
-				}
+					destructor -> writeinclass( protected_stream , tabs , members );
 				else
 				{
 					destructor -> declaration( protected_stream , tabs );
-					render_backlog.push_back( destructor );
+					context.Backlog( ).push_back( destructor );
 				}
 				break;
 			case Private:
 				if( !destructor -> Pure( ) )
-				{
-					flag = destructor -> separate;
-					destructor -> separate = false;
-					destructor -> write( private_stream , tabs );
-					destructor -> separate = flag;
-				}
+					destructor -> writeinclass( private_stream , tabs , members );
 				else
 				{
 					destructor -> declaration( private_stream , tabs );
-					render_backlog.push_back( destructor );
+					context.Backlog( ).push_back( destructor );
 				}
 				break;
 			}
 
-		wstring public_str = public_stream.str( ) , protected_str = protected_stream.str( ) , private_str = private_stream.str( );
+		if( !public_stream.Empty( ) )
+		{
+			os << tab << L"public:\n";
+			public_stream.WriteTo( os );
+		}
+		if( !protected_stream.Empty( ) )
+		{
+			os << tab << L"protected:\n";
+			protected_stream.WriteTo( os );
+		}
+		if( !private_stream.Empty( ) )
+		{
+			os << tab << L"private:\n";
+			private_stream.WriteTo( os );
+		}
+	}
 
-		if( public_str.size( ) )
-			os << tab << L"public:\n" << public_str;
-		if( protected_str.size( ) )
-			os << tab << L"protected:\n" << protected_str;
-		if( private_str.size( ) )
-			os << tab << L"private:\n" << private_str;
+	EmissionOrder UserDefinedType::nestedtypeorder( ) const
+	{
+		EmissionOrder order;
+		if( !cachedorder( order ) )
+		{
+			order = DependencyGraph::Order( *memberuserdefinedtypes );
+			cacheorder( order );
+		}
+		return order;
 	}
 
 	void UserDefinedType::writeforwarddeclarations( wostream& os , unsigned long tabs ) const
 	{
-		wostringstream public_stream , protected_stream , private_stream;
+		OutputStream public_stream , protected_stream , private_stream;
 		++tabs;
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		for( MemberEnumerationCollection::const_iterator iter = memberenumerations -> begin( ) ; iter != memberenumerations -> end( ) ; ++iter )
@@ -1539,13 +1686,13 @@ namespace CPlusPlusCodeProvider
 				switch( iter -> second )
 				{
 				case Public:
-					public_stream << tab << L"enum " << iter -> first -> Name( ) << L";\n\n";
+					public_stream.Buffer( ).Append( tab ).Append( L"enum " ).Append( iter -> first -> Name( ) ).Append( L";\n\n" );
 					break;
 				case Protected:
-					protected_stream << tab << L"enum " << iter -> first -> Name( ) << L";\n\n";
+					protected_stream.Buffer( ).Append( tab ).Append( L"enum " ).Append( iter -> first -> Name( ) ).Append( L";\n\n" );
 					break;
 				case Private:
-					private_stream << tab << L"enum " << iter -> first -> Name( ) << L";\n\n";
+					private_stream.Buffer( ).Append( tab ).Append( L"enum " ).Append( iter -> first -> Name( ) ).Append( L";\n\n" );
 					break;
 				}
 			else
@@ -1553,15 +1700,15 @@ namespace CPlusPlusCodeProvider
 				{
 				case Public:
 					iter -> first -> write( public_stream , tabs );
-					public_stream << L'\n';
+					public_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					iter -> first -> write( protected_stream , tabs );
-					protected_stream << L'\n';
+					protected_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					iter -> first -> write( private_stream , tabs );
-					private_stream << L'\n';
+					private_stream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
@@ -1570,13 +1717,13 @@ namespace CPlusPlusCodeProvider
 				switch( iter -> second )
 				{
 				case Public:
-					public_stream << tab << L"union " << iter -> first -> Name( ) << L";\n\n";
+					public_stream.Buffer( ).Append( tab ).Append( L"union " ).Append( iter -> first -> Name( ) ).Append( L";\n\n" );
 					break;
 				case Protected:
-					protected_stream << tab << L"union " << iter -> first -> Name( ) << L";\n\n";
+					protected_stream.Buffer( ).Append( tab ).Append( L"union " ).Append( iter -> first -> Name( ) ).Append( L";\n\n" );
 					break;
 				case Private:
-					private_stream << tab << L"union " << iter -> first -> Name( ) << L";\n\n";
+					private_stream.Buffer( ).Append( tab ).Append( L"union " ).Append( iter -> first -> Name( ) ).Append( L";\n\n" );
 					break;
 				}
 			else
@@ -1584,15 +1731,15 @@ namespace CPlusPlusCodeProvider
 				{
 				case Public:
 					iter -> first -> write( public_stream , tabs );
-					public_stream << L'\n';
+					public_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					iter -> first -> write( protected_stream , tabs );
-					protected_stream << L'\n';
+					protected_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					iter -> first -> write( private_stream , tabs );
-					private_stream << L'\n';
+					private_stream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
@@ -1602,15 +1749,15 @@ namespace CPlusPlusCodeProvider
 				{
 				case Public:
 					iter -> first -> declaration( public_stream , tabs );
-					public_stream << L'\n';
+					public_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Protected:
 					iter -> first -> declaration( protected_stream , tabs );
-					protected_stream << L'\n';
+					protected_stream.Buffer( ).Append( L'\n' );
 					break;
 				case Private:
 					iter -> first -> declaration( private_stream , tabs );
-					private_stream << L'\n';
+					private_stream.Buffer( ).Append( L'\n' );
 					break;
 				}
 
@@ -1619,91 +1766,116 @@ namespace CPlusPlusCodeProvider
 			{
 			case Public:
 				iter -> first -> write( public_stream , tabs );
-				public_stream << L'\n';
+				public_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Protected:
 				iter -> first -> write( protected_stream , tabs );
-				protected_stream << L'\n';
+				protected_stream.Buffer( ).Append( L'\n' );
 				break;
 			case Private:
 				iter -> first -> write( private_stream , tabs );
-				private_stream << L'\n';
+				private_stream.Buffer( ).Append( L'\n' );
 				break;
 			}
 
 		tab = wstring( --tabs , FormattingData::IndentationCharacter );
 
-		wstring public_str = public_stream.str( ) , protected_str = protected_stream.str( ) , private_str = private_stream.str( );
-
-		if( public_str.size( ) )
-			os << tab << L"public:\n" << public_str;
-		if( protected_str.size( ) )
-			os << tab << L"protected:\n" << protected_str;
-		if( private_str.size( ) )
-			os << tab << L"private:\n" << private_str;
+		if( !public_stream.Empty( ) )
+		{
+			os << tab << L"public:\n";
+			public_stream.WriteTo( os );
+		}
+		if( !protected_stream.Empty( ) )
+		{
+			os << tab << L"protected:\n";
+			protected_stream.WriteTo( os );
+		}
+		if( !private_stream.Empty( ) )
+		{
+			os << tab << L"private:\n";
+			private_stream.WriteTo( os );
+		}
 	}
 
-	void UserDefinedType::writebody( wostream& declos , wostream& defos , unsigned long decltabs, unsigned long deftabs ) const
+	void UserDefinedType::writebody( wostream& declos , wostream& defos , unsigned long decltabs, unsigned long deftabs , RenderContext& context ) const
 	{
 		wstring tab( decltabs , FormattingData::IndentationCharacter );
 		declos << L'\n' << tab << L"{\n";
 		writeforwarddeclarations( declos , decltabs );
-		writemembers( declos , defos , decltabs , deftabs );
+		writemembers( declos , defos , decltabs , deftabs , context );
 		declos << tab << L"};\n";
 	}
 
-	void UserDefinedType::writebody( wostream& os , unsigned long tabs ) const
+	void UserDefinedType::writebody( wostream& os , unsigned long tabs , RenderContext& context ) const
 	{
 		wstring tab( tabs , FormattingData::IndentationCharacter );
 		os << L'\n' << tab << L"{\n";
 		writeforwarddeclarations( os , tabs );
-		writemembers( os , tabs );
+		writemembers( os , tabs , context );
 		os << tab << L"};\n";
 	}
 
 	void UserDefinedType::writetext( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs ) const
 	{
+		RenderContext context;
+		writetype( declos , defos , decltabs , deftabs , context );
+	}
+
+	void UserDefinedType::writetext( wostream& declos , wostream& defos , wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const
+	{
+		write( declos , defos , decltabs , deftabs );
+		declaration( fwdos , decltabs );
+	}
+
+	void UserDefinedType::writetext( wostream& os , unsigned long tabs ) const
+	{
+		RenderContext context;
+		writetype( os , tabs , context );
+	}
+
+	void UserDefinedType::writetype( wostream& declos , wostream& defos , unsigned long decltabs , unsigned long deftabs , RenderContext& context ) const
+	{
+		track( );
 		declos << wstring( decltabs , FormattingData::IndentationCharacter );
 		UserDefinedType::writetemplateattributes( declos );
 		declos << ( usertype == Class ? L"class " : L"struct " );
 		UserDefinedType::writeelaboratedname( declos );
 		writespecializedparameters( declos );
 		writebasetypes( declos );
-		writebody( declos , defos , decltabs , deftabs );
+		writebody( declos , defos , decltabs , deftabs , context );
 
-		// render_backlog will contain only UDTs which derive from this type.
-		if( nestinglevel == 0 && render_backlog.size( ) != 0 )
-			for( vector< const CodeObject* >::const_iterator iter = render_backlog.begin( ) ; iter != render_backlog.end( ) ; ++iter )
+		// context's backlog will contain only UDTs which derive from this type.
+		if( context.Depth( ) == 0 )
+			for( vector< const CodeObject* >::const_iterator iter = context.Backlog( ).begin( ) ; iter != context.Backlog( ).end( ) ; ++iter )
 			{
-				const UserDefinedType* udt = dynamic_cast< const UserDefinedType* >( *iter );
-				if( udt )
+				if( ( *iter ) -> Kind( ) == NodeKind::UserDefinedType )
 				{
-					--udt -> nestinglevel;
-					udt -> UserDefinedType::write( declos , defos , decltabs , deftabs );
+					RenderContext outer;
+					static_cast< const UserDefinedType* >( *iter ) -> writetype( declos , defos , decltabs , deftabs , outer );
 				}
 			}
 	}
 
-	void UserDefinedType::writetext( wostream& os , unsigned long tabs ) const
+	void UserDefinedType::writetype( wostream& os , unsigned long tabs , RenderContext& context ) const
 	{
+		track( );
 		os << wstring( tabs , FormattingData::IndentationCharacter );
 		UserDefinedType::writetemplateattributes( os );
 		os << ( usertype == Class ? L"class " : L"struct " );
 		UserDefinedType::writeelaboratedname( os );
 		writespecializedparameters( os );
 		writebasetypes( os );
-		writebody( os , tabs );
+		writebody( os , tabs , context );
 
-		// render_backlog will contain all UDTs which derive from this type, all member functions which are abstract and have bodies,
+		// context's backlog will contain all UDTs which derive from this type, all member functions which are abstract and have bodies,
 		// all member variables which are static but not constant or of integral type and the abstract destructor if any.
-		if( nestinglevel == 0 && render_backlog.size( ) != 0 )
-			for( vector< const CodeObject* >::const_iterator iter = render_backlog.begin( ) ; iter != render_backlog.end( ) ; ++iter )
+		if( context.Depth( ) == 0 )
+			for( vector< const CodeObject* >::const_iterator iter = context.Backlog( ).begin( ) ; iter != context.Backlog( ).end( ) ; ++iter )
 			{
-				const UserDefinedType* udt = dynamic_cast< const UserDefinedType* >( *iter );
-				if( udt )
+				if( ( *iter ) -> Kind( ) == NodeKind::UserDefinedType )
 				{
-					--udt -> nestinglevel;
-					udt -> UserDefinedType::write( os , tabs );
+					RenderContext outer;
+					static_cast< const UserDefinedType* >( *iter ) -> writetype( os , tabs , outer );
 				}
 				else
 				{
@@ -1716,6 +1888,7 @@ namespace CPlusPlusCodeProvider
 	FunctionPtr::FunctionPtr( const wstring& name , const class Function& method )
 		 : Type( name ) , function( &method ) , Callable( name )
 	{
+		tag( NodeKind::FunctionPtr );
 	}
 
 	void FunctionPtr::Assign( const FunctionPtr& ref , bool )
@@ -1728,6 +1901,7 @@ namespace CPlusPlusCodeProvider
 	FunctionPtr& FunctionPtr::Assign( const CodeObject& object )
 	{
 		Assign( cast< FunctionPtr >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
@@ -1736,6 +1910,11 @@ namespace CPlusPlusCodeProvider
 		return *new FunctionPtr( *this );
 	}
 
+	void FunctionPtr::remap( const CloneScope& scope )
+	{
+		scope.Remap( function );
+	}
+
 	const Function& FunctionPtr::Function( ) const
 	{
 		return *function;
@@ -1743,17 +1922,19 @@ namespace CPlusPlusCodeProvider
 
 	void FunctionPtr::writetext( wostream& os , unsigned long tabs ) const
 	{
-		if( function -> ReturnType( ) )
-			( *function -> ReturnType( ) ) -> write( os , tabs );
+		refer( *function );
+		if( const copying_pointer< VariableDeclaration >* result = function -> ReturnType( ) )
+			( *result ) -> write( os , tabs );
 		else
 			os << wstring( tabs , FormattingData::IndentationCharacter ) << L"void";
 		os << L" ( " << Type::Name( ) << L" )( ";
-		if( function -> Parameters( ).size( ) )
+		const ParameterCollection& parameters = function -> Parameters( );
+		if( parameters.size( ) )
 		{
-			ParameterCollection::const_iterator iter = function -> Parameters( ).begin( );
+			ParameterCollection::const_iterator iter = parameters.begin( );
 			( *iter ) -> Specifier( ).write( os );
 			( *iter ) -> Declarator( ).write( os );
-			for( ++iter ; iter != function -> Parameters( ).end( ) ; ++iter )
+			for( ++iter ; iter != parameters.end( ) ; ++iter )
 			{
 				os << L" , " ;
 				( *iter ) -> Specifier( ).write( os );
@@ -1773,6 +1954,12 @@ namespace CPlusPlusCodeProvider
 		return *new MemFun( *this );
 	}
 
+	void MemFun::remap( const CloneScope& scope )
+	{
+		FunctionPtr::remap( scope );
+		scope.Remap( containingtype );
+	}
+
 	void MemFun::Assign( const MemFun& ref , bool )
 	{
 		FunctionPtr::Assign( ref , true );
@@ -1782,36 +1969,41 @@ namespace CPlusPlusCodeProvider
 	MemFun& MemFun::Assign( const CodeObject& object )
 	{
 		Assign( cast< MemFun >( object ) , true );
+		Invalidate( );
 		return *this;
 	}
 
 	MemFun::MemFun( const wstring& name , const MemberFunction& function )
 		 : FunctionPtr( name , function ) , containingtype( 0 )
 	{
+		tag( NodeKind::MemFun );
 	}
 
 	MemFun::MemFun( const wstring& name , const UserDefinedType& type , const MemberFunction& function )
 		 : FunctionPtr( name , function ) , containingtype( &type )
 	{
+		tag( NodeKind::MemFun );
 	}
 
 	void MemFun::writetext( wostream& os , unsigned long tabs ) const
 	{
+		refer( Function( ) );
 		os << wstring( tabs , FormattingData::IndentationCharacter );
-		if( Function( ).ReturnType( ) )
-			( *Function( ).ReturnType( ) ) -> write( os , tabs );
+		if( const copying_pointer< VariableDeclaration >* result = Function( ).ReturnType( ) )
+			( *result ) -> write( os , tabs );
 		else
 			os << wstring( tabs , FormattingData::IndentationCharacter ) << L"void";
 		os << L"( ";
 		const MemberFunction& mem = cast< MemberFunction >( Function( ) );
 		mem.EnclosingType( ).writeelaboratedname( os );
 		os << Type::Name( ) << L" )( ";
-		if( Function( ).Parameters( ).size( ) )
+		const ParameterCollection& parameters = Function( ).Parameters( );
+		if( parameters.size( ) )
 		{
-			ParameterCollection::const_iterator iter = Function( ).Parameters( ).begin( );
+			ParameterCollection::const_iterator iter = parameters.begin( );
 			( *iter ) -> Specifier( ).write( os );
 			( *iter ) -> Declarator( ).write( os );
-			for( ++iter ; iter != Function( ).Parameters( ).end( ) ; ++iter )
+			for( ++iter ; iter != parameters.end( ) ; ++iter )
 			{
 				os << L" , " ;
 				( *iter ) -> Specifier( ).write( os );
@@ -1829,6 +2021,7 @@ namespace CPlusPlusCodeProvider
 	PointerToMember::PointerToMember( const wstring& name , const UserDefinedType& enclosingtype , const Type& pointertype )
 		 : Type( name ) , containingtype( &enclosingtype ) , type( &pointertype )
 	{
+		tag( NodeKind::PointerToMember );
 	}
 
 	PointerToMember& PointerToMember::Assign( const CodeObject& object )
@@ -1836,6 +2029,7 @@ namespace CPlusPlusCodeProvider
 		const PointerToMember& ref = cast< PointerToMember >( object );
 		Type::Assign( ref , true );
 		type = ref.type , containingtype = ref.containingtype , initialized = ref.initialized;
+		Invalidate( );
 		return *this;
 	}
 
@@ -1844,6 +2038,19 @@ namespace CPlusPlusCodeProvider
 		return *new PointerToMember( *this );
 	}
 
+	void PointerToMember::remap( const CloneScope& scope )
+	{
+		scope.Remap( type );
+		scope.Remap( containingtype );
+	}
+
+	void PointerToMember::writestructure( wostream& os ) const
+	{
+		os << Name( ) << L' ' << containingtype -> Name( ) << L' ' << type -> Name( );
+		refer( *containingtype );
+		refer( *type );
+	}
+
 	void PointerToMember::writetext( wostream& , unsigned long ) const
 	{
 		throw FunctionNotImplementedException( "You cannot output a function pointer at this moment." );
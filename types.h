@@ -2,6 +2,7 @@
 #define TYPES_HEADER
 
 #include "cppcodeprovider.h"
+#include "rendercontext.h"
 #include <vector>
 #include <map>
 
@@ -12,6 +13,7 @@ namespace CPlusPlusCodeProvider
 	class VariableDeclaration;
 	class MemberFunction;
 	class MemberOperator;
+	class MemberIndex;
 	typedef TypedCollection< copying_pointer< MemberFunction > > MemberFunctionCollection;
 	typedef TypedCollection< copying_pointer< MemberOperator > > MemberOperatorCollection;
 	typedef TypedCollection< std::tuple< copying_pointer< VariableDeclaration > , AccessRestrictions , bool > > MemberVariableCollection;
@@ -23,6 +25,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class TypedefinedType : public Type
 	{
+		friend class Snapshot;
 		static const std::wstring& validate( const copying_pointer< Typedefinition >& , const std::wstring& );
 	public:
 		/// <summary>
@@ -111,6 +114,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class NontypeParameter : public TemplateParameter
 	{
+		friend class Snapshot;
 		/// <summary>
 		/// Validates a given name so that it represents a built-in type or a pointer or a reference to some other type.
 		/// </summary>
@@ -165,6 +169,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class TypedParameter : public TemplateParameter
 	{
+		friend class Snapshot;
 		/// <summary>
 		/// Validates a given name so that it does not represent a built-in type or a pointer or a reference to some other type.
 		/// </summary>
@@ -210,6 +215,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class TemplateTemplateParameter : public TemplateParameter
 	{
+		friend class Snapshot;
 		/// <summary>
 		/// Validates a given name so that it does not represent a built-in type or a pointer or a reference to some other type.
 		/// </summary>
@@ -269,6 +275,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class BasicType : public Type
 	{
+		friend class Snapshot;
 	public:
 		/// <summary>
 		/// Creates a new BasicType given the name of a fundamental type.
@@ -344,12 +351,16 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Union : public Type , public nestabletype
 	{
-		std::auto_ptr< MemberVariableCollection > membervariables;
-		std::auto_ptr< MemberFunctionCollection > memberfunctions;
-		std::auto_ptr< MemberOperatorCollection > memberoperators;
-		std::auto_ptr< TemplateParameterCollection > template_parameters;
+		friend class NodeChildren;
+		friend class Snapshot;
+		friend class SymbolTable;
+		friend class DependencyGraph;
+
+		LazyCollection< MemberVariableCollection > membervariables;
+		LazyCollection< MemberFunctionCollection > memberfunctions;
+		LazyCollection< MemberOperatorCollection > memberoperators;
+		LazyCollection< TemplateParameterCollection > template_parameters;
 
-		mutable std::vector< const CodeObject* > render_backlog;
 		bool is_templated , is_inline;
 		nestabletype* enclosingtype;
 	public:
@@ -381,33 +392,57 @@ namespace CPlusPlusCodeProvider
 		nestabletype* EnclosingType( ) const;
 		Union& EnclosingType( nestabletype* type );
 
+		/// <summary>
+		/// Returns a collection of member variables.
+		/// </summary>
+		/// <exception ref="std::exception">Thrown if the union is an unnamed union.</exception>
+		/// <returns>A MemberVariableCollection containing all member variables defined in this union.</returns>
+		MemberVariableCollection& MemberVariables( );
 		/// <summary>
 		/// Returns a collection of member variables.
 		/// </summary>
 		/// <exception ref="std::exception">Thrown if the union is an unnamed union.</exception>
 		/// <IsConstMember value="true"/>
 		/// <returns>A MemberVariableCollection containing all member variables defined in this union.</returns>
-		MemberVariableCollection& MemberVariables( ) const;
+		const MemberVariableCollection& MemberVariables( ) const;
 
+		/// <summary>
+		/// Returns a collection of member functions.
+		/// </summary>
+		/// <exception ref="std::exception">Thrown if the union is an unnamed union.</exception>
+		/// <returns>A MemberFunctionCollection containing all member functions defined in this union.</returns>
+		MemberFunctionCollection& MemberFunctions( );
 		/// <summary>
 		/// Returns a collection of member functions.
 		/// </summary>
 		/// <exception ref="std::exception">Thrown if the union is an unnamed union.</exception>
 		/// <IsConstMember value="true"/>
 		/// <returns>A MemberFunctionCollection containing all member functions defined in this union.</returns>
-		MemberFunctionCollection& MemberFunctions( ) const;
+		const MemberFunctionCollection& MemberFunctions( ) const;
 
+		/// <summary>
+		/// Returns a collection of member operators.
+		/// </summary>
+		/// <exception ref="std::exception">Thrown if the union is an unnamed union.</exception>
+		/// <returns>A MemberOperatorCollection containing all member operators defined in this union.</returns>
+		MemberOperatorCollection& MemberOperators( );
 		/// <summary>
 		/// Returns a collection of member operators.
 		/// </summary>
 		/// <exception ref="std::exception">Thrown if the union is an unnamed union.</exception>
 		/// <IsConstMember value="true"/>
 		/// <returns>A MemberOperatorCollection containing all member operators defined in this union.</returns>
-		MemberOperatorCollection& MemberOperators( ) const;
+		const MemberOperatorCollection& MemberOperators( ) const;
 
 		bool Inline( ) const;
 		Union& Inline( bool flag );
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type to its copy if it was cloned along with this union.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Construction a default Union object.
 		/// </summary>
@@ -435,6 +470,22 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this Union.</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
+		/// <summary>
+		/// Writes out this object split across the two streams along with its forward declaration.
+		/// </summary>
+		/// <parameter name="declas">Declaration output stream.</parameter>
+		/// <parameter name="defos">Definition output stream.</parameter>
+		/// <parameter name="fwdos">Forward declaration output stream.</parameter>
+		/// <parameter name="tabs">Indentation for this Union.</parameter>
+		/// <IsConstMember value="true"/>
+		void writetext( std::wostream& declos , std::wostream& defos , std::wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const;
+		/// <summary>
+		/// Writes out the forward declaration for this union to the given stream, preceded by its template parameters if it is a template.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation</parameter>
+		/// <IsConstMember value="true"/>
+		void declaration( std::wostream& os , unsigned long tabs ) const;
 
 		void writetemplateattributesrecursive( std::wostream& os ) const;
 		void writeelaboratednamerecursive( std::wostream& ) const;
@@ -466,8 +517,12 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class Enumeration : public Type , public nestabletype
 	{
+		friend class NodeChildren;
+		friend class Snapshot;
+
 		enumeratorlist enumerators;
 		nestabletype* enclosingtype;
+		Type* underlying;
 	public:
 		/// <summary>
 		/// Creates a new enumeration given its optional name.
@@ -505,12 +560,34 @@ namespace CPlusPlusCodeProvider
 		/// <returns>This object with contents replaced by the given one.</returns>
 		Enumeration& Assign( const CodeObject& object );
 
-		/// <IsConstMember value="true"/>
+		/// <summary>
+		/// Returns the enumerators of this enumeration for changing, remembered renderings are discarded since the caller may change them.
+		/// </summary>
+		/// <returns>Enumerators keyed by their names.</returns>
 		enumeratorlist& Enumerators( );
 
 		Enumeration& EnclosingType( nestabletype* enclosing );
 		nestabletype* EnclosingType( ) const;
+
+		/// <summary>
+		/// Returns the type underlying this enumeration.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>The underlying type, or null if none was given and the compiler picks one.</returns>
+		const Type* UnderlyingType( ) const;
+		/// <summary>
+		/// Sets the integral type underlying this enumeration, which also lets it be forward declared.
+		/// </summary>
+		/// <parameter name="type">Underlying type, it is referred to and must outlive this enumeration.</parameter>
+		/// <returns>A reference to this object.</returns>
+		Enumeration& UnderlyingType( Type& type );
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type to its copy if it was cloned along with this enumeration.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a new enumeration given its optional name.
 		/// </summary>
@@ -544,6 +621,15 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="tabs">Indentation for this Enumeration.</parameter>
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
+		/// <summary>
+		/// Writes out this object split across the two streams along with its forward declaration.
+		/// </summary>
+		/// <parameter name="declas">Declaration output stream.</parameter>
+		/// <parameter name="defos">Definition output stream.</parameter>
+		/// <parameter name="fwdos">Forward declaration output stream.</parameter>
+		/// <parameter name="tabs">Indentation for this Enumeration.</parameter>
+		/// <IsConstMember value="true"/>
+		void writetext( std::wostream& declos , std::wostream& defos , std::wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const;
 
 		void writetemplateattributesrecursive( std::wostream& os ) const;
 		void writeelaboratednamerecursive( std::wostream& os ) const;
@@ -562,6 +648,17 @@ namespace CPlusPlusCodeProvider
 		UserDefinedType *actual;
 		std::auto_ptr< StringCollection > arguments;
 		bool is_virtual;
+		RenderCache cache;
+
+		friend class UserDefinedType;
+		friend class Snapshot;
+		friend class SymbolTable;
+
+		/// <summary>
+		/// Redirects the base class to its copy if it was cloned along with the derived type.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied the derived type.</parameter>
+		void remap( const CloneScope& scope );
 	public:
 		/// <summary>
 		/// Constructs a new BaseType object from a UserDefinedType, its template arguments if any and access type for this base class.
@@ -611,24 +708,36 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class UserDefinedType : public Type , public nestabletype
 	{
-		std::auto_ptr< BaseTypeCollection > bases;
-		std::auto_ptr< TypeCollection > specialized_parameters;
-		std::auto_ptr< MemberTypedefinitionCollection > typedefinitions;
-		std::auto_ptr< NestedTypeCollection > memberuserdefinedtypes;
-		std::auto_ptr< MemberFunctionCollection > memberfunctions;
-		std::auto_ptr< MemberEnumerationCollection > memberenumerations;
-		std::auto_ptr< MemberUnionCollection > memberunions;
-		std::auto_ptr< MemberVariableCollection > membervariables;
-		std::auto_ptr< MemberOperatorCollection > memberoperators;
-		std::auto_ptr< ConstructorCollection > constructors;
+		friend class NodeChildren;
+		friend class Snapshot;
+		friend class SymbolTable;
+		friend class DependencyGraph;
+
+		LazyCollection< BaseTypeCollection > bases;
+		LazyCollection< TypeCollection > specialized_parameters;
+		LazyCollection< MemberTypedefinitionCollection > typedefinitions;
+		LazyCollection< NestedTypeCollection > memberuserdefinedtypes;
+		LazyCollection< MemberFunctionCollection > memberfunctions;
+		LazyCollection< MemberEnumerationCollection > memberenumerations;
+		LazyCollection< MemberUnionCollection > memberunions;
+		LazyCollection< MemberVariableCollection > membervariables;
+		LazyCollection< MemberOperatorCollection > memberoperators;
+		LazyCollection< ConstructorCollection > constructors;
 		Destructor* destructor;
 
-		std::auto_ptr< TemplateParameterCollection > template_parameters;
-		mutable std::vector< const CodeObject* > render_backlog;
+		LazyCollection< TemplateParameterCollection > template_parameters;
 
 		bool is_sealed , is_inline;
 		nestabletype* enclosingtype;
-		mutable int nestinglevel;
+		mutable std::auto_ptr< MemberIndex > index;
+
+		/// <summary>
+		/// Brings the given index up to date with the members of this type, building it again if a collection was replaced.
+		/// </summary>
+		/// <parameter name="members">Index to update.</parameter>
+		/// <parameter name="added">List which receives the members added to the index, if given.</parameter>
+		/// <IsConstMember value="true"/>
+		void update( MemberIndex& members , std::vector< const CodeObject* >* added = 0 ) const;
 	public:
 		/// <summary>
 		/// Represents either a class or structure in code graph.
@@ -671,12 +780,22 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A newly constructed UserDefinedType.</returns>
 		UserDefinedType& Duplicate( ) const;
 
+		/// <summary>
+		/// Releases the member index of this type, if any.
+		/// </summary>
+		~UserDefinedType( );
+
+		/// <summary>
+		/// Returns a collection of base classes for this type.
+		/// </summary>
+		/// <returns>A collection containing all base classes for this type.</returns>
+		BaseTypeCollection& BaseTypes( );
 		/// <summary>
 		/// Returns a collection of base classes for this type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all base classes for this type.</returns>
-		BaseTypeCollection& BaseTypes( ) const;
+		const BaseTypeCollection& BaseTypes( ) const;
 
 		/// <summary>
 		/// Gets a value which tells if this user defined type is a template class.
@@ -702,68 +821,134 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A value from the enumeration UserType.</returns>
 		UserType Usertype( ) const;
 
+		/// <summary>
+		/// Gets all the template parameters for this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all template parameters for this user defined type.</returns>
+		TemplateParameterCollection& TemplateParameters( );
 		/// <summary>
 		/// Gets all the template parameters for this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all template parameters for this user defined type.</returns>
-		TemplateParameterCollection& TemplateParameters( ) const;
+		const TemplateParameterCollection& TemplateParameters( ) const;
 
+		/// <summary>
+		/// Get all nested typedefinitions for this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all nested typedefinitions for this user defined type.</returns>
+		MemberTypedefinitionCollection& Typedefinitions( );
 		/// <summary>
 		/// Get all nested typedefinitions for this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all nested typedefinitions for this user defined type.</returns>
-		MemberTypedefinitionCollection& Typedefinitions( ) const;
+		const MemberTypedefinitionCollection& Typedefinitions( ) const;
 
+		/// <summary>
+		/// Get all nested types for this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all nested types for this user defined type.</returns>
+		NestedTypeCollection& MemberTypes( );
 		/// <summary>
 		/// Get all nested types for this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all nested types for this user defined type.</returns>
-		NestedTypeCollection& MemberTypes( ) const;
+		const NestedTypeCollection& MemberTypes( ) const;
 
+		/// <summary>
+		/// Get all member functions in this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all member functions in this user defined type.</returns>
+		MemberFunctionCollection& MemberFunctions( );
 		/// <summary>
 		/// Get all member functions in this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all member functions in this user defined type.</returns>
-		MemberFunctionCollection& MemberFunctions( ) const;
+		const MemberFunctionCollection& MemberFunctions( ) const;
 
+		/// <summary>
+		/// Get all nested enumerations for this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all enumerations types for this user defined type.</returns>
+		MemberEnumerationCollection& MemberEnumerations( );
 		/// <summary>
 		/// Get all nested enumerations for this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all enumerations types for this user defined type.</returns>
-		MemberEnumerationCollection& MemberEnumerations( ) const;
+		const MemberEnumerationCollection& MemberEnumerations( ) const;
 
+		/// <summary>
+		/// Get all nested unions for this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all nested unions for this user defined type.</returns>
+		MemberUnionCollection& MemberUnions( );
 		/// <summary>
 		/// Get all nested unions for this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all nested unions for this user defined type.</returns>
-		MemberUnionCollection& MemberUnions( ) const;
+		const MemberUnionCollection& MemberUnions( ) const;
 
+		/// <summary>
+		/// Get all member variables in this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all member variables in this user defined type.</returns>
+		MemberVariableCollection& MemberVariables( );
 		/// <summary>
 		/// Get all member variables in this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all member variables in this user defined type.</returns>
-		MemberVariableCollection& MemberVariables( ) const;
+		const MemberVariableCollection& MemberVariables( ) const;
 
+		/// <summary>
+		/// Get all member overloaded operators in this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all member overloaded operators in this user defined type.</returns>
+		MemberOperatorCollection& MemberOperators( );
 		/// <summary>
 		/// Get all member overloaded operators in this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all member overloaded operators in this user defined type.</returns>
-		MemberOperatorCollection& MemberOperators( ) const;
+		const MemberOperatorCollection& MemberOperators( ) const;
 
+		/// <summary>
+		/// Get all constructors in this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all constructors in this user defined type.</returns>
+		ConstructorCollection& Constructors( );
 		/// <summary>
 		/// Get all constructors in this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all constructors in this user defined type.</returns>
-		ConstructorCollection& Constructors( ) const;
+		const ConstructorCollection& Constructors( ) const;
+
+		/// <summary>
+		/// Gets a value which tells if members of this type are found through a name index.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>True if this type keeps a member index.</returns>
+		bool Indexed( ) const;
+		/// <summary>
+		/// Turns the member name index of this type on or off. The index covers typedefinitions, nested types, enumerations and unions, variables, constructors, functions and operators.
+		/// </summary>
+		/// <parameter name="flag">True to keep an index, which costs memory for every member but makes Find take constant time.</parameter>
+		/// <returns>A reference to this object so that other operations can be cascaded.</returns>
+		UserDefinedType& Indexed( bool flag );
+		/// <summary>
+		/// Finds the members of this type with the given name, overloads included. Without an index every member is scanned.
+		/// </summary>
+		/// <parameter name="name" IsConst="true">Name of the members.</parameter>
+		/// <parameter name="members">List which receives the members, in no particular order.</parameter>
+		/// <IsConstMember value="true"/>
+		/// <remarks>Find updates the index with members added since it was last called, so it must not be called on the same type from several threads at once.</remarks>
+		void Find( const std::wstring& name , std::vector< const CodeObject* >& members ) const;
 
 		/// <summary>
 		/// Gets a value which tells if this user defined type is an abstract type.
@@ -798,12 +983,17 @@ namespace CPlusPlusCodeProvider
 
 		UserDefinedType& Destructor( copying_pointer< class Destructor >& );
 		
+		/// <summary>
+		/// Gets all the types used for complete or partial specialization of this user defined type.
+		/// </summary>
+		/// <returns>A collection containing all types used for complete or partial specialization of this user defined type.</returns>
+		TypeCollection& SpecializedParameters( );
 		/// <summary>
 		/// Gets all the types used for complete or partial specialization of this user defined type.
 		/// </summary>
 		/// <IsConstMember value="true"/>
 		/// <returns>A collection containing all types used for complete or partial specialization of this user defined type.</returns>
-		TypeCollection& SpecializedParameters( ) const;
+		const TypeCollection& SpecializedParameters( ) const;
 
 		nestabletype* EnclosingType( ) const;
 		UserDefinedType& EnclosingType( nestabletype* );
@@ -822,11 +1012,15 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A string containing the declarator specifier corresponding to this user defined type with the given template arguments.</returns>
 		std::wstring instantiate( const StringCollection& ) const;
 
-		bool hasbacklog( ) const;
-
 		void writebacklog( std::wostream& os , unsigned long tabs ) const;
 		void writebacklog( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
 	protected:
+		/// <summary>
+		/// Redirects the enclosing type and base classes to their copies if they were cloned along with this type, and gives this type its own destructor.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		/// <summary>
 		/// Constructs a new user-defined type given its name and type.
 		/// </summary>
@@ -863,17 +1057,19 @@ namespace CPlusPlusCodeProvider
 		/// </summary>
 		/// <parameter name="os">Stream which receives the output.</parameter>
 		/// <parameter name="tabs">Indentation</parameter>
+		/// <parameter name="context">Context of the rendering pass whose backlog receives the members and nested types which have to be written out after the body of this type.</parameter>
 		/// <IsConstMember value="true"/>
-		void writemembers( std::wostream& os , unsigned long tabs ) const;
-		void writemembers( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
+		void writemembers( std::wostream& os , unsigned long tabs , RenderContext& context ) const;
+		void writemembers( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs , RenderContext& context ) const;
 		/// <summary>
 		/// Writes out the definition of this user defined type to the provided stream.
 		/// </summary>
 		/// <parameter name="os">Stream which receives the output.</parameter>
 		/// <parameter name="tabs">Indentation</parameter>
+		/// <parameter name="context">Context of the rendering pass whose backlog receives the members and nested types which have to be written out after the body of this type.</parameter>
 		/// <IsConstMember value="true"/>
-		void writebody( std::wostream& os , unsigned long tabs ) const;
-		void writebody( std::wostream& declos , std::wostream& defos , unsigned long decltabs, unsigned long deftabs ) const;
+		void writebody( std::wostream& os , unsigned long tabs , RenderContext& context ) const;
+		void writebody( std::wostream& declos , std::wostream& defos , unsigned long decltabs, unsigned long deftabs , RenderContext& context ) const;
 		/// <summary>
 		/// Writes out the contents to the provided stream.
 		/// </summary>
@@ -890,6 +1086,15 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		void writetext( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs ) const;
 		/// <summary>
+		/// Writes out this object split across the two streams along with its forward declaration.
+		/// </summary>
+		/// <parameter name="declas">Declaration output stream.</parameter>
+		/// <parameter name="defos">Definition output stream.</parameter>
+		/// <parameter name="fwdos">Forward declaration output stream.</parameter>
+		/// <parameter name="tabs">Indentation for this UserDefinedType.</parameter>
+		/// <IsConstMember value="true"/>
+		void writetext( std::wostream& declos , std::wostream& defos , std::wostream& fwdos , unsigned long decltabs , unsigned long deftabs ) const;
+		/// <summary>
 		/// Writes out the declaration for this user defined type to the given stream.
 		/// </summary>
 		/// <parameter name="os">Stream which receives the output.</parameter>
@@ -898,15 +1103,32 @@ namespace CPlusPlusCodeProvider
 		virtual void declaration( std::wostream& os , unsigned long tabs ) const;
 
 		void writeforwarddeclarations( std::wostream& os , unsigned long tabs ) const;
+		/// <summary>
+		/// Returns the order in which the nested types of this type are defined, which is only computed again once something written out as part of it changes.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Emissions for all the nested types of this type.</returns>
+		std::vector< Emission > nestedtypeorder( ) const;
 		void writespecializedparameters( std::wostream& os ) const;
 		void writebasetypes( std::wostream& os ) const;
 	private:
 		UserType usertype;
+
+		/// <summary>
+		/// Writes out this user defined type followed by the backlog it collects, unless it is being written inside the body of its enclosing type.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the output.</parameter>
+		/// <parameter name="tabs">Indentation</parameter>
+		/// <parameter name="context">Context of the rendering pass; its depth is non-zero if this type is being written inside the body of its enclosing type.</parameter>
+		/// <IsConstMember value="true"/>
+		void writetype( std::wostream& os , unsigned long tabs , RenderContext& context ) const;
+		void writetype( std::wostream& declos , std::wostream& defos , unsigned long decltabs , unsigned long deftabs , RenderContext& context ) const;
 	};
 
 	class Function;
 	class FunctionPtr : public Type , public Callable
 	{
+		friend class Snapshot;
 		const Function* function;
 	public:
 		static copying_pointer< FunctionPtr > Instantiate( const std::wstring& name , const Function& function )
@@ -930,6 +1152,12 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		const class Function& Function( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the function this pointer is modelled on to its copy if it was cloned along with this type.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		FunctionPtr( const std::wstring& , const class Function& );
 
 		void Assign( const FunctionPtr& , bool );
@@ -959,6 +1187,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class MemFun : public FunctionPtr
 	{
+		friend class Snapshot;
 		const UserDefinedType* containingtype;
 	public:
 		static copying_pointer< MemFun > Instantiate( const std::wstring& name , const MemberFunction& function )
@@ -987,6 +1216,12 @@ namespace CPlusPlusCodeProvider
 		/// <IsConstMember value="true"/>
 		const UserDefinedType& ContainingType( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the function and the containing type to their copies if they were cloned along with this type.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
 		MemFun( const std::wstring& , const MemberFunction& );
 		MemFun( const std::wstring& , const UserDefinedType& , const MemberFunction& );
 
@@ -1015,6 +1250,7 @@ namespace CPlusPlusCodeProvider
 	/// </summary>
 	class PointerToMember : public Type
 	{
+		friend class Snapshot;
 		const Type* type;
 		const UserDefinedType* containingtype;
 		bool initialized;
@@ -1037,6 +1273,19 @@ namespace CPlusPlusCodeProvider
 		/// <returns>A newly constructed PointerToMember.</returns>
 		PointerToMember& Duplicate( ) const;
 	protected:
+		/// <summary>
+		/// Redirects the member type and the containing type to their copies if they were cloned along with this type.
+		/// </summary>
+		/// <parameter name="scope" IsConst="true">Clone which copied this object.</parameter>
+		void remap( const CloneScope& scope );
+
+		/// <summary>
+		/// Writes out the name, the containing type and the member type of this PointerToMember, since it cannot be rendered yet.
+		/// </summary>
+		/// <parameter name="os">Stream which receives the structure.</parameter>
+		/// <IsConstMember value="true"/>
+		void writestructure( std::wostream& os ) const;
+
 		PointerToMember( const std::wstring& , const UserDefinedType& , const Type& );
 
 		/// <summary>
@@ -1,22 +1,100 @@
 #ifndef UTILITY_HEADER
 #define UTILITY_HEADER
 
+#include <atomic>
+#include <cstdint>
+#include <typeinfo>
+#include <type_traits>
 #include "exceptions.h"
+#include "clone.h"
+#include "nodekind.h"
 
 namespace CPlusPlusCodeProvider
 {
 	/// <summary>
 	/// This class is a proxy pointer that copies pointee when it is copied. In other words it provides value semantics to a pointer.
+	/// Interned pointees are shared instead of copied and are copied only when about to be modified, see NodePool.
+	/// A copying_pointer to a constant T only ever reads its pointee, so an interned pointee held by one is never copied.
 	/// </summary>
 	/// <requirements>Requires T to support a Duplicate function which returns a new copy of the object pointed to by.</requirements>
 	template< typename T > class copying_pointer
 	{
-		T* ptr;
+		std::uintptr_t value;
+
+		template< typename U > friend class copying_pointer;
+
+		/// <summary>
+		/// Set in the stored value when the pointee is interned and owned by its pool rather than by this object.
+		/// </summary>
+		static const std::uintptr_t Shared = 1;
+
+		/// <summary>
+		/// Returns the stored pointer without the sharing flag.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>The pointer to the object pointed to.</returns>
+		T* get( ) const
+		{
+			return reinterpret_cast< T* >( value & ~Shared );
+		}
+
+		/// <summary>
+		/// Returns the value to store for a pointer which can be held alongside the given one, the pointee itself if it is interned or a copy of it otherwise.
+		/// While a CloneScope is active interned pointees are copied too.
+		/// </summary>
+		/// <parameter name="p">The pointer to copy, may be null.</parameter>
+		/// <returns>The stored value for the given pointer if it is interned, or for a new copy of its pointee otherwise.</returns>
+		template< typename U > static std::uintptr_t share( const U* p )
+		{
+			typedef typename std::remove_const< U >::type Source;
+			if( !p )
+				return 0;
+			if( p -> Interned( ) && !CloneScope::Active( ) )
+				return reinterpret_cast< std::uintptr_t >( static_cast< T* >( const_cast< Source* >( p ) ) ) | Shared;
+			Source* copy = static_cast< Source* >( &p -> Duplicate( ) );
+			CloneScope::Copied( *p , *copy );
+			return reinterpret_cast< std::uintptr_t >( static_cast< T* >( copy ) );
+		}
+
+		/// <summary>
+		/// Deletes the pointee unless it is null or owned by its pool.
+		/// </summary>
+		void dispose( )
+		{
+			if( !( value & Shared ) )
+				delete get( );
+		}
+
+		/// <summary>
+		/// Replaces an interned pointee with a private copy so that it can be modified without affecting other holders.
+		/// </summary>
+		void detach( )
+		{
+			typedef typename std::remove_const< T >::type Target;
+			if( value & Shared )
+			{
+				Target* copy = static_cast< Target* >( &get( ) -> Duplicate( ) );
+				CloneScope::Copied( *get( ) , *copy );
+				value = reinterpret_cast< std::uintptr_t >( copy );
+			}
+		}
+
+		/// <summary>
+		/// Returns the stored pointer for non-constant access, an interned pointee is copied first unless T is constant and the pointee can only be read.
+		/// </summary>
+		/// <returns>The pointer to the object pointed to.</returns>
+		T* access( )
+		{
+			if( !std::is_const< T >::value )
+				detach( );
+			return get( );
+		}
 	public:
 		/// <summary>
-		/// Constructs a default copying_pointer.
+		/// Constructs a default copying_pointer which points to nothing.
 		/// </summary>
 		copying_pointer( )
+			: value( 0 )
 		{
 		}
 
@@ -25,7 +103,7 @@ namespace CPlusPlusCodeProvider
 		/// </summary>
 		/// <parameter name="p">Given pointer to wrap.</parameter>
 		explicit copying_pointer( T* p )
-			 : ptr( p )
+			 : value( reinterpret_cast< std::uintptr_t >( p ) )
 		{
 		}
 
@@ -34,7 +112,7 @@ namespace CPlusPlusCodeProvider
 		/// </summary>
 		/// <parameter name="p">Given pointer to wrap.</parameter>
 		explicit copying_pointer( T& ref )
-			: ptr( &ref )
+			: value( reinterpret_cast< std::uintptr_t >( &ref ) )
 		{
 		}
 
@@ -44,7 +122,7 @@ namespace CPlusPlusCodeProvider
 		/// <parameter name="other>Other copying_pointer to initialize with.</parameter>
 		/// <requirements>Requires U to support a Duplicate function which returns an object convertable to T.</requirements>
 		template< typename U > copying_pointer( const copying_pointer< U >& other )
-			: ptr( other.pointer( ) ? dynamic_cast< U*>( &( other -> Duplicate( ) ) ) : 0 )
+			: value( share( other.get( ) ) )
 		{
 		}
 
@@ -53,8 +131,29 @@ namespace CPlusPlusCodeProvider
 		/// </summary>
 		/// <parameter name="other" IsConst="true">Other copying_pointer to initialize with.</parameter>
 		copying_pointer( const copying_pointer& other )
-			: ptr( other.ptr ? static_cast< T* >( &( other -> Duplicate( ) ) ) : 0 )
+			: value( share( other.get( ) ) )
+		{
+		}
+
+		/// <summary>
+		/// Initializes a copying_pointer by taking over the pointee of another copying_pointer, no copy is made.
+		/// </summary>
+		/// <parameter name="other">Other copying_pointer to take the pointee from, it is left pointing to nothing.</parameter>
+		/// <requirements>Requires U* to be convertible to T* once any constness of U is dropped.</requirements>
+		template< typename U > copying_pointer( copying_pointer< U >&& other ) throw( )
+			: value( reinterpret_cast< std::uintptr_t >( static_cast< T* >( const_cast< typename std::remove_const< U >::type* >( other.get( ) ) ) ) | ( other.value & Shared ) )
 		{
+			other.value = 0;
+		}
+
+		/// <summary>
+		/// Initializes a copying_pointer by taking over the pointee of another copying_pointer, no copy is made.
+		/// </summary>
+		/// <parameter name="other">Other copying_pointer to take the pointee from, it is left pointing to nothing.</parameter>
+		copying_pointer( copying_pointer&& other ) throw( )
+			: value( other.value )
+		{
+			other.value = 0;
 		}
 
 		/// <summary>
@@ -65,45 +164,304 @@ namespace CPlusPlusCodeProvider
 		copying_pointer& operator = ( const copying_pointer& other )
 		{
 			if( this != &other )
-				*this = other.ptr;
+				*this = other.get( );
 			return *this;
 		}
 
 		/// <summary>
-		/// Assigns a naked pointer to this one.
+		/// Assigns another copying_pointer to this one by taking over its pointee, no copy is made.
+		/// </summary>
+		/// <parameter name="other">Other copying_pointer to take the pointee from, it is left pointing to nothing.</parameter>
+		/// <returns>This object.</returns>
+		copying_pointer& operator = ( copying_pointer&& other ) throw( )
+		{
+			if( this != &other )
+			{
+				dispose( );
+				value = other.value;
+				other.value = 0;
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// Assigns a naked pointer to this one, interned objects are shared and others are copied.
 		/// </summary>
 		/// <parameter name="p">A pointer to assign to this one.</paramter>
 		/// <returns>This object with internal pointer replaced with the given one.</returns>
 		copying_pointer& operator = ( T* p )
 		{
-			if( !p )
+			if( p != get( ) || !p )
+			{
+				std::uintptr_t copy = share( p );
+				dispose( );
+				value = copy;
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// Allows this object to act as the pointed one.
+		/// </summary>
+		/// <returns>A reference to the object pointed to, interned objects are copied first unless T is constant.</returns>
+		T& operator*( )
+		{
+			return *access( );
+		}
+
+		/// <summary>
+		/// Allows this object to act as the pointed one.
+		/// </summary>
+		/// <IsConstant value="true"/>
+		/// <returns>A constant reference to the object pointed to.</returns>
+		const T& operator*( ) const
+		{
+			return *get( );
+		}
+
+		/// <summary>
+		/// Allows this object to act as the pointed one.
+		/// </summary>
+		/// <returns>A pointer to the object pointed to, interned objects are copied first unless T is constant.</returns>
+		T* operator -> ( )
+		{
+			return access( );
+		}
+
+		/// <summary>
+		/// Allows this object to act as the pointed one.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>A constant pointer to the object pointed to.</returns>
+		const T* operator -> ( ) const
+		{
+			return get( );
+		}
+
+		/// <summary>
+		/// Releases the owned pointer.
+		/// </summary>
+		/// <returns>Previously owned pointer, interned objects are copied first so that the caller always owns it.</returns>
+		T* release( )
+		{
+			detach( );
+			T* temp = get( );
+			value = 0;
+			return temp;
+		}
+
+		/// <summary>
+		/// Returns the stored pointer.
+		/// </summary>
+		/// <IsConstMember value="true"/>
+		/// <returns>Returns a constant pointer to owned object.</returns>
+		const T* pointer( ) const
+		{
+			return get( );
+		}
+
+		/// <summary>
+		/// Returns the stored pointer.
+		/// </summary>
+		/// <returns>Returns the pointer to owned object, interned objects are copied first unless T is constant.</returns>
+		T* pointer( )
+		{
+			return access( );
+		}
+
+		/// <summary>
+		/// Deletes the owned pointer if it is non-null and not owned by a pool.
+		/// </summary>
+		~copying_pointer( )
+		{
+			dispose( );
+		}
+	};
+
+	/// <summary>
+	/// This class is a reference counted proxy pointer that shares the pointee when it is copied and copies it only when a shared pointee is about to be modified.
+	/// In other words it provides value semantics to a pointer without paying for a copy until one is needed.
+	/// </summary>
+	/// <requirements>Requires T to support a Duplicate function which returns a new copy of the object pointed to by.</requirements>
+	template< typename T > class shared_pointer
+	{
+		template< typename U > friend class shared_pointer;
+
+		T* ptr;
+		std::atomic< long >* count;
+
+		/// <summary>
+		/// Gives up this object's share of the pointee, deleting it if this was the last share.
+		/// </summary>
+		void drop( )
+		{
+			if( count && --*count == 0 )
 			{
 				delete ptr;
-				ptr = 0;
-				return *this;
+				delete count;
 			}
-			if( p != ptr )
+			ptr = 0;
+			count = 0;
+		}
+
+		/// <summary>
+		/// Makes sure this object is the sole owner of the pointee, copying it if it is shared.
+		/// </summary>
+		void detach( )
+		{
+			if( count && *count > 1 )
 			{
-				if( ptr )
-					delete ptr;
-				ptr = static_cast< T* >( &p -> Duplicate( ) );
+				T* temp = static_cast< T* >( &ptr -> Duplicate( ) );
+				drop( );
+				ptr = temp;
+				count = new std::atomic< long >( 1 );
+			}
+		}
+	public:
+		/// <summary>
+		/// Constructs a default shared_pointer which points to nothing.
+		/// </summary>
+		shared_pointer( )
+			: ptr( 0 ) , count( 0 )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a shared_pointer that wraps the given pointer and owns it.
+		/// </summary>
+		/// <parameter name="p">Given pointer to wrap.</parameter>
+		explicit shared_pointer( T* p )
+			: ptr( p ) , count( p ? new std::atomic< long >( 1 ) : 0 )
+		{
+		}
+
+		/// <summary>
+		/// Constructs a shared_pointer that wraps the given object and owns it.
+		/// </summary>
+		/// <parameter name="ref">Given object to wrap.</parameter>
+		explicit shared_pointer( T& ref )
+			: ptr( &ref ) , count( new std::atomic< long >( 1 ) )
+		{
+		}
+
+		/// <summary>
+		/// Initializes a shared_pointer with another shared_pointer, sharing its pointee.
+		/// While a CloneScope is active the pointee is copied instead.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other shared_pointer to initialize with.</parameter>
+		shared_pointer( const shared_pointer& other )
+			: ptr( other.ptr ) , count( other.count )
+		{
+			if( count )
+				++*count;
+			if( ptr && CloneScope::Active( ) )
+			{
+				detach( );
+				CloneScope::Copied( *other.ptr , *ptr );
+			}
+		}
+
+		/// <summary>
+		/// Initializes a shared_pointer with another shared_pointer, sharing its pointee.
+		/// While a CloneScope is active the pointee is copied instead.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other shared_pointer to initialize with.</parameter>
+		/// <requirements>Requires U* to be convertible to T*.</requirements>
+		template< typename U > shared_pointer( const shared_pointer< U >& other )
+			: ptr( other.ptr ) , count( other.count )
+		{
+			if( count )
+				++*count;
+			if( ptr && CloneScope::Active( ) )
+			{
+				detach( );
+				CloneScope::Copied( *other.ptr , *ptr );
+			}
+		}
+
+		/// <summary>
+		/// Initializes a shared_pointer by taking over the pointee of another shared_pointer.
+		/// </summary>
+		/// <parameter name="other">Other shared_pointer to take the pointee from, it is left pointing to nothing.</parameter>
+		shared_pointer( shared_pointer&& other ) throw( )
+			: ptr( other.ptr ) , count( other.count )
+		{
+			other.ptr = 0;
+			other.count = 0;
+		}
+
+		/// <summary>
+		/// Initializes a shared_pointer with a copy of the object owned by a copying_pointer.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">copying_pointer whose pointee will be copied.</parameter>
+		/// <requirements>Requires U to support a Duplicate function which returns an object convertable to T.</requirements>
+		template< typename U > shared_pointer( const copying_pointer< U >& other )
+			: ptr( other.pointer( ) ? static_cast< T* >( &( other -> Duplicate( ) ) ) : 0 ) , count( ptr ? new std::atomic< long >( 1 ) : 0 )
+		{
+			if( ptr )
+				CloneScope::Copied( *other.pointer( ) , *ptr );
+		}
+
+		/// <summary>
+		/// Initializes a shared_pointer by taking over the object owned by a copying_pointer, no copy is made.
+		/// </summary>
+		/// <parameter name="other">copying_pointer whose pointee will be taken over, it is left pointing to nothing.</parameter>
+		/// <requirements>Requires U* to be convertible to T*.</requirements>
+		template< typename U > shared_pointer( copying_pointer< U >&& other )
+			: ptr( other.release( ) ) , count( ptr ? new std::atomic< long >( 1 ) : 0 )
+		{
+		}
+
+		/// <summary>
+		/// Assigns another shared_pointer to this one, sharing its pointee.
+		/// </summary>
+		/// <parameter name="other" IsConst="true">Other shared_pointer to assign to this one.</parameter>
+		/// <returns>This object.</returns>
+		shared_pointer& operator = ( const shared_pointer& other )
+		{
+			if( count != other.count )
+			{
+				if( other.count )
+					++*other.count;
+				drop( );
+				ptr = other.ptr;
+				count = other.count;
 			}
 			return *this;
 		}
 
 		/// <summary>
-		/// Allows this object to act as the pointed one.
+		/// Assigns another shared_pointer to this one by taking over its pointee.
+		/// </summary>
+		/// <parameter name="other">Other shared_pointer to take the pointee from, it is left pointing to nothing.</parameter>
+		/// <returns>This object.</returns>
+		shared_pointer& operator = ( shared_pointer&& other ) throw( )
+		{
+			if( this != &other )
+			{
+				drop( );
+				ptr = other.ptr;
+				count = other.count;
+				other.ptr = 0;
+				other.count = 0;
+			}
+			return *this;
+		}
+
+		/// <summary>
+		/// Allows this object to act as the pointed one, copying the pointee first if it is shared.
 		/// </summary>
 		/// <returns>A reference to the object pointed to.</returns>
 		T& operator*( )
 		{
+			detach( );
 			return *ptr;
 		}
 
 		/// <summary>
 		/// Allows this object to act as the pointed one.
 		/// </summary>
-		/// <IsConstant value="true"/>
+		/// <IsConstMember value="true"/>
 		/// <returns>A constant reference to the object pointed to.</returns>
 		const T& operator*( ) const
 		{
@@ -111,11 +469,12 @@ namespace CPlusPlusCodeProvider
 		}
 
 		/// <summary>
-		/// Allows this object to act as the pointed one.
+		/// Allows this object to act as the pointed one, copying the pointee first if it is shared.
 		/// </summary>
 		/// <returns>A pointer to the object pointed to.</returns>
 		T* operator -> ( )
 		{
+			detach( );
 			return ptr;
 		}
 
@@ -130,13 +489,16 @@ namespace CPlusPlusCodeProvider
 		}
 
 		/// <summary>
-		/// Releases the owned pointer.
+		/// Releases the owned pointer, copying the pointee first if it is shared.
 		/// </summary>
-		/// <returns>Previously owned pointer.</returns>
+		/// <returns>Previously owned pointer which the caller now owns exclusively.</returns>
 		T* release( )
 		{
+			detach( );
 			T* temp = ptr;
+			delete count;
 			ptr = 0;
+			count = 0;
 			return temp;
 		}
 
@@ -151,21 +513,31 @@ namespace CPlusPlusCodeProvider
 		}
 
 		/// <summary>
-		/// Returns the stored pointer.
+		/// Returns the stored pointer, copying the pointee first if it is shared.
 		/// </summary>
 		/// <returns>Returns the pointer to owned object.</returns>
 		T* pointer( )
 		{
+			detach( );
 			return ptr;
 		}
 
 		/// <summary>
-		/// Deletes the owned pointer if it is non-null.
+		/// Tells whether this object is the only one referring to its pointee.
 		/// </summary>
-		~copying_pointer( )
+		/// <IsConstMember value="true"/>
+		/// <returns>True if no other shared_pointer shares the pointee, otherwise, false.</returns>
+		bool unique( ) const
 		{
-			if( ptr )
-				delete ptr;
+			return !count || *count == 1;
+		}
+
+		/// <summary>
+		/// Gives up this object's share of the pointee, deleting it if this was the last share.
+		/// </summary>
+		~shared_pointer( )
+		{
+			drop( );
 		}
 	};
 
@@ -193,14 +565,16 @@ namespace CPlusPlusCodeProvider
 	};
 
 	/// <summary>
-	/// Function to downcast an object.
+	/// Function to downcast an object, its kind is checked instead of going through RTTI.
 	/// </summary>
 	/// <parameter name="object" IsConst="true">The object which will be cast to another type.</parameter>
-	/// <exception ref="CodeObject::TypesNotSame">Thrown if dynamic_cast fails.</exception>
-	/// <requirements>T must be a direct or indirect base class of U.</requirements>
+	/// <exception ref="std::bad_cast">Thrown if the object is not a T.</exception>
+	/// <requirements>T must be a direct or indirect derived class of U, U must be CodeObject or derived from it.</requirements>
 	template< typename T , typename U > const T& cast( const U& object )
 	{
-		return dynamic_cast< const T& >( object );
+		if( !IsKindOf< T >( object.Kind( ) ) )
+			throw std::bad_cast( );
+		return static_cast< const T& >( object );
 	}
 
 	/// <summary>
@@ -0,0 +1,255 @@
+#include <tuple>
+#include <utility>
+#include "visitor.h"
+#include "collections.h"
+#include "compilationunit.h"
+
+namespace CPlusPlusCodeProvider
+{
+	using std::vector;
+
+	namespace
+	{
+		template< typename T > void append( const copying_pointer< T >& node , vector< const CodeObject* >& children )
+		{
+			if( node.pointer( ) )
+				children.push_back( node.pointer( ) );
+		}
+
+		template< typename T > void append( const shared_pointer< T >& node , vector< const CodeObject* >& children )
+		{
+			if( node.pointer( ) )
+				children.push_back( node.pointer( ) );
+		}
+
+		template< typename T > void append( const std::pair< T , AccessRestrictions >& member , vector< const CodeObject* >& children )
+		{
+			append( member.first , children );
+		}
+
+		template< typename T > void append( const std::tuple< T , AccessRestrictions , bool >& member , vector< const CodeObject* >& children )
+		{
+			append( std::get< 0 >( member ) , children );
+		}
+
+		template< typename C > void appendall( const C& collection , vector< const CodeObject* >& children )
+		{
+			for( typename C::const_iterator iter = collection.begin( ) ; iter != collection.end( ) ; ++iter )
+				append( *iter , children );
+		}
+
+		void appendinitializer( const Declarator& declarator , vector< const CodeObject* >& children )
+		{
+			if( declarator.HasInitializer( ) )
+				children.push_back( &declarator.Initializer( ) );
+		}
+	}
+
+	void NodeChildren::appendcallable( const Callable& callable , vector< const CodeObject* >& children )
+	{
+		if( callable.return_type.get( ) )
+			append( *callable.return_type , children );
+		appendall( *callable.argumentlist , children );
+	}
+
+	void NodeChildren::appendfunction( const Function& function , vector< const CodeObject* >& children )
+	{
+		appendall( *function.template_parameters , children );
+		appendcallable( function , children );
+		appendall( *function.statements , children );
+		appendall( *function.catchclauses , children );
+	}
+
+	void NodeChildren::appenditeration( const IterationClause& clause , vector< const CodeObject* >& children )
+	{
+		append( clause.condition , children );
+		appendall( *clause.statements , children );
+	}
+
+	void NodeChildren::Append( const CodeObject& node , vector< const CodeObject* >& children )
+	{
+		switch( node.Kind( ) )
+		{
+		case NodeKind::Namespace:
+			appendall( *static_cast< const Namespace& >( node ).codeblock , children );
+			break;
+		case NodeKind::MacroTestDirective:
+			appendall( static_cast< const MacroTestDirective& >( node ).codeblock -> Declarations( ) , children );
+			break;
+		case NodeKind::VariableDeclaration:
+			appendinitializer( static_cast< const VariableDeclaration& >( node ).declarator , children );
+			break;
+		case NodeKind::VariableDeclarationList:
+			{
+				const DeclaratorList& declarators = *static_cast< const VariableDeclarationList& >( node ).declarators;
+				for( DeclaratorList::const_iterator iter = declarators.begin( ) ; iter != declarators.end( ) ; ++iter )
+					appendinitializer( *iter , children );
+			}
+			break;
+		case NodeKind::Function:
+		case NodeKind::MemberFunction:
+		case NodeKind::Destructor:
+		case NodeKind::Operator:
+		case NodeKind::MemberOperator:
+			appendfunction( static_cast< const Function& >( node ) , children );
+			break;
+		case NodeKind::Constructor:
+			{
+				const Constructor& constructor = static_cast< const Constructor& >( node );
+				appendall( *constructor.template_parameters , children );
+				appendcallable( constructor , children );
+				appendall( *constructor.initializer_list , children );
+				appendall( *constructor.statements , children );
+				appendall( *constructor.catchclauses , children );
+			}
+			break;
+		case NodeKind::Union:
+			{
+				const Union& type = static_cast< const Union& >( node );
+				appendall( *type.template_parameters , children );
+				appendall( *type.membervariables , children );
+				appendall( *type.memberfunctions , children );
+				appendall( *type.memberoperators , children );
+			}
+			break;
+		case NodeKind::Enumeration:
+			{
+				const enumeratorlist& enumerators = static_cast< const Enumeration& >( node ).enumerators;
+				for( enumeratorlist::const_iterator iter = enumerators.begin( ) ; iter != enumerators.end( ) ; ++iter )
+					append( iter -> second , children );
+			}
+			break;
+		case NodeKind::UserDefinedType:
+			{
+				const UserDefinedType& type = static_cast< const UserDefinedType& >( node );
+				appendall( *type.template_parameters , children );
+				appendall( *type.specialized_parameters , children );
+				appendall( *type.typedefinitions , children );
+				appendall( *type.memberuserdefinedtypes , children );
+				appendall( *type.memberenumerations , children );
+				appendall( *type.memberunions , children );
+				appendall( *type.membervariables , children );
+				appendall( *type.constructors , children );
+				if( type.destructor )
+					children.push_back( type.destructor );
+				appendall( *type.memberfunctions , children );
+				appendall( *type.memberoperators , children );
+			}
+			break;
+		case NodeKind::FunctionPtr:
+		case NodeKind::MemFun:
+			appendcallable( static_cast< const FunctionPtr& >( node ) , children );
+			break;
+		case NodeKind::PrefixExpression:
+		case NodeKind::PostfixExpression:
+			append( static_cast< const UnaryExpression& >( node ).source , children );
+			break;
+		case NodeKind::ScopeResolutionExpression:
+			append( static_cast< const ScopeResolutionExpression& >( node ).right , children );
+			break;
+		case NodeKind::BinaryExpression:
+			{
+				const BinaryExpression& expression = static_cast< const BinaryExpression& >( node );
+				append( expression.left , children );
+				append( expression.right , children );
+			}
+			break;
+		case NodeKind::CallExpression:
+			{
+				const CallExpression& expression = static_cast< const CallExpression& >( node );
+				if( expression.target.get( ) )
+					append( *expression.target , children );
+				appendall( *expression.arguments , children );
+			}
+			break;
+		case NodeKind::NewExpression:
+			{
+				const NewExpression& expression = static_cast< const NewExpression& >( node );
+				appendall( *expression.arguments , children );
+				if( expression.size.get( ) )
+					append( *expression.size , children );
+			}
+			break;
+		case NodeKind::DeleteExpression:
+			append( static_cast< const DeleteExpression& >( node ).type , children );
+			break;
+		case NodeKind::ThrowExpression:
+			append( static_cast< const ThrowExpression& >( node ).tothrow , children );
+			break;
+		case NodeKind::LambdaExpression:
+			{
+				const LambdaExpression& expression = static_cast< const LambdaExpression& >( node );
+				appendall( *expression.captures , children );
+				appendcallable( expression , children );
+				appendall( *expression.statements , children );
+			}
+			break;
+		case NodeKind::UsingStatement:
+			append( static_cast< const UsingStatement& >( node ).name , children );
+			break;
+		case NodeKind::ExpressionStatement:
+			append( static_cast< const ExpressionStatement& >( node ).expression , children );
+			break;
+		case NodeKind::JumpStatement:
+			{
+				const JumpStatement& statement = static_cast< const JumpStatement& >( node );
+				if( statement.type == JumpStatement::JumpType::Return )
+					append( *statement.expr , children );
+			}
+			break;
+		case NodeKind::StatementBlock:
+			appendall( *static_cast< const StatementBlock& >( node ).statements , children );
+			break;
+		case NodeKind::CatchClause:
+			{
+				const CatchClause& clause = static_cast< const CatchClause& >( node );
+				append( clause.var , children );
+				appendall( *clause.statements , children );
+			}
+			break;
+		case NodeKind::Case:
+			{
+				const Case& clause = static_cast< const Case& >( node );
+				append( clause.label , children );
+				appendall( *clause.statements , children );
+			}
+			break;
+		case NodeKind::TryCatchClause:
+			{
+				const TryCatchClause& clause = static_cast< const TryCatchClause& >( node );
+				appendall( *clause.statements , children );
+				appendall( *clause.catchclauses , children );
+			}
+			break;
+		case NodeKind::ConditionClause:
+			{
+				const ConditionClause& clause = static_cast< const ConditionClause& >( node );
+				append( clause.condition , children );
+				appendall( *clause.statements , children );
+				children.push_back( &clause.else_block );
+			}
+			break;
+		case NodeKind::ForLoop:
+			{
+				const ForLoop& loop = static_cast< const ForLoop& >( node );
+				append( loop.init , children );
+				appenditeration( loop , children );
+				append( loop.change , children );
+			}
+			break;
+		case NodeKind::WhileLoop:
+		case NodeKind::DoWhileLoop:
+			appenditeration( static_cast< const IterationClause& >( node ) , children );
+			break;
+		case NodeKind::SwitchStatement:
+			{
+				const SwitchStatement& statement = static_cast< const SwitchStatement& >( node );
+				append( statement.condition , children );
+				appendall( *statement.cases , children );
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
\ No newline at end of file
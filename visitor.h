@@ -0,0 +1,188 @@
+#ifndef VISITOR_HEADER
+#define VISITOR_HEADER
+
+#include <algorithm>
+#include <vector>
+#include "cppcodeprovider.h"
+#include "declarations.h"
+#include "expressions.h"
+#include "functions.h"
+#include "namespace.h"
+#include "preprocessor.h"
+#include "statements.h"
+#include "typedefinition.h"
+#include "types.h"
+
+namespace CPlusPlusCodeProvider
+{
+	/// <summary>
+	/// Lists the nodes owned by a node of code-graph, which are the ones copied along with it.
+	/// Nodes which are only referred to, like the variable named by a VariableReference or the enclosing type of a member function, are not listed.
+	/// </summary>
+	class NodeChildren
+	{
+		NodeChildren( );
+
+		static void appendcallable( const Callable& callable , std::vector< const CodeObject* >& children );
+		static void appendfunction( const Function& function , std::vector< const CodeObject* >& children );
+		static void appenditeration( const IterationClause& clause , std::vector< const CodeObject* >& children );
+	public:
+		/// <summary>
+		/// Appends the nodes owned by the given node to a list, in the order they are written out.
+		/// </summary>
+		/// <parameter name="node" IsConst="true">Node whose children are listed.</parameter>
+		/// <parameter name="children">List which receives the children.</parameter>
+		static void Append( const CodeObject& node , std::vector< const CodeObject* >& children );
+	};
+
+	/// <summary>
+	/// Calls the visitor with the given node as its concrete type, which is found by switching on the node's kind instead of through RTTI or a virtual call.
+	/// </summary>
+	/// <parameter name="node" IsConst="true">Node which is visited.</parameter>
+	/// <parameter name="visitor">Function object which is called with the node.</parameter>
+	/// <returns>Whatever the visitor returned.</returns>
+	/// <requirements>V must be callable with a constant reference to every concrete node type and return bool, a templated call operator can cover the types it is not interested in.</requirements>
+	template< typename V > bool Visit( const CodeObject& node , V& visitor )
+	{
+		switch( node.Kind( ) )
+		{
+		case NodeKind::Comment:
+			return visitor( static_cast< const Comment& >( node ) );
+		case NodeKind::CodeSnippet:
+			return visitor( static_cast< const CodeSnippet& >( node ) );
+		case NodeKind::Namespace:
+			return visitor( static_cast< const Namespace& >( node ) );
+		case NodeKind::Typedefinition:
+			return visitor( static_cast< const Typedefinition& >( node ) );
+		case NodeKind::PreprocessorDirective:
+			return visitor( static_cast< const PreprocessorDirective& >( node ) );
+		case NodeKind::MacroTestDirective:
+			return visitor( static_cast< const MacroTestDirective& >( node ) );
+		case NodeKind::VariableDeclaration:
+			return visitor( static_cast< const VariableDeclaration& >( node ) );
+		case NodeKind::VariableDeclarationList:
+			return visitor( static_cast< const VariableDeclarationList& >( node ) );
+		case NodeKind::Function:
+			return visitor( static_cast< const Function& >( node ) );
+		case NodeKind::MemberFunction:
+			return visitor( static_cast< const MemberFunction& >( node ) );
+		case NodeKind::Constructor:
+			return visitor( static_cast< const Constructor& >( node ) );
+		case NodeKind::Destructor:
+			return visitor( static_cast< const Destructor& >( node ) );
+		case NodeKind::Operator:
+			return visitor( static_cast< const Operator& >( node ) );
+		case NodeKind::MemberOperator:
+			return visitor( static_cast< const MemberOperator& >( node ) );
+		case NodeKind::TypedefinedType:
+			return visitor( static_cast< const TypedefinedType& >( node ) );
+		case NodeKind::NontypeParameter:
+			return visitor( static_cast< const NontypeParameter& >( node ) );
+		case NodeKind::TypedParameter:
+			return visitor( static_cast< const TypedParameter& >( node ) );
+		case NodeKind::TemplateTemplateParameter:
+			return visitor( static_cast< const TemplateTemplateParameter& >( node ) );
+		case NodeKind::BasicType:
+			return visitor( static_cast< const BasicType& >( node ) );
+		case NodeKind::Union:
+			return visitor( static_cast< const Union& >( node ) );
+		case NodeKind::Enumeration:
+			return visitor( static_cast< const Enumeration& >( node ) );
+		case NodeKind::UserDefinedType:
+			return visitor( static_cast< const UserDefinedType& >( node ) );
+		case NodeKind::FunctionPtr:
+			return visitor( static_cast< const FunctionPtr& >( node ) );
+		case NodeKind::MemFun:
+			return visitor( static_cast< const MemFun& >( node ) );
+		case NodeKind::PointerToMember:
+			return visitor( static_cast< const PointerToMember& >( node ) );
+		case NodeKind::PrefixExpression:
+			return visitor( static_cast< const PrefixExpression& >( node ) );
+		case NodeKind::PostfixExpression:
+			return visitor( static_cast< const PostfixExpression& >( node ) );
+		case NodeKind::ScopeResolutionExpression:
+			return visitor( static_cast< const ScopeResolutionExpression& >( node ) );
+		case NodeKind::BinaryExpression:
+			return visitor( static_cast< const BinaryExpression& >( node ) );
+		case NodeKind::ArgumentReference:
+			return visitor( static_cast< const ArgumentReference& >( node ) );
+		case NodeKind::Cast:
+			return visitor( static_cast< const Cast& >( node ) );
+		case NodeKind::ConditionalExpression:
+			return visitor( static_cast< const ConditionalExpression& >( node ) );
+		case NodeKind::VariableReference:
+			return visitor( static_cast< const VariableReference& >( node ) );
+		case NodeKind::LambdaCapture:
+			return visitor( static_cast< const LambdaCapture& >( node ) );
+		case NodeKind::CallExpression:
+			return visitor( static_cast< const CallExpression& >( node ) );
+		case NodeKind::MethodReference:
+			return visitor( static_cast< const MethodReference& >( node ) );
+		case NodeKind::NewExpression:
+			return visitor( static_cast< const NewExpression& >( node ) );
+		case NodeKind::ParenthesizedExpression:
+			return visitor( static_cast< const ParenthesizedExpression& >( node ) );
+		case NodeKind::DeleteExpression:
+			return visitor( static_cast< const DeleteExpression& >( node ) );
+		case NodeKind::ThrowExpression:
+			return visitor( static_cast< const ThrowExpression& >( node ) );
+		case NodeKind::PrimitiveExpression:
+			return visitor( static_cast< const PrimitiveExpression& >( node ) );
+		case NodeKind::LambdaExpression:
+			return visitor( static_cast< const LambdaExpression& >( node ) );
+		case NodeKind::UsingStatement:
+			return visitor( static_cast< const UsingStatement& >( node ) );
+		case NodeKind::ExpressionStatement:
+			return visitor( static_cast< const ExpressionStatement& >( node ) );
+		case NodeKind::JumpStatement:
+			return visitor( static_cast< const JumpStatement& >( node ) );
+		case NodeKind::LabelStatement:
+			return visitor( static_cast< const LabelStatement& >( node ) );
+		case NodeKind::StatementBlock:
+			return visitor( static_cast< const StatementBlock& >( node ) );
+		case NodeKind::CatchClause:
+			return visitor( static_cast< const CatchClause& >( node ) );
+		case NodeKind::Case:
+			return visitor( static_cast< const Case& >( node ) );
+		case NodeKind::TryCatchClause:
+			return visitor( static_cast< const TryCatchClause& >( node ) );
+		case NodeKind::ConditionClause:
+			return visitor( static_cast< const ConditionClause& >( node ) );
+		case NodeKind::ForLoop:
+			return visitor( static_cast< const ForLoop& >( node ) );
+		case NodeKind::WhileLoop:
+			return visitor( static_cast< const WhileLoop& >( node ) );
+		case NodeKind::DoWhileLoop:
+			return visitor( static_cast< const DoWhileLoop& >( node ) );
+		case NodeKind::SwitchStatement:
+			return visitor( static_cast< const SwitchStatement& >( node ) );
+		}
+		return false;
+	}
+
+	/// <summary>
+	/// Visits the given node and then, depth first, the nodes it owns, descending below a node only if the visitor returned true for it.
+	/// An explicit stack is used, so deeply nested graphs do not exhaust the call stack.
+	/// </summary>
+	/// <parameter name="root" IsConst="true">Node at which the walk starts.</parameter>
+	/// <parameter name="visitor">Function object which is called with every node reached.</parameter>
+	/// <requirements>V must meet the requirements of Visit.</requirements>
+	template< typename V > void Walk( const CodeObject& root , V& visitor )
+	{
+		std::vector< const CodeObject* > pending( 1 , &root );
+		while( !pending.empty( ) )
+		{
+			const CodeObject& node = *pending.back( );
+			pending.pop_back( );
+			if( Visit( node , visitor ) )
+			{
+				std::vector< const CodeObject* >::size_type first = pending.size( );
+				NodeChildren::Append( node , pending );
+				// Children were appended in order, reversing them takes the first one off the stack first.
+				std::reverse( pending.begin( ) + first , pending.end( ) );
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file